@@ -33,9 +33,12 @@ uint16_t   LOGTYPE = SYS_LOG_TYPE_CONSOLE;
 uint16_t   LOGTYPE = LOG_TYPE;
 #endif
 
-int main()
+/* scapi_client [count]: with a count, sends count requests on one channel */
+int main(int argc, char **argv)
 {
 	x_ipc_msg_t xmsg;
+	void *pvchannel;
+	int i, count = (argc > 1) ? atoi(argv[1]) : 0;
 	if (sprintf_s(xmsg.xhdr.aucfrom, MAX_MODID_LEN, "client") <= 0)
 		return 0;
 	if (sprintf_s(xmsg.xhdr.aucto, MAX_MODID_LEN, "server") <= 0) 
@@ -44,6 +47,21 @@ int main()
 	if (sprintf_s(xmsg.acmsg,IPC_MAX_MSG_SIZE, "request") <= 0)
 		return 0;
 	printf("This is client\n");
+	if (count > 0) {
+		pvchannel = ipc_channel_open("server");
+		for (i = 0; i < count; i++) {
+			xmsg.xhdr.unmsgsize = strnlen_s("request", 32);
+			if (sprintf_s(xmsg.acmsg, IPC_MAX_MSG_SIZE, "request") <= 0)
+				break;
+			if (ipc_channel_request(pvchannel, &xmsg) != IPC_SUCCESS) {
+				printf("Request %d failed\n", i);
+				break;
+			}
+			printf("Reply %u [%s]\n", xmsg.xhdr.uireserved & IPC_CHANNEL_ID_MASK, xmsg.acmsg);
+		}
+		ipc_channel_close(pvchannel);
+		return 0;
+	}
 	ipc_send_request(&xmsg);
 	printf("From[%s]To[%s]Len[%d]Msg[%s]\n",xmsg.xhdr.aucfrom,xmsg.xhdr.aucto,xmsg.xhdr.unmsgsize,xmsg.acmsg);
 }
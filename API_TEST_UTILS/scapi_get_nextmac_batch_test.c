@@ -0,0 +1,49 @@
+/*******************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include <ltq_api_include.h>
+
+/* usage: scapi_get_nextmac_batch_test <global|private> <ifname> [<ifname> ...] */
+int main(int argc, char **argv)
+{
+	char **ppcMacs = NULL;
+	int i = 0, nCount = argc - 2, nRet = 0;
+
+	if (argc < 3) {
+		printf("usage: %s <global|private> <ifname> [<ifname> ...]\n", argv[0]);
+		return 1;
+	}
+	ppcMacs = calloc(nCount, sizeof(char *));
+	if (ppcMacs == NULL)
+		return 1;
+	for (i = 0; i < nCount; i++) {
+		ppcMacs[i] = calloc(1, SCAPI_MAC_LEN);
+		if (ppcMacs[i] == NULL)
+			return 1;
+	}
+
+	nRet = scapi_getNextMacaddrBatch(&argv[2], nCount, strcmp(argv[1], "global") == 0, ppcMacs);
+	if (nRet == 0) {
+		for (i = 0; i < nCount; i++)
+			printf("Success. %s Next Mac = %s\n", argv[i + 2], ppcMacs[i]);
+	} else {
+		printf("Failure. ERROR = %d\n", nRet);
+	}
+
+	for (i = 0; i < nCount; i++)
+		free(ppcMacs[i]);
+	free(ppcMacs);
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include <ltq_api_include.h>
+
+/* usage: scapi_ifc_batch_test <ifname> <ip> <netmask> <mac> <txqueuelen> <0|1> [<ifname> ...] */
+int main(int argc, char **argv)
+{
+	IfcBatch_t *pxBatch = NULL;
+	int anOps[4], i = 0, j = 0, nRet = 0;
+
+	if (argc < 7 || (argc - 1) % 6 != 0) {
+		printf("usage: %s <ifname> <ip> <netmask> <mac> <txqueuelen> <0|1> [...]\n", argv[0]);
+		return 1;
+	}
+	nRet = scapi_ifcBatchBegin(&pxBatch);
+	printf("begin = %d\n", nRet);
+	if (nRet < 0)
+		return 1;
+
+	for (i = 1; i < argc; i += 6) {
+		anOps[0] = scapi_ifcBatchSetMacaddr(pxBatch, argv[i], argv[i + 3]);
+		anOps[1] = scapi_ifcBatchSetIpaddr(pxBatch, argv[i], argv[i + 1], argv[i + 2]);
+		anOps[2] = scapi_ifcBatchSetTxQueuelen(pxBatch, argv[i], atoi(argv[i + 4]));
+		anOps[3] = scapi_ifcBatchSetUpdown(pxBatch, argv[i], atoi(argv[i + 5]) ? true : false);
+		printf("%s: ops %d %d %d %d\n", argv[i], anOps[0], anOps[1], anOps[2], anOps[3]);
+	}
+
+	nRet = scapi_ifcBatchCommit(pxBatch);
+	printf("commit = %d\n", nRet);
+	for (j = 0; j < (argc - 1) / 6 * 4; j++)
+		printf("op %d result = %d\n", j, scapi_ifcBatchResult(pxBatch, j));
+
+	scapi_ifcBatchFree(pxBatch);
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ltq_api_include.h>
+
+#define LOOPS 100000
+
+typedef struct {
+	int nIpRet, nMaskRet, nMacRet, nUpRet, nQlenRet;
+	char sIp[INET_ADDRSTRLEN];
+	char sMask[INET_ADDRSTRLEN];
+	char sMac[SCAPI_MAC_LEN];
+	bool bUp;
+	int nQlen;
+} IfcState_t;
+
+static void read_state(char *pcIfname, IfcState_t *pxState)
+{
+	memset(pxState, 0, sizeof(*pxState));
+	pxState->nIpRet = scapi_getIfcIpaddr(pcIfname, pxState->sIp);
+	pxState->nMaskRet = scapi_getIfcNetmask(pcIfname, pxState->sMask);
+	pxState->nMacRet = scapi_getIfcMacaddr(pcIfname, pxState->sMac);
+	pxState->nUpRet = scapi_getIfcUpdown(pcIfname, &pxState->bUp);
+	pxState->nQlenRet = scapi_getIfcTxQueuelen(pcIfname, &pxState->nQlen);
+}
+
+static double bench(char *pcIfname)
+{
+	struct timespec xStart, xEnd;
+	char sIp[INET_ADDRSTRLEN];
+	int i = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &xStart);
+	for (i = 0; i < LOOPS; i++)
+		scapi_getIfcIpaddr(pcIfname, sIp);
+	clock_gettime(CLOCK_MONOTONIC, &xEnd);
+	return ((xEnd.tv_sec - xStart.tv_sec) * 1e9 + (xEnd.tv_nsec - xStart.tv_nsec)) / LOOPS;
+}
+
+int main(int argc, char **argv)
+{
+	IfcState_t xIoctl, xCache;
+	double dIoctl = 0, dCache = 0;
+
+	if (argc < 2) {
+		printf("usage: %s <ifname>\n", argv[0]);
+		return 1;
+	}
+
+	read_state(argv[1], &xIoctl);
+	dIoctl = bench(argv[1]);
+
+	printf("enable = %d\n", scapi_ifcCacheEnable());
+	printf("generation = %u\n", scapi_ifcCacheGeneration());
+	read_state(argv[1], &xCache);
+	dCache = bench(argv[1]);
+
+	printf("ip      %d %-16s | %d %s\n", xIoctl.nIpRet, xIoctl.sIp, xCache.nIpRet, xCache.sIp);
+	printf("netmask %d %-16s | %d %s\n", xIoctl.nMaskRet, xIoctl.sMask, xCache.nMaskRet, xCache.sMask);
+	printf("mac     %d %-16s | %d %s\n", xIoctl.nMacRet, xIoctl.sMac, xCache.nMacRet, xCache.sMac);
+	printf("updown  %d %-16d | %d %d\n", xIoctl.nUpRet, xIoctl.bUp, xCache.nUpRet, xCache.bUp);
+	printf("txqlen  %d %-16d | %d %d\n", xIoctl.nQlenRet, xIoctl.nQlen, xCache.nQlenRet, xCache.nQlen);
+	printf("%s\n", memcmp(&xIoctl, &xCache, sizeof(xIoctl)) == 0 ? "MATCH" : "MISMATCH");
+	printf("scapi_getIfcIpaddr: ioctl %.0f ns, cache %.0f ns\n", dIoctl, dCache);
+
+	/* Setters make the getters bypass the cache until it caught up */
+	if (argc > 2) {
+		printf("set txqlen = %d\n", scapi_setIfcTxQueuelen(argv[1], atoi(argv[2])));
+		read_state(argv[1], &xCache);
+		printf("txqlen after set = %d, generation = %u\n", xCache.nQlen, scapi_ifcCacheGeneration());
+	}
+	scapi_ifcCacheDisable();
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*******************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include <ltq_api_include.h>
+
+int main(void)
+{
+	IfcSnapshot_t *pxSnap = NULL;
+	int nCount = 0, i = 0;
+	uint32_t j = 0;
+
+	int nRet = scapi_getIfcSnapshot(&pxSnap, &nCount);
+	printf("nRet = %d, interfaces = %d\n", nRet, nCount);
+
+	for (i = 0; i < nCount; i++) {
+		printf("%-16s index %-4d flags 0x%-6x mtu %-5u txqlen %-5u mac %s\n",
+			pxSnap[i].sIfname, pxSnap[i].nIfindex, pxSnap[i].unFlags,
+			pxSnap[i].unMtu, pxSnap[i].unTxQueuelen, pxSnap[i].sMac);
+		for (j = 0; j < pxSnap[i].unAddrCount; j++)
+			printf("\t%s/%u scope %u flags 0x%x\n", pxSnap[i].pxAddrs[j].sAddr,
+				pxSnap[i].pxAddrs[j].ucPrefixLen, pxSnap[i].pxAddrs[j].ucScope,
+				pxSnap[i].pxAddrs[j].unFlags);
+	}
+	free(pxSnap);
+	return 0;
+}
@@ -0,0 +1,110 @@
+/*******************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+*******************************************************************************/
+
+/* Measures per call latency of the interface getter APIs on every interface of
+ * the system, against the old open/ioctl/close per call pattern.
+ * To get a few hundred interfaces on a test box:
+ *	for i in $(seq 1 300); do ip link add dummy$i type dummy; done
+ * Usage: scapi_ifconfig_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <time.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+#include <ltq_api_include.h>
+
+static long long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* what every getter did before the control socket was cached */
+static int legacy_get_flags(const char *ifname, bool *status)
+{
+	struct ifreq ifr;
+	int fd, ret = -1;
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return -1;
+	fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+	memset(&ifr, 0, sizeof(ifr));
+	snprintf(ifr.ifr_name, IFNAMSIZ, "%s", ifname);
+	if (ioctl(fd, SIOCGIFFLAGS, &ifr) == 0) {
+		*status = (ifr.ifr_flags & IFF_UP) != 0;
+		ret = 0;
+	}
+	close(fd);
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	struct if_nameindex *ifs, *it;
+	int iterations = (argc > 1) ? atoi(argv[1]) : 100;
+	int nifs = 0, i, errors = 0;
+	long long start, legacy_ns, cached_ns;
+	bool status;
+	char mac[SCAPI_MAC_LEN];
+	int qlen;
+
+	ifs = if_nameindex();
+	if (ifs == NULL) {
+		perror("if_nameindex");
+		return 1;
+	}
+	for (it = ifs; it->if_index != 0; it++)
+		nifs++;
+	if (nifs == 0 || iterations <= 0) {
+		printf("nothing to measure\n");
+		if_freenameindex(ifs);
+		return 1;
+	}
+
+	start = now_ns();
+	for (i = 0; i < iterations; i++)
+		for (it = ifs; it->if_index != 0; it++)
+			errors += (legacy_get_flags(it->if_name, &status) != 0);
+	legacy_ns = now_ns() - start;
+
+	start = now_ns();
+	for (i = 0; i < iterations; i++)
+		for (it = ifs; it->if_index != 0; it++)
+			errors += (scapi_getIfcUpdown(it->if_name, &status) != EXIT_SUCCESS);
+	cached_ns = now_ns() - start;
+
+	printf("interfaces %d, iterations %d, errors %d\n", nifs, iterations, errors);
+	printf("flags  open/ioctl/close : %8lld ns/call\n", legacy_ns / ((long long)nifs * iterations));
+	printf("flags  cached socket    : %8lld ns/call\n", cached_ns / ((long long)nifs * iterations));
+
+	/* full poll of one interface the way TR-181 handlers do it */
+	start = now_ns();
+	for (i = 0; i < iterations; i++)
+		for (it = ifs; it->if_index != 0; it++) {
+			scapi_getIfcUpdown(it->if_name, &status);
+			scapi_getIfcMacaddr(it->if_name, mac);
+			scapi_getIfcTxQueuelen(it->if_name, &qlen);
+		}
+	cached_ns = now_ns() - start;
+	printf("poll   flags+mac+txqlen : %8lld ns/interface\n", cached_ns / ((long long)nifs * iterations));
+
+	if_freenameindex(ifs);
+	return 0;
+}
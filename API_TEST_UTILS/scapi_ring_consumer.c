@@ -0,0 +1,106 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ring_consumer.c                                *
+ *         Description  :  Receiving end of the UGW IPC ring test, run          *
+ *                         scapi_ring_producer against it                       *
+ *  *****************************************************************************/
+
+/* scapi_ring_consumer [count]: creates the smallest ring at
+ * RING_TEST_PATH and receives count messages (default 100000) from
+ * scapi_ring_producer, checking their order and contents. The ring holds a
+ * few messages only, so records keep wrapping around its end, and the
+ * producer pauses between bursts, so the consumer keeps sleeping on an
+ * empty ring until the futex wakes it. Exits non zero on a bad message or
+ * when either path was not taken. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <scapi_ipc_ring.h>
+
+#include "ulogging.h"
+#ifndef LOG_LEVEL
+uint16_t   LOGLEVEL = SYS_LOG_INFO + 1;
+#else
+uint16_t   LOGLEVEL = LOG_LEVEL + 1;
+#endif
+
+#ifndef LOG_TYPE
+uint16_t   LOGTYPE = SYS_LOG_TYPE_CONSOLE;
+#else
+uint16_t   LOGTYPE = LOG_TYPE;
+#endif
+
+/* Same path in scapi_ring_producer */
+#define RING_TEST_PATH "/tmp/ScapiTestRing"
+
+/* Bytes a message takes in the ring, records are 8 byte aligned */
+#define RING_REC_LEN(size) ((UGW_IPC_HDR_SIZE + (size) + 7) & ~7UL)
+
+int main(int argc, char **argv)
+{
+	x_UGW_IPC_Ring xring;
+	char8 acmsg[UGW_IPC_MAX_MSG_SIZE + 1];
+	uchar8 ucfrom, ucto;
+	uint16 unsize;
+	uint32 uiseq, i, j, count = (argc > 1) ? (uint32)atoi(argv[1]) : 100000;
+	unsigned long long ullbytes = 0;
+	uint32 uiwaits = 0, uibad = 0;
+	char8 cerr = 0;
+
+	printf("This is ring consumer\n");
+	if (UGW_IPC_RingCreate(&xring, RING_TEST_PATH, 0) != UGW_IPC_SUCCESS) {
+		printf("Ring create failed\n");
+		return -1;
+	}
+	printf("Ring of %u bytes at %s\n", xring.uiMask + 1, RING_TEST_PATH);
+
+	for (i = 0; i < count; i++) {
+		/* Look first, a message not there yet means sleeping on the futex */
+		if (UGW_IPC_RingRecvMsg(&xring, 0, &ucfrom, &ucto, &unsize, &uiseq,
+					acmsg, &cerr) != UGW_IPC_SUCCESS) {
+			if (cerr != UGW_IPC_RING_TIMEOUT) {
+				printf("Receive failed %d\n", cerr);
+				break;
+			}
+			uiwaits++;
+			if (UGW_IPC_RingRecvMsg(&xring, -1, &ucfrom, &ucto, &unsize, &uiseq,
+						acmsg, &cerr) != UGW_IPC_SUCCESS) {
+				printf("Receive failed %d\n", cerr);
+				break;
+			}
+		}
+		ullbytes += RING_REC_LEN(unsize);
+		if (uiseq != i || unsize == 0) {
+			printf("Message %u: got seq %u size %u\n", i, uiseq, unsize);
+			uibad++;
+			continue;
+		}
+		/* Payload byte j is (seq + j) & 0xff, see scapi_ring_producer */
+		for (j = 0; j < unsize; j++) {
+			if ((uchar8)acmsg[j] != (uchar8)(uiseq + j)) {
+				printf("Message %u: byte %u is %u\n", i, j, (uchar8)acmsg[j]);
+				uibad++;
+				break;
+			}
+		}
+	}
+
+	printf("Received %u of %u, bad %u, wrapped %llu times, slept %u times\n",
+	       i, count, uibad, ullbytes / (xring.uiMask + 1), uiwaits);
+	UGW_IPC_RingClose(&xring);
+	unlink(RING_TEST_PATH);
+	if (i != count || uibad != 0 || ullbytes <= xring.uiMask + 1 || uiwaits == 0)
+		return -1;
+	return 0;
+}
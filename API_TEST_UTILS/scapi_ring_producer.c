@@ -0,0 +1,86 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ring_producer.c                                *
+ *         Description  :  Sending end of the UGW IPC ring test, see            *
+ *                         scapi_ring_consumer                                  *
+ *  *****************************************************************************/
+
+/* scapi_ring_producer [count] [burst]: sends count messages (default
+ * 100000) on the ring scapi_ring_consumer created, of sizes 1 to 1500 so
+ * that records and payloads get split at the end of the ring. After each
+ * burst messages (default 64) it pauses 10 ms, long enough for the
+ * consumer to sleep, the next message then has to wake it. A full ring is
+ * retried. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <scapi_ipc_ring.h>
+
+#include "ulogging.h"
+#ifndef LOG_LEVEL
+uint16_t   LOGLEVEL = SYS_LOG_INFO + 1;
+#else
+uint16_t   LOGLEVEL = LOG_LEVEL + 1;
+#endif
+
+#ifndef LOG_TYPE
+uint16_t   LOGTYPE = SYS_LOG_TYPE_CONSOLE;
+#else
+uint16_t   LOGTYPE = LOG_TYPE;
+#endif
+
+/* Same path in scapi_ring_consumer */
+#define RING_TEST_PATH "/tmp/ScapiTestRing"
+
+int main(int argc, char **argv)
+{
+	x_UGW_IPC_Ring xring;
+	char8 acmsg[UGW_IPC_MAX_MSG_SIZE];
+	uint16 unsize;
+	uint32 i, j, uifull = 0;
+	uint32 count = (argc > 1) ? (uint32)atoi(argv[1]) : 100000;
+	uint32 burst = (argc > 2) ? (uint32)atoi(argv[2]) : 64;
+	char8 cerr = 0;
+
+	printf("This is ring producer\n");
+	/* The consumer creates the ring, it may not be up yet */
+	for (i = 0; UGW_IPC_RingOpen(&xring, RING_TEST_PATH) != UGW_IPC_SUCCESS; i++) {
+		if (i == 50) {
+			printf("Ring open failed\n");
+			return -1;
+		}
+		usleep(100000);
+	}
+
+	for (i = 0; i < count; i++) {
+		unsize = 1 + (i * 37) % 1500;
+		for (j = 0; j < unsize; j++)
+			acmsg[j] = (char8)(i + j);
+		while (UGW_IPC_RingSendMsg(&xring, 1, 2, unsize, i, acmsg, &cerr) != UGW_IPC_SUCCESS) {
+			if (cerr != UGW_IPC_RING_FULL) {
+				printf("Send %u failed %d\n", i, cerr);
+				UGW_IPC_RingClose(&xring);
+				return -1;
+			}
+			uifull++;
+			usleep(100);
+		}
+		if (burst > 0 && (i + 1) % burst == 0)
+			usleep(10000);
+	}
+
+	printf("Sent %u, ring full %u times\n", count, uifull);
+	UGW_IPC_RingClose(&xring);
+	return 0;
+}
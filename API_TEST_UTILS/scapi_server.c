@@ -33,12 +33,39 @@ uint16_t   LOGTYPE = SYS_LOG_TYPE_CONSOLE;
 uint16_t   LOGTYPE = LOG_TYPE;
 #endif
 
-int main()
+static int32_t handle_request(x_ipc_msg_t *pxmsg, x_ipc_blob *pxreqblob, x_ipc_blob *pxreplyblob, void *pvarg)
+{
+	(void)pxreplyblob;
+	(void)pvarg;
+	if(pxreqblob->ifd >= 0)
+		printf("Blob of %zu bytes\n", pxreqblob->isize);
+	printf("From[%s]To[%s]Len[%d]Msg[%s]\n",pxmsg->xhdr.aucfrom,pxmsg->xhdr.aucto,pxmsg->xhdr.unmsgsize,pxmsg->acmsg);
+	pxmsg->xhdr.unmsgsize=strnlen_s("response",32);
+	if(sprintf_s(pxmsg->acmsg,IPC_MAX_MSG_SIZE, "response") <= 0)
+		return IPC_FAIL;
+	return IPC_SUCCESS;
+}
+
+/* scapi_server [-e|-s]: with -e, serves all clients at once from
+ * ipc_server_dispatch; -s does the same on a SOCK_SEQPACKET listener */
+int main(int argc, char **argv)
 {
 	void *pvhandle;
 	int32_t iret;
 	x_ipc_msg_t xmsg;
 	printf("This is server\n");
+	if(argc > 1 && (strcmp(argv[1], "-e") == 0 || strcmp(argv[1], "-s") == 0)){
+		pvhandle=ipc_server_create_ex("server", (argv[1][1] == 's') ?
+				IPC_TRANSPORT_SEQPACKET : IPC_TRANSPORT_STREAM, handle_request, NULL);
+		if(pvhandle == NULL){
+			printf("Server create failed\n");
+			return -1;
+		}
+		while(ipc_server_dispatch(pvhandle, -1) >= 0)
+			;
+		ipc_server_destroy(pvhandle);
+		return -1;
+	}
 	printf("Creating Listerner\n");
 	pvhandle=ipc_create_listener("server");
 	while(1){
@@ -0,0 +1,264 @@
+/*******************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+*******************************************************************************/
+
+/* Measures the UGW_TLIB timers for each backend and notification mode:
+ *  - start and stop cost, with <timers> one time timers running
+ *  - expiry lateness of <timers> one time timers spread over one second
+ *  - interval jitter of 50 periodic 10 ms timers running meanwhile
+ * Lateness is the time from the deadline to the callback, as p50/p99/p999/max,
+ * never negative: no backend runs a timer before its deadline.
+ * The global API holds at most 65535 timers, it is capped there; the sorted
+ * list backend starts in O(n), it is capped at 20000.
+ * Usage: scapi_timer_bench [timers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+
+#include <ltq_api_include.h>
+#include <scapi_basic_types.h>
+#include <scapi_tlib_timlib.h>
+
+#define LONG_TIMER_US		60000000
+#define SPREAD_START_US		100000
+#define SPREAD_US		1000000
+#define NUM_PERIODIC		50
+#define PERIOD_US		10000
+#define MAX_PERIODIC_SAMPLES	(NUM_PERIODIC * (SPREAD_START_US + SPREAD_US) / PERIOD_US * 2)
+#define GLOBAL_MAX_TIMERS	(65535 - NUM_PERIODIC)
+#define LIST_MAX_TIMERS		20000
+
+typedef struct {
+	const char *pcName;
+	uchar8 ucBackend;
+	uchar8 ucNotify;
+	int nCtx;
+} x_BenchMode;
+
+static const x_BenchMode axModes[] = {
+	{ "list/signal",   UGW_TLIB_BACKEND_LIST,  UGW_TLIB_NOTIFY_VIA_SIGNAL,  0 },
+	{ "wheel/signal",  UGW_TLIB_BACKEND_WHEEL, UGW_TLIB_NOTIFY_VIA_SIGNAL,  0 },
+	{ "list/timerfd",  UGW_TLIB_BACKEND_LIST,  UGW_TLIB_NOTIFY_VIA_TIMERFD, 0 },
+	{ "wheel/timerfd", UGW_TLIB_BACKEND_WHEEL, UGW_TLIB_NOTIFY_VIA_TIMERFD, 0 },
+	{ "context",       UGW_TLIB_BACKEND_WHEEL, UGW_TLIB_NOTIFY_VIA_TIMERFD, 1 },
+};
+
+typedef struct {
+	long long llLastNs;
+} x_BenchPeriodic;
+
+static const x_BenchMode *pxCurMode;
+static x_UGW_TLIB_TimerCtx *pxCtx;
+static long long *pllDueNs;
+static int *pnLateUs;
+static volatile int nFired;
+static x_BenchPeriodic axPeriodics[NUM_PERIODIC];
+static int *pnJitterUs;
+static volatile int nJitterCnt;
+
+static long long benchNowNs(void)
+{
+	struct timespec xTs;
+
+	clock_gettime(CLOCK_MONOTONIC, &xTs);
+	return (long long)xTs.tv_sec * 1000000000LL + xTs.tv_nsec;
+}
+
+/* callbacks run in the SIGALRM handler in signal mode: no stdio, no malloc */
+static void benchOneShotCb(void *pvParm)
+{
+	pnLateUs[nFired++] = (int)((benchNowNs() - pllDueNs[(long)pvParm]) / 1000);
+}
+
+static void benchPeriodicCb(void *pvParm)
+{
+	x_BenchPeriodic *pxPeriodic = pvParm;
+	long long llNow = benchNowNs();
+
+	if (pxPeriodic->llLastNs != 0 && nJitterCnt < MAX_PERIODIC_SAMPLES)
+		pnJitterUs[nJitterCnt++] = abs((int)((llNow - pxPeriodic->llLastNs) / 1000) - PERIOD_US);
+	pxPeriodic->llLastNs = llNow;
+}
+
+static int benchStartTimer(uint32 *puiId, uint32 uiValue, uint8 ucType, pfnVoidFunctPtr pfnCb, void *pvParm)
+{
+	uint16 unGlobalId;
+
+	if (pxCurMode->nCtx)
+		return UGW_TLIB_CtxStartTimer(pxCtx, puiId, uiValue, ucType, pfnCb, pvParm);
+	if (UGW_TLIB_StartTimer(&unGlobalId, uiValue, ucType, pfnCb, pvParm) != UGW_TLIB_SUCCESS)
+		return UGW_TLIB_FAIL;
+	*puiId = unGlobalId;
+	return UGW_TLIB_SUCCESS;
+}
+
+static void benchStopTimer(uint32 uiId)
+{
+	if (pxCurMode->nCtx)
+		UGW_TLIB_CtxStopTimer(pxCtx, uiId);
+	else
+		UGW_TLIB_StopTimer((uint16)uiId);
+}
+
+/* waits for one expiry (or more) and runs the callbacks */
+static void benchWaitExpiry(void)
+{
+	struct pollfd xPfd = { -1, POLLIN, 0 };
+
+	if (pxCurMode->nCtx) {
+		xPfd.fd = UGW_TLIB_CtxGetFd(pxCtx);
+		if (poll(&xPfd, 1, 1000) > 0)
+			UGW_TLIB_CtxDispatch(pxCtx);
+	} else if (pxCurMode->ucNotify == UGW_TLIB_NOTIFY_VIA_TIMERFD) {
+		xPfd.fd = UGW_TLIB_GetTimerFd();
+		if (poll(&xPfd, 1, 1000) > 0)
+			UGW_TLIB_Dispatch();
+	} else {
+		/* a periodic timer is always running, pause() returns */
+		pause();
+	}
+}
+
+/* The list backend takes global_timer_mutex without blocking SIGALRM, the
+ * handler must not run while the bench thread is inside the library */
+static void benchBlockAlarm(int nBlock)
+{
+	sigset_t xSet;
+
+	if (pxCurMode->nCtx || pxCurMode->ucNotify != UGW_TLIB_NOTIFY_VIA_SIGNAL)
+		return;
+	sigemptyset(&xSet);
+	sigaddset(&xSet, SIGALRM);
+	sigprocmask(nBlock ? SIG_BLOCK : SIG_UNBLOCK, &xSet, NULL);
+}
+
+static int benchCmpInt(const void *pvA, const void *pvB)
+{
+	return (*(const int *)pvA > *(const int *)pvB) - (*(const int *)pvA < *(const int *)pvB);
+}
+
+static int benchPercentile(const int *pnVal, int nCnt, int nPerMille)
+{
+	long lIdx = (long)nCnt * nPerMille / 1000;
+
+	if (nCnt == 0)
+		return 0;
+	return pnVal[lIdx >= nCnt ? nCnt - 1 : lIdx];
+}
+
+static int benchRunMode(int nTimers)
+{
+	uint32 *puiIds, auiPeriodicIds[NUM_PERIODIC];
+	long long llStart, llStartNs, llStopNs;
+	uint32 uiFirstUs, uiValue;
+	int i, nErrors = 0;
+
+	puiIds = calloc(nTimers, sizeof(*puiIds));
+	if (puiIds == NULL)
+		return -1;
+	if (pxCurMode->nCtx) {
+		pxCtx = UGW_TLIB_CtxCreate(nTimers + NUM_PERIODIC);
+		if (pxCtx == NULL) {
+			free(puiIds);
+			return -1;
+		}
+	} else if (UGW_TLIB_TimersInitEx(nTimers + NUM_PERIODIC, pxCurMode->ucNotify, pxCurMode->ucBackend) != UGW_TLIB_SUCCESS) {
+		free(puiIds);
+		return -1;
+	}
+
+	/* cost of start and stop with all the timers running */
+	benchBlockAlarm(1);
+	llStart = benchNowNs();
+	for (i = 0; i < nTimers; i++)
+		nErrors += (benchStartTimer(&puiIds[i], LONG_TIMER_US + i, UGW_TLIB_ONE_TIME_TIMER, benchOneShotCb, NULL) != UGW_TLIB_SUCCESS);
+	llStartNs = benchNowNs() - llStart;
+	llStart = benchNowNs();
+	for (i = nTimers - 1; i >= 0; i--)
+		benchStopTimer(puiIds[i]);
+	llStopNs = benchNowNs() - llStart;
+
+	/* expiry accuracy, the first timer is due after the slowest start loop
+	 * would have finished so lateness is not start cost */
+	uiFirstUs = SPREAD_START_US + (uint32)(2 * llStartNs / 1000);
+	nFired = 0;
+	nJitterCnt = 0;
+	memset(axPeriodics, 0, sizeof(axPeriodics));
+	for (i = 0; i < NUM_PERIODIC; i++)
+		nErrors += (benchStartTimer(&auiPeriodicIds[i], PERIOD_US, UGW_TLIB_PERIODIC_TIMER, benchPeriodicCb, &axPeriodics[i]) != UGW_TLIB_SUCCESS);
+	for (i = 0; i < nTimers; i++) {
+		uiValue = uiFirstUs + (uint32)((long long)i * SPREAD_US / nTimers);
+		pllDueNs[i] = benchNowNs() + (long long)uiValue * 1000;
+		nErrors += (benchStartTimer(&puiIds[i], uiValue, UGW_TLIB_ONE_TIME_TIMER, benchOneShotCb, (void *)(long)i) != UGW_TLIB_SUCCESS);
+	}
+	benchBlockAlarm(0);
+	llStart = benchNowNs();
+	while (nFired < nTimers - nErrors && benchNowNs() - llStart < 10LL * (uiFirstUs + SPREAD_US) * 1000)
+		benchWaitExpiry();
+	benchBlockAlarm(1);
+	for (i = 0; i < NUM_PERIODIC; i++)
+		benchStopTimer(auiPeriodicIds[i]);
+
+	qsort(pnLateUs, nFired, sizeof(int), benchCmpInt);
+	qsort(pnJitterUs, nJitterCnt, sizeof(int), benchCmpInt);
+	printf("%-14s %6d %8lld %8lld %7d %7d %7d %7d %7d %7d %7d   %d\n", pxCurMode->pcName, nTimers,
+			llStartNs / nTimers, llStopNs / nTimers,
+			benchPercentile(pnLateUs, nFired, 500), benchPercentile(pnLateUs, nFired, 990),
+			benchPercentile(pnLateUs, nFired, 999), nFired ? pnLateUs[nFired - 1] : 0,
+			benchPercentile(pnJitterUs, nJitterCnt, 500), benchPercentile(pnJitterUs, nJitterCnt, 990),
+			benchPercentile(pnJitterUs, nJitterCnt, 999),
+			nErrors + (nTimers - nFired));
+
+	if (pxCurMode->nCtx) {
+		UGW_TLIB_CtxDestroy(pxCtx);
+		pxCtx = NULL;
+	} else {
+		UGW_TLIB_TimersDelete();
+	}
+	benchBlockAlarm(0);
+	free(puiIds);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int nTimers = (argc > 1) ? atoi(argv[1]) : 10000;
+	unsigned int unMode;
+	int nCnt;
+
+	if (nTimers <= 0) {
+		printf("usage: %s [timers]\n", argv[0]);
+		return 1;
+	}
+	pllDueNs = calloc(nTimers, sizeof(*pllDueNs));
+	pnLateUs = calloc(nTimers, sizeof(*pnLateUs));
+	pnJitterUs = calloc(MAX_PERIODIC_SAMPLES, sizeof(*pnJitterUs));
+	if (pllDueNs == NULL || pnLateUs == NULL || pnJitterUs == NULL)
+		return 1;
+
+	printf("%-14s %6s %8s %8s %7s %7s %7s %7s %7s %7s %7s   %s\n", "mode", "timers",
+			"start ns", "stop ns", "late50", "late99", "late999", "latemax",
+			"jit50", "jit99", "jit999", "lost");
+	for (unMode = 0; unMode < sizeof(axModes) / sizeof(axModes[0]); unMode++) {
+		pxCurMode = &axModes[unMode];
+		nCnt = nTimers;
+		if (!pxCurMode->nCtx && nCnt > GLOBAL_MAX_TIMERS)
+			nCnt = GLOBAL_MAX_TIMERS;
+		if (pxCurMode->ucBackend == UGW_TLIB_BACKEND_LIST && nCnt > LIST_MAX_TIMERS)
+			nCnt = LIST_MAX_TIMERS;
+		if (benchRunMode(nCnt) != 0)
+			printf("%-14s init failed\n", pxCurMode->pcName);
+	}
+	return 0;
+}
@@ -71,10 +71,20 @@
 #define SCAPI_BLOCK 1
 #endif
 
-#ifndef SCAPI_UNBLOCK 
+#ifndef SCAPI_UNBLOCK
 #define SCAPI_UNBLOCK 0
 #endif
 
+/*! \def SCAPI_KILL_WAIT
+    \brief scapi_killAllMulti() flag, wait for the signalled processes to exit
+*/
+#define SCAPI_KILL_WAIT 0x1
+
+/*! \def SCAPI_KILL_KEEP_PIDFILE
+    \brief scapi_killAllMulti() flag, leave /var/run/<name>.pid in place on SIGTERM/SIGKILL
+*/
+#define SCAPI_KILL_KEEP_PIDFILE 0x2
+
 
 #ifndef MAX_HOP_EXCEED 
 /*! \def MAX_HOP_EXCEED
@@ -194,6 +194,35 @@ typedef struct {
 
 } x_UGW_IPC_Msg;
 
+/*!
+    \brief Structure describing one message of a batch send.
+*/
+typedef struct {
+	x_UGW_IPC_MsgHdr xHdr;	/*!< Header as sent, xHdr.unMsgSize is the payload size */
+	char8 *pcMsg;		/*!< Payload, not copied */
+} x_UGW_IPC_MsgDesc;
+
+/*! \def UGW_IPC_BATCH_IOV
+    \brief Maximum number of iovecs in one batch write, two per message.
+*/
+#define UGW_IPC_BATCH_IOV 64
+
+/*! \def UGW_IPC_READER_BUF_SIZE
+    \brief Receive buffer of a reader, holds several messages of the largest size.
+*/
+#define UGW_IPC_READER_BUF_SIZE (4 * sizeof(x_UGW_IPC_Msg))
+
+/*!
+    \brief Structure describing a buffered FIFO reader.
+*/
+typedef struct {
+	int32 iFd;		/*!< FIFO fd */
+	uint32 uiHead;		/*!< Offset of the next message in acBuf */
+	uint32 uiTail;		/*!< End of the bytes read into acBuf */
+	x_UGW_IPC_MsgHdr xHdr;	/*!< Header of the message last returned */
+	char8 acBuf[UGW_IPC_READER_BUF_SIZE];	/*!< Bytes read from the FIFO */
+} x_UGW_IPC_Reader;
+
 /* Error Codes */
 
 /*! \enum e_UGW_IPC_Error
@@ -246,6 +275,59 @@ UGW_IPC_RecvMsg(IN int32 iFd,
 		OUT uint16 * punMsgSize,
 		OUT uint32 * puiReserved, OUT char8 * pcMsg, OUT char8 * pErr);
 
+/*!
+   \brief Function to send several IPC messages. Messages are gathered into
+   writev() calls of at most PIPE_BUF bytes, each of which is atomic; a
+   message above PIPE_BUF is written alone, not atomically.
+   \param[in] iFd FIFO fd
+   \param[in] pxMsgs Messages to send
+   \param[in] uiCount Number of messages
+   \param[out] puiSent Number of messages written, also on failure
+   \return UGW_IPC_SUCCESS/UGW_IPC_FAIL
+*/
+
+EXTERN char8
+UGW_IPC_SendMsgBatch(IN int32 iFd,
+		     IN x_UGW_IPC_MsgDesc * pxMsgs,
+		     IN uint32 uiCount, OUT uint32 * puiSent);
+
+/*!
+   \brief Function to initialise a buffered reader on a FIFO.
+   \param[in] pxReader Reader
+   \param[in] iFd FIFO fd, blocking or non-blocking
+*/
+
+EXTERN void UGW_IPC_ReaderInit(IN x_UGW_IPC_Reader * pxReader, IN int32 iFd);
+
+/*!
+   \brief Function to check whether the reader holds a whole message. The
+   fd does not poll readable for messages already buffered, callers that
+   select() on it call UGW_IPC_ReaderNext until this returns 0.
+   \param[in] pxReader Reader
+   \return 1 if a message is buffered, else 0
+*/
+
+EXTERN uint32 UGW_IPC_ReaderHasMsg(IN x_UGW_IPC_Reader * pxReader);
+
+/*!
+   \brief Function to receive IPC message through a reader. One read() takes
+   in all the messages the FIFO holds, they are then returned in place
+   without copying. The payload is not NUL terminated and both pointers are
+   valid until the next call.
+   \param[in] pxReader Reader
+   \param[out] ppxHdr Message header
+   \param[out] ppcMsg Message payload
+   \param[out] pErr UGW_IPC_NO_ERR when a non-blocking FIFO is empty,
+   UGW_IPC_FIFO_READ_ERR on read error or end of file, UGW_IPC_HDR_ERR on
+   a corrupt header
+   \return UGW_IPC_SUCCESS/UGW_IPC_FAIL
+*/
+
+EXTERN char8
+UGW_IPC_ReaderNext(IN x_UGW_IPC_Reader * pxReader,
+		   OUT x_UGW_IPC_MsgHdr ** ppxHdr,
+		   OUT char8 ** ppcMsg, OUT char8 * pErr);
+
 #endif				/* __UGW_IPC_H__ */
 
 /*! \def UGW_OS_ReadFifo 
@@ -257,3 +339,8 @@ UGW_IPC_RecvMsg(IN int32 iFd,
     \brief write data to FIFO
  */
 #define UGW_OS_WriteFifo(iFd, pcWrite, iSize) write(iFd, pcWrite, iSize)
+
+/*! \def UGW_OS_WriteFifoV 
+    \brief write scattered data to FIFO
+ */
+#define UGW_OS_WriteFifoV(iFd, pxIov, iIovCnt) writev(iFd, pxIov, iIovCnt)
@@ -57,11 +57,73 @@ typedef struct
    int32_t respCode;
 } x_ipc_msghdr_t;
 
+/*! \def IPC_CHANNEL_FLAG
+    \brief Set in xhdr.uireserved of a channel request: the listener keeps the
+    connection open after the reply. The reply carries it back only when the
+    connection was kept, the low bits carry the request id.
+ */
+#define IPC_CHANNEL_FLAG 0x80000000U
+
+/*! \def IPC_BLOB_FLAG
+    \brief Set in xhdr.uireserved of a channel message that has a memfd
+    payload (x_ipc_blob) passed with it.
+ */
+#define IPC_BLOB_FLAG 0x40000000U
+
+/*! \def IPC_CHANNEL_ID_MASK
+    \brief Request id bits of xhdr.uireserved, the low 30 bits below
+    IPC_CHANNEL_FLAG and IPC_BLOB_FLAG.
+ */
+#define IPC_CHANNEL_ID_MASK 0x3FFFFFFFU
+
+/*! \def IPC_TRANSPORT_STREAM
+    \brief Listener on a SOCK_STREAM socket, messages are framed by their
+    header and may take several reads.
+ */
+#define IPC_TRANSPORT_STREAM 0
+
+/*! \def IPC_TRANSPORT_SEQPACKET
+    \brief Listener on a SOCK_SEQPACKET socket, each message is one record
+    sent and received whole with one call. Clients detect the type of the
+    listener when they connect.
+ */
+#define IPC_TRANSPORT_SEQPACKET 1
+
+/*! \def IPC_MAX_CHANNELS
+    \brief Connections a listener keeps open between requests.
+ */
+#define IPC_MAX_CHANNELS 16
+
 typedef struct{
         int32_t ifd; /* Socket Id */
         int32_t iconnfd; /*Connection Id */
+        uint32_t uichannelreq; /* uireserved of the channel request on iconnfd, 0 if none */
+        int32_t inchannels; /* Number of kept connections */
+        int32_t aichannelfd[IPC_MAX_CHANNELS]; /* Kept connections waiting for a request */
+        int32_t itransport; /* IPC_TRANSPORT_STREAM or IPC_TRANSPORT_SEQPACKET */
 }x_ipc_handle;
 
+typedef struct{
+        int32_t ifd; /* Connected socket, -1 until the first request */
+        uint32_t uinextid; /* Id of the next request */
+        char acto[MAX_MODID_LEN]; /* Listener the channel connects to */
+        int32_t itransport; /* Transport of the connection */
+}x_ipc_channel;
+
+
+/*! \brief Payload too large for acmsg, in a memfd passed over the socket
+   with the message instead of being copied through it
+ */
+typedef struct{
+        int32_t ifd; /* memfd, -1 if none */
+        size_t isize; /* Payload size */
+        void *pvdata; /* Mapping of the payload, NULL if none */
+}x_ipc_blob;
+
+/*! \def IPC_NO_REPLY
+    \brief Handler return value: the request gets no reply.
+ */
+#define IPC_NO_REPLY 1
 
 /*! \def IPC_HDR_SIZE 
     \brief Macro that defines IPC Header Size.
@@ -100,6 +162,12 @@ ipc_recv(void *pvhandle,
 void*
 ipc_create_listener(char *pucto);
 
+/*! \brief ipc_create_listener_ex Listen to the client request on transport
+   itransport, IPC_TRANSPORT_STREAM or IPC_TRANSPORT_SEQPACKET
+*/
+void*
+ipc_create_listener_ex(char *pucto, int32_t itransport);
+
 /*! \brief ipc_send_reply to client/server 
    \params Socket Id and Message to be passed 
 */
@@ -107,6 +175,153 @@ int32_t
 ipc_send_reply(void *pvhandle,
                x_ipc_msg_t *pxmsg);
 
+/*! \brief ipc_channel_open creates a channel to the listener pucto, the
+   connection is made on the first request and reused by the next ones
+   \params Listener name
+*/
+void*
+ipc_channel_open(char *pucto);
+
+/*! \brief ipc_channel_request sends a request on the channel and waits for
+   its reply, the reply overwrites pxmsg. A connection the listener closed
+   since the last request is replaced before sending. The request is sent
+   again on a new connection only when it could not be written whole, so it
+   runs at most once: a connection lost after the request was sent fails the
+   call, and the caller decides whether it is safe to retry.
+   \params Channel and Message to be passed
+*/
+int32_t
+ipc_channel_request(void *pvchannel, x_ipc_msg_t *pxmsg);
+
+/*! \brief ipc_channel_request_blob is ipc_channel_request with a large
+   payload: pxblob (may be NULL) is passed with the request, a blob the
+   reply carries is mapped into pxreplyblob (closed if NULL). The blobs
+   stay the caller's, free them with ipc_blob_free
+   \params Channel, Message, request blob and reply blob
+*/
+int32_t
+ipc_channel_request_blob(void *pvchannel, x_ipc_msg_t *pxmsg,
+		x_ipc_blob *pxblob, x_ipc_blob *pxreplyblob);
+
+/*! \brief ipc_blob_alloc creates a blob of isize bytes mapped writable,
+   for the sender to fill before passing it. Its size is sealed
+   \return IPC_SUCCESS or IPC_FAIL
+*/
+int32_t
+ipc_blob_alloc(x_ipc_blob *pxblob, size_t isize);
+
+/*! \brief ipc_blob_free unmaps and closes a blob, pxblob is left empty */
+void
+ipc_blob_free(x_ipc_blob *pxblob);
+
+/*! \brief ipc_channel_close closes the connection and frees the channel */
+void
+ipc_channel_close(void *pvchannel);
+
+/*! \brief Completion of an ipc_async_submit request: iresult is IPC_SUCCESS
+   with the reply in pxreply (valid during the call only), or IPC_FAIL with
+   pxreply NULL when the connection was lost or the client closed.
+   A completion may call ipc_async_submit, ipc_async_cancel,
+   ipc_async_pending, ipc_async_fd, ipc_async_events and ipc_async_close on
+   its client; the client is freed after the completions in progress return.
+   ipc_async_dispatch does nothing when called from a completion
+*/
+typedef void (*pfn_ipc_completion)(uint32_t uiticket, int32_t iresult,
+		x_ipc_msg_t *pxreply, void *pvarg);
+
+/*! \brief ipc_async_open creates a client sending pipelined requests to the
+   listener pucto over one connection, made on the first submit
+   \params Listener name
+*/
+void*
+ipc_async_open(char *pucto);
+
+/*! \brief ipc_async_submit sends a request without waiting for its reply,
+   pfncb is called with it from ipc_async_dispatch. The request id goes in
+   xhdr.uireserved, the listener must keep channels open (ipc_server_* or
+   ipc_recv) for the requests behind the first one to be answered
+   \params Client, Message, completion callback and its argument, ticket out
+   \return IPC_SUCCESS or IPC_FAIL
+*/
+int32_t
+ipc_async_submit(void *pvasync, x_ipc_msg_t *pxmsg, pfn_ipc_completion pfncb,
+		void *pvarg, uint32_t *puiticket);
+
+/*! \brief ipc_async_cancel drops the completion of a submitted request, its
+   reply is discarded on arrival
+   \return IPC_SUCCESS or IPC_FAIL when the ticket is not pending
+*/
+int32_t
+ipc_async_cancel(void *pvasync, uint32_t uiticket);
+
+/*! \brief ipc_async_fd returns the connection to poll, -1 when there is
+   none; poll it for ipc_async_events()
+*/
+int32_t
+ipc_async_fd(void *pvasync);
+
+/*! \brief ipc_async_events returns the poll events to wait for: POLLIN
+   while replies are due, plus POLLOUT while requests wait to be sent
+*/
+int16_t
+ipc_async_events(void *pvasync);
+
+/*! \brief ipc_async_dispatch sends what is queued and completes the
+   requests whose replies arrived, without blocking
+   \return number of completions called, IPC_FAIL if the connection was lost
+*/
+int32_t
+ipc_async_dispatch(void *pvasync);
+
+/*! \brief ipc_async_pending returns the number of requests not completed */
+int32_t
+ipc_async_pending(void *pvasync);
+
+/*! \brief ipc_async_close fails the pending requests and frees the client */
+void
+ipc_async_close(void *pvasync);
+
+/*! \brief Request handler of ipc_server_create. pxmsg holds the request and
+   is turned into the reply in place; return IPC_SUCCESS to send it,
+   IPC_NO_REPLY to send nothing or IPC_FAIL to drop the client.
+   pxreqblob is the request's blob (ifd -1 if none), valid during the call;
+   a blob the handler allocates in pxreplyblob is sent with a channel reply
+   and freed
+*/
+typedef int32_t (*pfn_ipc_handler)(x_ipc_msg_t *pxmsg, x_ipc_blob *pxreqblob,
+		x_ipc_blob *pxreplyblob, void *pvarg);
+
+/*! \brief ipc_server_create creates the listener pucto for many concurrent
+   clients, each request is handed to pfnhandler from ipc_server_dispatch
+   \params Listener name, handler and its argument
+*/
+void*
+ipc_server_create(char *pucto, pfn_ipc_handler pfnhandler, void *pvarg);
+
+/*! \brief ipc_server_create_ex is ipc_server_create on transport
+   itransport, IPC_TRANSPORT_STREAM or IPC_TRANSPORT_SEQPACKET
+*/
+void*
+ipc_server_create_ex(char *pucto, int32_t itransport, pfn_ipc_handler pfnhandler,
+		void *pvarg);
+
+/*! \brief ipc_server_fd returns the fd that polls readable when
+   ipc_server_dispatch has work, to run the server from another event loop
+*/
+int32_t
+ipc_server_fd(void *pvserver);
+
+/*! \brief ipc_server_dispatch waits up to itimeoutms (-1 forever) and
+   serves what arrived: accepts clients, reads, calls the handler, replies
+   \return number of events handled, 0 on timeout, IPC_FAIL on error
+*/
+int32_t
+ipc_server_dispatch(void *pvserver, int32_t itimeoutms);
+
+/*! \brief ipc_server_destroy closes the listener and its clients */
+void
+ipc_server_destroy(void *pvserver);
+
 /*! \brief ipc_get_memory allocates a shared memory segment  */
 int32_t ipc_get_memory(uint32_t *shm_key, int32_t *shm_id, char **data, uint32_t size, int32_t create);
 
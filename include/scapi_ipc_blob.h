@@ -0,0 +1,41 @@
+/********************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ipc_blob.h                                     *
+ *         Description  :  Descriptor passing helpers shared by the IPC client  *
+ *                         and server for memfd payloads                        *
+ *  *****************************************************************************/
+
+#ifndef _SCAPI_IPC_BLOB_H
+#define _SCAPI_IPC_BLOB_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/*! \brief One sendmsg() of ilen bytes of pvbuf, with ipassfd attached to
+    the first byte unless it is -1. MSG_NOSIGNAL, iflags added
+    \return bytes sent or -1 with errno set
+*/
+ssize_t ipc_send_fd(int32_t ifd, const void *pvbuf, size_t ilen, int32_t ipassfd, int32_t iflags);
+
+/*! \brief One recvmsg() of up to ilen bytes. A descriptor that came with
+    them is stored in *pipassfd (close-on-exec), else -1
+    \return bytes read, 0 at end of stream or -1 with errno set
+*/
+ssize_t ipc_recv_fd(int32_t ifd, void *pvbuf, size_t ilen, int32_t *pipassfd);
+
+/*! \brief Maps a received memfd read only into pxblob, which owns ipassfd
+    from then on even on failure. The memfd must be sealed against
+    shrinking so the mapping cannot fault
+    \return IPC_SUCCESS or IPC_FAIL
+*/
+int32_t ipc_blob_map(x_ipc_blob *pxblob, int32_t ipassfd);
+
+#endif
@@ -0,0 +1,145 @@
+/********************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ipc_ring.h                                     *
+ *         Description  :  Shared memory single producer / single consumer      *
+ *                         ring carrying UGW IPC messages                       *
+ *  *****************************************************************************/
+
+/*! \file scapi_ipc_ring.h
+    \brief Shared memory ring for the UGW IPC messages of the high rate paths.
+    Messages are framed as on the FIFOs, but a send or receive is two
+    copies in user space and no system call, except to wake a receiver
+    that sleeps on an empty ring. A ring has one writer and one reader:
+    a module receiving from several others opens one ring per sender.
+*/
+
+#ifndef __UGW_IPC_RING_H__
+#define __UGW_IPC_RING_H__
+
+#include "scapi_basic_types.h"
+#include "scapi_fifo.h"
+
+/* RTP writes to RM thru this ring */
+/*! \def UGW_IPC_RTP_RM_RING
+    \brief RTP writes to RM thru this ring
+*/
+#define UGW_IPC_RTP_RM_RING    UGW_IPC_FIFO_DIR"/RtpRmRing"
+
+/* RM writes to RTP thru this ring */
+/*! \def UGW_IPC_RM_RTP_RING
+    \brief RM writes to RTP thru this ring
+*/
+#define UGW_IPC_RM_RTP_RING    UGW_IPC_FIFO_DIR"/RmRtpRing"
+
+/*! \def UGW_IPC_RING_DEF_SIZE
+    \brief Default ring data size in bytes, rounded up to a power of two.
+*/
+#define UGW_IPC_RING_DEF_SIZE  (64 * 1024)
+
+/*! \def UGW_IPC_RING_FULL
+    \brief Error reported when the ring has no room for the message.
+*/
+#define UGW_IPC_RING_FULL      (UGW_IPC_MSG_ERR + 1)
+
+/*! \def UGW_IPC_RING_TIMEOUT
+    \brief Error reported when no message arrived in time.
+*/
+#define UGW_IPC_RING_TIMEOUT   (UGW_IPC_MSG_ERR + 2)
+
+/* Layout of the shared mapping, private to scapi_ipc_ring.c */
+struct x_UGW_IPC_RingShm;
+
+/*!
+    \brief Structure describing one end of a ring.
+*/
+typedef struct {
+	struct x_UGW_IPC_RingShm *pxShm;	/*!< Shared mapping */
+	uint32 uiMapSize;	/*!< Size of the mapping */
+	uint32 uiMask;		/*!< Ring data size - 1 */
+	uint32 uiPeerIdx;	/*!< Last index seen from the other end */
+} x_UGW_IPC_Ring;
+
+/* PUBLIC Functions */
+
+/*!
+   \brief Function to create a ring, called by the receiver. A ring left
+   at pcPath by an earlier run is replaced, senders attached to it must
+   open it again.
+   \param[out] pxRing Ring
+   \param[in] pcPath File backing the ring, on tmpfs
+   \param[in] uiSize Data size in bytes, at least one message of
+   UGW_IPC_MAX_MSG_SIZE
+   \return UGW_IPC_SUCCESS/UGW_IPC_FAIL
+*/
+
+EXTERN char8 UGW_IPC_RingCreate(OUT x_UGW_IPC_Ring * pxRing,
+				IN char8 * pcPath, IN uint32 uiSize);
+
+/*!
+   \brief Function to open a ring created by the receiver, called by the sender.
+   \param[out] pxRing Ring
+   \param[in] pcPath File backing the ring
+   \return UGW_IPC_SUCCESS/UGW_IPC_FAIL, also while the ring is not created yet
+*/
+
+EXTERN char8 UGW_IPC_RingOpen(OUT x_UGW_IPC_Ring * pxRing, IN char8 * pcPath);
+
+/*!
+   \brief Function to unmap a ring. The file stays until the receiver unlinks it.
+   \param[in] pxRing Ring
+*/
+
+EXTERN void UGW_IPC_RingClose(IN x_UGW_IPC_Ring * pxRing);
+
+/*!
+   \brief Function to send a message on a ring. It does not block: when the
+   receiver lags the message is refused.
+   \param[in] pxRing Ring
+   \param[in] ucFrom Module Id of the addressee
+   \param[in] ucTo Module Id of the addressed
+   \param[in] unMsgSize Size of message
+   \param[in] uiReserved
+   \param[in] pcMsg Pointer to message
+   \param[out] pErr UGW_IPC_RING_FULL when the ring has no room, else UGW_IPC_MSG_ERR
+   \return UGW_IPC_SUCCESS/UGW_IPC_FAIL
+*/
+
+EXTERN char8 UGW_IPC_RingSendMsg(IN x_UGW_IPC_Ring * pxRing,
+				 IN uchar8 ucFrom,
+				 IN uchar8 ucTo,
+				 IN uint16 unMsgSize,
+				 IN uint32 uiReserved,
+				 IN char8 * pcMsg, OUT char8 * pErr);
+
+/*!
+   \brief Function to receive a message from a ring.
+   \param[in] pxRing Ring
+   \param[in] iTimeoutMs Time to wait on an empty ring, 0 not to wait, -1 forever
+   \param[out] pucFrom Module Id of the addressee
+   \param[out] pucTo Module Id of the addressed
+   \param[out] punMsgSize Size of message
+   \param[out] puiReserved
+   \param[out] pcMsg Buffer of UGW_IPC_MAX_MSG_SIZE + 1 bytes, the message
+   is NUL terminated as with UGW_IPC_RecvMsg
+   \param[out] pErr UGW_IPC_RING_TIMEOUT when no message came, UGW_IPC_HDR_ERR
+   on a corrupt ring
+   \return UGW_IPC_SUCCESS/UGW_IPC_FAIL
+*/
+
+EXTERN char8 UGW_IPC_RingRecvMsg(IN x_UGW_IPC_Ring * pxRing,
+				 IN int32 iTimeoutMs,
+				 OUT uchar8 * pucFrom,
+				 OUT uchar8 * pucTo,
+				 OUT uint16 * punMsgSize,
+				 OUT uint32 * puiReserved,
+				 OUT char8 * pcMsg, OUT char8 * pErr);
+
+#endif				/* __UGW_IPC_RING_H__ */
@@ -0,0 +1,72 @@
+/********************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_netlink.h                                      *
+ *         Description  :  rtnetlink helpers shared by the interface snapshot,  *
+ *                         interface cache and batch configuration APIs         *
+ *  *****************************************************************************/
+
+#ifndef _SCAPI_NETLINK_H
+#define _SCAPI_NETLINK_H
+
+#include <stdint.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+/*! \def SCAPI_NL_BUF_SIZE
+    \brief Receive buffer for one recvmsg() on a rtnetlink socket
+*/
+#define SCAPI_NL_BUF_SIZE 32768
+
+/*! \brief Callback invoked for every message of a dump or notification batch.
+    Returning a -ve value stops the walk and is passed back to the caller
+*/
+typedef int (*pfnScapiNlCb)(struct nlmsghdr *pxNlh, void *pvArg);
+
+/*! \brief Opens a NETLINK_ROUTE socket subscribed to unGroups (RTMGRP_* mask)
+    \return socket descriptor or -errno
+*/
+int scapi_nlOpen(uint32_t unGroups);
+
+/*! \brief Runs one NLM_F_DUMP request of type unType and walks every reply
+    \return EXIT_SUCCESS, -EAGAIN if the dump was interrupted by a change, or -errno
+*/
+int scapi_nlDump(int nFd, uint16_t unType, uint8_t ucFamily, uint32_t unSeq, pfnScapiNlCb pfnCb, void *pvArg);
+
+/*! \brief Reads whatever is queued on nFd once and walks every message
+    \return Number of bytes processed, 0 if nothing was queued (non blocking socket) or -errno
+*/
+int scapi_nlRecv(int nFd, int nFlags, pfnScapiNlCb pfnCb, void *pvArg);
+
+/*! \brief Fills an IfcSnapshot_t (without addresses) from a RTM_NEWLINK/RTM_DELLINK message
+    \return EXIT_SUCCESS or -EINVAL
+*/
+int scapi_nlParseLink(struct nlmsghdr *pxNlh, IfcSnapshot_t *pxIfc);
+
+/*! \brief Fills an IfcSnapshotAddr_t from a RTM_NEWADDR/RTM_DELADDR message
+    \return EXIT_SUCCESS, -EAFNOSUPPORT for families other than ipv4/ipv6 or -EINVAL
+*/
+int scapi_nlParseAddr(struct nlmsghdr *pxNlh, int32_t *pnIfindex, IfcSnapshotAddr_t *pxAddr);
+
+/*! \brief Link attributes of pcIfname from the interface cache
+    \return EXIT_SUCCESS, or -ENOENT when the cache is off, stale or misses
+*/
+int scapi_ifcCacheGetLink(const char *pcIfname, IfcSnapshot_t *pxLink);
+
+/*! \brief ipv4 address labelled pcIfname from the interface cache
+    \return EXIT_SUCCESS, -EADDRNOTAVAIL if the interface has none, or -ENOENT when the cache cannot answer
+*/
+int scapi_ifcCacheGetIpv4(const char *pcIfname, IfcSnapshotAddr_t *pxAddr);
+
+/*! \brief Makes getters bypass the interface cache until it has caught up with a change just made
+*/
+void scapi_ifcCacheInvalidate(void);
+
+#endif				// _SCAPI_NETLINK_H
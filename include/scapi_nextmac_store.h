@@ -0,0 +1,93 @@
+/********************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_nextmac_store.h                                *
+ *         Description  :  Lock protected record log behind nextmac.conf,      *
+ *                         shared by the next mac get/remove/swap APIs          *
+ *  *****************************************************************************/
+
+#ifndef _SCAPI_NEXTMAC_STORE_H
+#define _SCAPI_NEXTMAC_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define NEXT_MAC_CONF VENDOR_PATH "/servd/etc/nextmac.conf"
+#define NEXT_MAC_6g_CONF VENDOR_PATH "/servd/etc/nextmac-6g.conf"
+
+/*! \def NEXT_MAC_LOCK
+    \brief Lock files live beside the conf files, which themselves get replaced on
+    compaction. Not in /tmp, where anybody could hold or replace them
+*/
+#define NEXT_MAC_LOCK VENDOR_PATH "/servd/etc/.nextmac.lock"
+#define NEXT_MAC_6g_LOCK VENDOR_PATH "/servd/etc/.nextmac-6g.lock"
+
+/*! \def NEXT_MAC_COMPACT_DEAD
+    \brief Superseded records tolerated in the log before it is rewritten
+*/
+#define NEXT_MAC_COMPACT_DEAD 64
+
+/*! \brief One live interface to mac assignment */
+typedef struct {
+	char sIfname[IFNAMSIZ];
+	char sMac[SCAPI_MAC_LEN];
+} NextMacRec_t;
+
+/*! \brief Replayed view of a conf file, held under its lock.
+    The log is a sequence of "ifname> mac" records, the last one of an
+    interface wins, and "!ifname>" records which drop the interface
+*/
+typedef struct {
+	const char *pcConf;
+	int nLockFd;
+	NextMacRec_t *pxRecs;
+	int nCnt;
+	int nCap;
+	int nDead;          /*!< records in the file no longer live */
+	char *pcPending;    /*!< records not written yet */
+	size_t unPendLen;
+	size_t unPendCap;
+} NextMacStore_t;
+
+/*! \brief Locks (shared or exclusive) and replays pcConf, a missing file is an empty log
+    \return EXIT_SUCCESS or ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED / -ENOMEM
+*/
+int scapi_nmStoreOpen(NextMacStore_t *pxStore, const char *pcConf, const char *pcLock, bool bWrite);
+
+/*! \brief Live record of pcIfname, exact name match
+    \return record or NULL
+*/
+const NextMacRec_t *scapi_nmStoreFind(const NextMacStore_t *pxStore, const char *pcIfname);
+
+/*! \brief Assigns pcMac to pcIfname, written out by scapi_nmStoreCommit()
+    \return EXIT_SUCCESS, ERR_INPUT_VALIDATION_FAILED or -ENOMEM
+*/
+int scapi_nmStoreSet(NextMacStore_t *pxStore, const char *pcIfname, const char *pcMac);
+
+/*! \brief Drops the assignment of pcIfname, written out by scapi_nmStoreCommit()
+    \return EXIT_SUCCESS (also when there is none) or -ENOMEM
+*/
+int scapi_nmStoreRemove(NextMacStore_t *pxStore, const char *pcIfname);
+
+/*! \brief Appends the pending records with one write, or rewrites the file
+    when too many records are dead
+    \return EXIT_SUCCESS or ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED
+*/
+int scapi_nmStoreCommit(NextMacStore_t *pxStore);
+
+/*! \brief Removes the conf file and drops every record, for a store opened for write
+    \return EXIT_SUCCESS or ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED
+*/
+int scapi_nmStoreClear(NextMacStore_t *pxStore);
+
+/*! \brief Unlocks and frees the store, uncommitted records are dropped */
+void scapi_nmStoreClose(NextMacStore_t *pxStore);
+
+#endif
@@ -0,0 +1,79 @@
+/********************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_procscan.h                                     *
+ *         Description  :  /proc process scan shared by the killall and        *
+ *                         process name APIs                                    *
+ *  *****************************************************************************/
+
+#ifndef _SCAPI_PROCSCAN_H
+#define _SCAPI_PROCSCAN_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/*! \def SCAPI_PROC_COMM_LEN
+    \brief Names are compared on the kernel's comm length (TASK_COMM_LEN - 1)
+*/
+#define SCAPI_PROC_COMM_LEN 15
+
+/*! \def SCAPI_PROC_STAT_LEN
+    \brief Enough of /proc/PID/stat for the fields up to starttime
+*/
+#define SCAPI_PROC_STAT_LEN 512
+
+/*! \brief Growable list of pids */
+typedef struct {
+	pid_t *pnPids;
+	int nCnt;
+	int nCap;
+} ScapiPidVec_t;
+
+/*! \brief Called for every process whose comm matches ppcNames[nNameIdx].
+    Returning a -ve value stops the scan and is passed back to the caller
+*/
+typedef int (*pfnScapiProcCb)(pid_t nPid, int nNameIdx, uint64_t ullStartTime, void *pvArg);
+
+/*! \brief /proc directory descriptor kept open by the process, reopened after fork
+    \return descriptor or -errno
+*/
+int scapi_procDirFd(void);
+
+/*! \brief Opens /proc/PID/stat relative to nDirFd
+    \return descriptor, -ENOENT when the process is gone or -EINVAL
+*/
+int scapi_procOpenStat(int nDirFd, pid_t nPid);
+
+/*! \brief Like scapi_procReadStat() on a descriptor from scapi_procOpenStat().
+    Fails once that process is reaped, even if its pid is reused
+*/
+int scapi_procReadStatFd(int nFd, char *pcBuf, size_t unLen, char **ppcComm, uint64_t *pullStartTime);
+
+/*! \brief Reads /proc/PID/stat into pcBuf (openat + pread, no stdio) and
+    returns the comm and starttime fields. pcComm points into pcBuf
+    \return EXIT_SUCCESS, -ENOENT when the process is gone or -EINVAL
+*/
+int scapi_procReadStat(int nDirFd, pid_t nPid, char *pcBuf, size_t unLen, char **ppcComm, uint64_t *pullStartTime);
+
+/*! \brief Walks /proc once and calls pfnCb for each process matching any of
+    ppcNames (case insensitive, first SCAPI_PROC_COMM_LEN characters)
+    \return EXIT_SUCCESS, the callback's -ve value or -errno
+*/
+int scapi_procScan(const char * const *ppcNames, int nNames, pfnScapiProcCb pfnCb, void *pvArg);
+
+/*! \brief Appends nPid to pxVec
+    \return EXIT_SUCCESS or -ENOMEM
+*/
+int scapi_pidVecPush(ScapiPidVec_t *pxVec, pid_t nPid);
+
+/*! \brief Frees the pids held by pxVec */
+void scapi_pidVecFree(ScapiPidVec_t *pxVec);
+
+#endif
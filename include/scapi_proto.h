@@ -60,6 +60,19 @@ int scapi_traceroute(char *args, int pkt_size, TraceRouteResp_D * pTraceRouteRes
  */
 int scapi_killAll(char *pcProcessName, int nSignal);
 
+/**
+ * @brief SCAPI killall API for several process names
+ * @details Sends specified signal to all the processes with any of the specified names, found in a single walk of /proc. Signals are sent through pidfds, so a pid reused after the walk is never signalled, and the call can wait for the processes to exit
+ * @param[in] ppcNames Process names
+ * @param[in] nCount Number of process names
+ * @param[in] nSignal Signal number, -ve for SIGTERM
+ * @param[in] unFlags SCAPI_KILL_WAIT to wait for the processes to exit, SCAPI_KILL_KEEP_PIDFILE to keep /var/run/<name>.pid
+ * @param[in] nTimeoutMs Maximum wait with SCAPI_KILL_WAIT, in milliseconds, 0 or -ve to wait until all the processes have exited
+ *
+ * @return EXIT_SUCCESS on successful / -ESRCH if no process matched / -ETIMEDOUT if some are still running after the wait / other -ve value on failure
+ */
+int scapi_killAllMulti(char **ppcNames, int nCount, int nSignal, unsigned int unFlags, int nTimeoutMs);
+
 /**
  * @brief SCAPI ping API
  * @details Pings an address 
@@ -266,6 +279,171 @@ int scapi_getIfcUpdown(char *pcIfname, bool * status);
  */
 int scapi_setIfcUpdown(char *pcIfname, bool updown);
 
+/**
+ * @brief SCAPI control socket ioctl API
+ * @details Issues an interface/vlan/route ioctl on a control socket that is opened
+ * once per thread and kept open. The socket is closed on thread exit and is not
+ * shared with children after fork
+ *
+ * @param[in] ulRequest ioctl request code
+ * @param[in,out] pvArg ioctl argument
+ *
+ * @return EXIT_SUCCESS on successful / -errno of the failing call on failure
+ */
+int scapi_ctrlSockIoctl(unsigned long ulRequest, void *pvArg);
+
+/**
+ * @brief SCAPI control socket close API
+ * @details Closes the control socket of the calling thread, e.g before closing all
+ * descriptors when daemonizing. Next ioctl API call opens a new one. A descriptor number
+ * the application already closed and reused for another file is left open
+ */
+void scapi_ctrlSockClose(void);
+
+/**
+ * @brief SCAPI interface snapshot API
+ * @details Gets name, index, flags, mtu, tx queue length, mac address and all ipv4/ipv6
+ * addresses of every interface using one rtnetlink link dump and one address dump
+ *
+ * @param[out] ppxSnapshot Pointer to the resultant array of interfaces
+ * @param[out] pnCount Number of interfaces in the array
+ *
+ * @return EXIT_SUCCESS on successful / -ve value (depending on the type of error) on failure
+ *
+ * @note Interfaces and their addresses are returned in a single buffer. It is the duty of the caller to free *ppxSnapshot.
+ */
+int scapi_getIfcSnapshot(IfcSnapshot_t **ppxSnapshot, int *pnCount);
+
+/**
+ * @brief SCAPI interface cache enable API
+ * @details Loads all interfaces and their ipv4 addresses and keeps them up to date from
+ * rtnetlink notifications in a background thread. While enabled, scapi_getIfcIpaddr,
+ * scapi_getIfcNetmask, scapi_getIfcMacaddr, scapi_getIfcTxQueuelen and scapi_getIfcUpdown
+ * are answered from memory, falling back to ioctl on a miss
+ *
+ * @return EXIT_SUCCESS on successful / -ve value (depending on the type of error) on failure
+ *
+ * @note The cache is not inherited across fork, children use the ioctl path
+ */
+int scapi_ifcCacheEnable(void);
+
+/**
+ * @brief SCAPI interface cache disable API
+ * @details Stops the background thread and frees the cache
+ *
+ * @return EXIT_SUCCESS
+ */
+int scapi_ifcCacheDisable(void);
+
+/**
+ * @brief SCAPI interface cache generation API
+ * @details Returns a counter incremented on every link or ipv4 address change seen by the
+ * cache. Callers polling interface state can skip their work while it does not change
+ *
+ * @return generation counter
+ */
+uint32_t scapi_ifcCacheGeneration(void);
+
+/**
+ * @brief SCAPI interface batch begin API
+ * @details Starts a batch of interface configuration operations. Operations added to the
+ * batch are sent to the kernel together by scapi_ifcBatchCommit() as one rtnetlink message
+ * stream, instead of one socket and system call per setting
+ *
+ * @param[out] ppxBatch Pointer to the new batch
+ *
+ * @return EXIT_SUCCESS on successful / -ve value (depending on the type of error) on failure
+ *
+ * @note The batch is freed with scapi_ifcBatchFree()
+ */
+int scapi_ifcBatchBegin(IfcBatch_t **ppxBatch);
+
+/**
+ * @brief SCAPI interface batch mac address API
+ * @details Queues a mac address change of an interface
+ *
+ * @param[in] pxBatch Batch
+ * @param[in] pcIfname Interface name
+ * @param[in] pcMac Mac address to be set
+ *
+ * @return operation index (>= 0) on successful / -ve value (depending on the type of error) on failure
+ */
+int scapi_ifcBatchSetMacaddr(IfcBatch_t *pxBatch, char *pcIfname, char *pcMac);
+
+/**
+ * @brief SCAPI interface batch ip address API
+ * @details Queues an ipv4 address and netmask change of an interface. Like scapi_setIfcIpaddr()
+ * the new address replaces the one the interface has when the operation is added
+ *
+ * @param[in] pxBatch Batch
+ * @param[in] pcIfname Interface name
+ * @param[in] pcIp Ip address to be set
+ * @param[in] pcNetmask Netmask to be set
+ *
+ * @return operation index (>= 0) on successful / -ve value (depending on the type of error) on failure
+ */
+int scapi_ifcBatchSetIpaddr(IfcBatch_t *pxBatch, char *pcIfname, char *pcIp, char *pcNetmask);
+
+/**
+ * @brief SCAPI interface batch tx queue length API
+ * @details Queues a tx queue length change of an interface
+ *
+ * @param[in] pxBatch Batch
+ * @param[in] pcIfname Interface name
+ * @param[in] nTxqueuelen Queue length to be set
+ *
+ * @return operation index (>= 0) on successful / -ve value (depending on the type of error) on failure
+ */
+int scapi_ifcBatchSetTxQueuelen(IfcBatch_t *pxBatch, char *pcIfname, int nTxqueuelen);
+
+/**
+ * @brief SCAPI interface batch up/down API
+ * @details Queues bringing an interface up or down
+ *
+ * @param[in] pxBatch Batch
+ * @param[in] pcIfname Interface name
+ * @param[in] updown 0(DOWN), 1(UP)
+ *
+ * @return operation index (>= 0) on successful / -ve value (depending on the type of error) on failure
+ */
+int scapi_ifcBatchSetUpdown(IfcBatch_t *pxBatch, char *pcIfname, bool updown);
+
+/**
+ * @brief SCAPI interface batch commit API
+ * @details Sends all queued operations and waits for their results. Operations are applied
+ * in the order they were added, a failed operation does not stop the ones after it
+ *
+ * @param[in] pxBatch Batch
+ *
+ * @return EXIT_SUCCESS when all operations succeeded / result of the first failed operation on failure
+ *
+ * @note Results of single operations are read with scapi_ifcBatchResult(). The batch can be
+ * reused for more operations after commit: the first operation added then discards the results
+ * and operation indexes start again from 0. Committing again without adding operations returns
+ * EXIT_SUCCESS
+ */
+int scapi_ifcBatchCommit(IfcBatch_t *pxBatch);
+
+/**
+ * @brief SCAPI interface batch result API
+ * @details Returns the result of one operation of a committed batch, until the next operation
+ * is added
+ *
+ * @param[in] pxBatch Batch
+ * @param[in] nOp Operation index returned when the operation was added
+ *
+ * @return EXIT_SUCCESS on successful / -errno reported by the kernel on failure, -EINPROGRESS before commit
+ */
+int scapi_ifcBatchResult(IfcBatch_t *pxBatch, int nOp);
+
+/**
+ * @brief SCAPI interface batch free API
+ * @details Frees a batch, operations not committed are dropped
+ *
+ * @param[in] pxBatch Batch
+ */
+void scapi_ifcBatchFree(IfcBatch_t *pxBatch);
+
 /**
  * @brief SCAPI vlan add API
  * @details API to add a vlan interface
@@ -457,6 +635,28 @@ int scapi_getMbssidNextMacaddr(char *pcIfname, bool bGlobal, char *pcMac);
  * @return EXIT_SUCCESS on successful / -ve value (depending on the type of error) on failure
  */
 int scapi_getNextMacaddr(char *pcIfname, bool bGlobal, char *pcMac);
+/**
+ * @brief SCAPI gets next MAC addresses of several interfaces API
+ * @details Same as scapi_getNextMacaddr for nCount interfaces, with the base MAC read once, the config file locked and loaded once and all new entries appended with one write. Either all MAC addresses are allocated or none
+ * @param[in] ppcIfnames Interface names for which MAC addresses should be generated
+ * @param[in] nCount Number of interfaces
+ * @param[in] bGlobal Global (reserved) or private MAC addresses
+ * @param[in,out] ppcMacs Buffers of SCAPI_MAC_LEN where generated MAC addresses will be stored, a non empty one is the MAC requested for that interface
+ *
+ * @return EXIT_SUCCESS on successful / -ve value (depending on the type of error) on failure
+ */
+int scapi_getNextMacaddrBatch(char **ppcIfnames, int nCount, bool bGlobal, char **ppcMacs);
+/**
+ * @brief SCAPI gets MBSSID next MAC addresses of several interfaces API
+ * @details Batch version of scapi_getMbssidNextMacaddr, see scapi_getNextMacaddrBatch
+ * @param[in] ppcIfnames Interface names for which MAC addresses should be generated
+ * @param[in] nCount Number of interfaces
+ * @param[in] bGlobal Global (reserved) or private MAC addresses
+ * @param[in,out] ppcMacs Buffers of SCAPI_MAC_LEN where generated MAC addresses will be stored
+ *
+ * @return EXIT_SUCCESS on successful / -ve value (depending on the type of error) on failure
+ */
+int scapi_getMbssidNextMacaddrBatch(char **ppcIfnames, int nCount, bool bGlobal, char **ppcMacs);
 /**
  * @brief SCAPI function to set loglevel of this library
  * @details function sets the log level based on the caller daemon(CSD and Servd)
@@ -549,6 +749,17 @@ int scapi_routeDel(char *pcDest, char *pcGateway, char *pcGenmask, char *pcDev);
  */
 char *scapi_get_process_name(pid_t process_num);
 
+/**
+ * @brief SCAPI reentrant get process name API
+ * @details API to get process name when PID is provided, into a caller buffer. Safe to call from several threads, the last looked up processes are answered without opening /proc again
+ * 
+ * @param[in] nPid PID
+ * @param[out] pcBuf Buffer for the process name, truncated to its size
+ * @param[in] unLen Size of pcBuf, 16 bytes hold any name
+ * @return EXIT_SUCCESS on successful / -ENOENT if there is no such process / -EINVAL on invalid input
+ */
+int scapi_get_process_name_r(pid_t nPid, char *pcBuf, size_t unLen);
+
 /*! \brief API for command line utility of controld 
 */
 int32_t ControlDCtl(eControlDOption_t eControlDOption, ControlDArgs_t * pxControlDArgs);
@@ -726,6 +937,9 @@ int32_t scapi_restartCrond(void);
 int32_t scapi_setCronjob(IN char *pcMin, IN char *pcHour, IN char *pcDayOfMon, IN char *pcMonth, IN char *pcDayOfWeek, IN char *pcCommand, IN int32_t nAction);
 
 /*!  \brief function to get mac address
+  \details The base mac is read once per boot and then cached for the rest of
+  the boot, in the process and in a root owned file. A runtime change of the
+  nvram ethaddr is only returned after a reboot.
   \param[in] pcMac mac address holder.
   \return  mac address on UGW_SUCCESS or the error code.
   */
@@ -538,4 +538,35 @@ typedef struct {
     arpEntry_t arpEntry[MAX_ARP_ENTRY];
 }arpTable_t;
 
+/*!
+    \brief This is the data structure for one ipv4/ipv6 address of an interface snapshot.
+*/
+typedef struct {
+	uint8_t ucFamily;			/*!< AF_INET or AF_INET6 */
+	uint8_t ucPrefixLen;			/*!< Prefix length of the address */
+	uint8_t ucScope;			/*!< Address scope, RT_SCOPE_* */
+	uint32_t unFlags;			/*!< IFA_F_* flags, e.g IFA_F_SECONDARY */
+	char sAddr[INET6_ADDRSTRLEN];		/*!< Address in presentation format */
+	char sLabel[IFNAMSIZ];			/*!< ipv4 address label, e.g eth0:1 for an alias */
+} IfcSnapshotAddr_t;
+
+/*!
+    \brief This is the data structure for one interface of an interface snapshot.
+*/
+typedef struct {
+	char sIfname[IFNAMSIZ];			/*!< Interface name */
+	int32_t nIfindex;			/*!< Interface index */
+	uint32_t unFlags;			/*!< IFF_* flags */
+	uint32_t unMtu;				/*!< MTU */
+	uint32_t unTxQueuelen;			/*!< Tx queue length */
+	char sMac[SCAPI_MAC_LEN];		/*!< Hardware address */
+	uint32_t unAddrCount;			/*!< Number of entries in pxAddrs */
+	IfcSnapshotAddr_t *pxAddrs;		/*!< Addresses, points into the same allocation */
+} IfcSnapshot_t;
+
+/*!
+    \brief Opaque batch of interface configuration operations, see scapi_ifcBatchBegin().
+*/
+typedef struct IfcBatch IfcBatch_t;
+
 #endif // _SCAPI_STRUCTS_H
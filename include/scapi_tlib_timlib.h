@@ -34,11 +34,19 @@
 /*Timer Notify Type*/
 #define UGW_TLIB_NOTIFY_VIA_SIGNAL 1
 #define UGW_TLIB_NOTIFY_VIA_FD 2
+#define UGW_TLIB_NOTIFY_VIA_TIMERFD 3	/* timerfd polled by the application, see UGW_TLIB_Dispatch */
 #define TIMER_DRV_MODE_CHANGE 2
 
+/*Timer Backend*/
+#define UGW_TLIB_BACKEND_LIST 0		/* sorted active list, O(n) start */
+#define UGW_TLIB_BACKEND_WHEEL 1	/* hierarchical timing wheel, O(1) start/stop */
+
 #define TRUE 1
 #define FALSE 0
 
+/* Longest timer of UGW_TLIB_StartTimer64, in us (about 31 years) */
+#define UGW_TLIB_MAX_TIMER_VALUE 1000000000000000ULL
+
 typedef void (* pfnVoidFunctPtr)(void *);
 
 typedef struct  {
@@ -54,7 +62,7 @@ typedef struct  {
 					uint16 unNextIndex;
 				 }x_UGW_TLIB_TimerInfo;
 						  
-x_UGW_TLIB_TimerInfo *pxTimerList;
+extern x_UGW_TLIB_TimerInfo *pxTimerList;
 	
 					
 struct x_UGW_TLIB_TimMgtInfo{
@@ -63,17 +71,38 @@ struct x_UGW_TLIB_TimMgtInfo{
 				uint16 unFreeTimLstHeadIndex;
 				uint16 unFreeTimLstTailIndex;
 				uint16 unMaxNumOfTimer;
-			 }vx_UGW_TLIB_TimMgtInfo;
+			 };
+
+extern struct x_UGW_TLIB_TimMgtInfo vx_UGW_TLIB_TimMgtInfo;
 
 
 int8 UGW_TLIB_TimersInit(uint16 unNumOfTimers,uchar8);
 
+/* Same as UGW_TLIB_TimersInit, ucBackend selects UGW_TLIB_BACKEND_LIST or
+ * UGW_TLIB_BACKEND_WHEEL. Timer ids and the Start/Stop API are the same */
+int8 UGW_TLIB_TimersInitEx(uint16 unNumOfTimers, uchar8 ucTimerNotifyType, uchar8 ucBackend);
+
 int8 UGW_TLIB_StartTimer(uint16 *punTimerId,uint32 uiTimerValue,
 		uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
 	  void *pCallBackFnParm);
 
+/* Same as UGW_TLIB_StartTimer, for timers longer than the ~71 minutes a
+ * 32 bit us value holds */
+int8 UGW_TLIB_StartTimer64(uint16 *punTimerId, uint64 ullTimerValue,
+		uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
+		void *pCallBackFnParm);
+
 int32 UGW_TLIB_StopTimer(uint16 unTimerId);
 
+/* Timer coalescing: a timer may expire up to its slack (us) late so that
+ * timers due close together are run by one wakeup. UGW_TLIB_SetTimerSlack
+ * sets the default of the timers started after it, 0 by default */
+int8 UGW_TLIB_StartTimerSlack(uint16 *punTimerId, uint32 uiTimerValue, uint32 uiSlack,
+		uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
+		void *pCallBackFnParm);
+
+void UGW_TLIB_SetTimerSlack(uint32 uiSlack);
+
 int8 UGW_TLIB_TimersDelete(void);						
 
 void UGW_TLIB_InitializeTimerList(uint16 unNumOfTimers);
@@ -93,11 +122,52 @@ void UGW_TLIB_SetTimer(uint32 uiUsec);
 void UGW_TLIB_FreeListHandler(x_UGW_TLIB_TimerInfo *pxTempNode);
 
 void  UGW_TLIB_CurrTimerExpiry(int);
+/* Timer contexts: a context is an independent set of timers with its own
+ * timerfd, used by a single thread without locking. Timer ids are per
+ * context. Poll UGW_TLIB_CtxGetFd() for POLLIN and call UGW_TLIB_CtxDispatch() */
+typedef struct x_UGW_TLIB_TimerCtx x_UGW_TLIB_TimerCtx;
+
+x_UGW_TLIB_TimerCtx *UGW_TLIB_CtxCreate(uint32 unNumOfTimers);
+
+void UGW_TLIB_CtxDestroy(x_UGW_TLIB_TimerCtx *pxCtx);
+
+int8 UGW_TLIB_CtxStartTimer(x_UGW_TLIB_TimerCtx *pxCtx, uint32 *punTimerId,
+		uint32 uiTimerValue, uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm);
+
+int8 UGW_TLIB_CtxStartTimerSlack(x_UGW_TLIB_TimerCtx *pxCtx, uint32 *punTimerId,
+		uint32 uiTimerValue, uint32 uiSlack, uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm);
+
+int8 UGW_TLIB_CtxStartTimer64(x_UGW_TLIB_TimerCtx *pxCtx, uint32 *punTimerId,
+		uint64 ullTimerValue, uint32 uiSlack, uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm);
+
+void UGW_TLIB_CtxSetSlack(x_UGW_TLIB_TimerCtx *pxCtx, uint32 uiSlack);
+
+int32 UGW_TLIB_CtxStopTimer(x_UGW_TLIB_TimerCtx *pxCtx, uint32 unTimerId);
+
+int32 UGW_TLIB_CtxGetFd(const x_UGW_TLIB_TimerCtx *pxCtx);
+
+/* Returns the number of callbacks run, -1 on failure */
+int32 UGW_TLIB_CtxDispatch(x_UGW_TLIB_TimerCtx *pxCtx);
+
 int8 IFIN_TLIB_TimersInit(uint16);
 int8 IFIN_TLIB_TimersDelete(void);
 
 uint32 UGW_TLIB_GetCurrTime(void);
 
+/* Time base of the timer deadlines, CLOCK_MONOTONIC in ns */
+uint64 UGW_TLIB_GetMonoTimeNs(void);
+
+/* UGW_TLIB_NOTIFY_VIA_TIMERFD: descriptor to add to the application's
+ * poll/epoll set, readable when timers are due. -1 in the other modes */
+int32 UGW_TLIB_GetTimerFd(void);
+
+/* UGW_TLIB_NOTIFY_VIA_TIMERFD: runs the callbacks of all the expired timers
+ * and arms the descriptor for the next one. Call when it is readable */
+int8 UGW_TLIB_Dispatch(void);
+
 int8 UGW_TLIB_CheckForEqualTimer(uint32 uiCurrTime);
 int8 IFIN_TLIB_StartTimer(uint16 *, uint32, uint8, pfnVoidFunctPtr, void *);
 int32 IFIN_TLIB_StopTimer(uint16);
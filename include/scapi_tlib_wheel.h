@@ -0,0 +1,106 @@
+/********************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_tlib_wheel.h                                   *
+ *         Description  :  Hierarchical timing wheel behind the UGW_TLIB        *
+ *                         timers, O(1) start and stop                          *
+ *  *****************************************************************************/
+
+#ifndef _SCAPI_TLIB_WHEEL_H
+#define _SCAPI_TLIB_WHEEL_H
+
+#include "scapi_basic_types.h"
+
+/*! \def UGW_TLIB_WHEEL_LEVELS
+    \brief 5 levels of 64 one millisecond slots reach 64^5 ms (~12 days),
+    longer timers wait in the last level and are re-filed on each pass
+*/
+#define UGW_TLIB_WHEEL_LEVELS 5
+#define UGW_TLIB_WHEEL_BITS 6
+#define UGW_TLIB_WHEEL_SLOTS (1 << UGW_TLIB_WHEEL_BITS)
+
+/*! \def UGW_TLIB_WHEEL_EXPIRED
+    \brief List of the timers due in the current pass, after the wheel slots
+*/
+#define UGW_TLIB_WHEEL_EXPIRED (UGW_TLIB_WHEEL_LEVELS * UGW_TLIB_WHEEL_SLOTS)
+#define UGW_TLIB_WHEEL_NO_SLOT 0xFFFF
+
+/*! \def UGW_TLIB_SLACK_DEFAULT
+    \brief Slack argument meaning the wheel's uiDefaultSlack
+*/
+#define UGW_TLIB_SLACK_DEFAULT 0xFFFFFFFF
+
+/*! \brief One timer, nodes are linked by index + 1, 0 ends a list */
+typedef struct {
+	uint64 ullDeadline;		/*!< requested expiry, wheel ticks */
+	uint64 ullExpiry;		/*!< filed expiry, ullDeadline moved later within the slack */
+	uint64 ullTimerValue;		/*!< timer value in us, the period of periodic timers */
+	uint32 uiSlack;			/*!< us the expiry may be delayed by to share a wakeup */
+	uint32 unPrev;
+	uint32 unNext;
+	uint16 unSlot;			/*!< list the node is on, UGW_TLIB_WHEEL_NO_SLOT if none */
+	uint8 ucFree;
+	uint8 ucTimerType;
+	void (*pfnCallBack)(void *);
+	void *pvCallBackParm;
+} x_UGW_TLIB_WheelNode;
+
+/*! \brief A timer set. Not locked, the owner serialises the calls */
+typedef struct {
+	x_UGW_TLIB_WheelNode *pxNodes;
+	uint32 unMaxNodes;
+	uint32 unFreeHead;
+	uint32 unFreeTail;
+	uint32 unActive;
+	uint64 ullNow;			/*!< last tick processed */
+	uint32 uiDefaultSlack;		/*!< slack of timers started with UGW_TLIB_SLACK_DEFAULT, us */
+	uint64 aullBitmap[UGW_TLIB_WHEEL_LEVELS];	/*!< non-empty slots per level */
+	uint32 aunSlotHead[UGW_TLIB_WHEEL_EXPIRED + 1];
+} x_UGW_TLIB_Wheel;
+
+/*! \brief Allocates unMaxNodes timers, ids 1 to unMaxNodes
+    \return UGW_TLIB_SUCCESS or UGW_TLIB_FAIL
+*/
+int8 UGW_TLIB_WheelInit(x_UGW_TLIB_Wheel *pxWheel, uint32 unMaxNodes);
+
+/*! \brief Frees the timers */
+void UGW_TLIB_WheelFree(x_UGW_TLIB_Wheel *pxWheel);
+
+/*! \brief Current time in wheel ticks, UGW_TLIB_GetMonoTimeNs() in milliseconds */
+uint64 UGW_TLIB_WheelTime(void);
+
+/*! \brief Takes a free timer and files it to expire ullTimerValue us from now,
+    or up to uiSlack us later when that lines it up with other timers
+    \return timer id or 0 when all timers are in use
+*/
+uint32 UGW_TLIB_WheelStart(x_UGW_TLIB_Wheel *pxWheel, uint64 ullTimerValue, uint32 uiSlack,
+		uint8 ucTimerType, void (*pfnCallBack)(void *), void *pvCallBackParm);
+
+/*! \brief Stops timer unTimerId and frees it
+    \return time left in us, 0 if it was due, -1 if the id is not running
+*/
+int64 UGW_TLIB_WheelStop(x_UGW_TLIB_Wheel *pxWheel, uint32 unTimerId);
+
+/*! \brief Moves the wheel to tick ullNow, the timers due are put on the expired list */
+void UGW_TLIB_WheelAdvance(x_UGW_TLIB_Wheel *pxWheel, uint64 ullNow);
+
+/*! \brief Takes the next timer off the expired list. One time timers are freed,
+    periodic ones re-filed; the callback is returned to be called by the owner
+    \return UGW_TLIB_SUCCESS or UGW_TLIB_FAIL when the list is empty
+*/
+int8 UGW_TLIB_WheelPopExpired(x_UGW_TLIB_Wheel *pxWheel, void (**ppfnCallBack)(void *),
+		void **ppvCallBackParm);
+
+/*! \brief Tick at which the wheel next has work, a cascade or an expiry
+    \return tick or 0 when no timer is running
+*/
+uint64 UGW_TLIB_WheelNextTick(const x_UGW_TLIB_Wheel *pxWheel);
+
+#endif
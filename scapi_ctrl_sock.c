@@ -0,0 +1,255 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_ctrl_sock.c                                          *
+ *     Project    : UGW                                                        *
+ *     Description: Per-thread cached control socket used by the interface,    *
+ *                  vlan and route ioctl APIs                                  *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+
+/* Control socket owned by one thread. unForkGen records the fork generation
+ * in which the socket was opened, so that a child never keeps using the
+ * descriptor it inherited from its parent. xDev/xIno identify the socket, the
+ * application may have closed the number and got it back for another file */
+typedef struct {
+	int nFd;
+	uint32_t unForkGen;
+	dev_t xDev;
+	ino_t xIno;
+} CtrlSock_t;
+
+static pthread_once_t xCtrlSockOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t xCtrlSockKey;
+static bool bCtrlSockKeyValid = false;
+static volatile uint32_t unCtrlSockForkGen = 0;
+static __thread CtrlSock_t xCtrlSock = { -1, 0, 0, 0 };
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockAtforkChild
+ **
+ **   Description      :pthread_atfork() child handler, invalidates every cached
+ **			socket of the parent by bumping the fork generation
+ **
+ ** ============================================================================
+ */
+static void scapi_ctrlSockAtforkChild(void)
+{
+	unCtrlSockForkGen++;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockIsOurs
+ **
+ **   Description      :Checks that the cached descriptor still refers to the
+ **			socket that was opened
+ **
+ **   Parameters       :pxSock(IN) -> cached socket
+ **
+ **   Return Value     :true when the descriptor is ours
+ **
+ ** ============================================================================
+ */
+static bool scapi_ctrlSockIsOurs(CtrlSock_t *pxSock)
+{
+	struct stat xSt;
+
+	return (pxSock->nFd >= 0 && fstat(pxSock->nFd, &xSt) == 0 && S_ISSOCK(xSt.st_mode) &&
+			xSt.st_dev == pxSock->xDev && xSt.st_ino == pxSock->xIno);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockDrop
+ **
+ **   Description      :Forgets the cached descriptor, closing it only when it
+ **			is still our socket
+ **
+ **   Parameters       :pxSock(IN) -> cached socket
+ **
+ ** ============================================================================
+ */
+static void scapi_ctrlSockDrop(CtrlSock_t *pxSock)
+{
+	if(scapi_ctrlSockIsOurs(pxSock))
+		close(pxSock->nFd);
+	pxSock->nFd = -1;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockThreadExit
+ **
+ **   Description      :Thread specific data destructor, closes the socket of
+ **			an exiting thread
+ **
+ **   Parameters       :pvArg(IN) -> CtrlSock_t of the exiting thread
+ **
+ ** ============================================================================
+ */
+static void scapi_ctrlSockThreadExit(void *pvArg)
+{
+	CtrlSock_t *pxSock = pvArg;
+
+	if(pxSock != NULL)
+		scapi_ctrlSockDrop(pxSock);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockInit
+ **
+ **   Description      :One time initialisation of the thread key and fork hook
+ **
+ ** ============================================================================
+ */
+static void scapi_ctrlSockInit(void)
+{
+	if(pthread_key_create(&xCtrlSockKey, scapi_ctrlSockThreadExit) == 0)
+		bCtrlSockKeyValid = true;
+	pthread_atfork(NULL, NULL, scapi_ctrlSockAtforkChild);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockGet
+ **
+ **   Description      :Returns the control socket of the calling thread, opening
+ **			it on first use or after a fork
+ **
+ **   Parameters       :bReopen(IN) -> drop the cached descriptor and open a new one
+ **
+ **   Return Value     :Success -> socket descriptor
+ **			Failure -> Different -ve values
+ **
+ **   Notes            :A cached descriptor that no longer refers to our socket
+ **			is dropped without being closed, it belongs to the application
+ **
+ ** ============================================================================
+ */
+static int scapi_ctrlSockGet(bool bReopen)
+{
+	struct stat xSt;
+	int nErr = 0, nRet = -EXIT_FAILURE;
+
+	pthread_once(&xCtrlSockOnce, scapi_ctrlSockInit);
+
+	/* A copy inherited from the parent process is ours to close */
+	if(xCtrlSock.nFd >= 0 && (bReopen || xCtrlSock.unForkGen != unCtrlSockForkGen ||
+				!scapi_ctrlSockIsOurs(&xCtrlSock)))
+		scapi_ctrlSockDrop(&xCtrlSock);
+
+	if(xCtrlSock.nFd < 0)
+	{
+		nRet = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+		if(nRet < 0)
+		{
+			nRet = -errno;
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		if(fstat(nRet, &xSt) < 0)
+		{
+			nErr = errno;
+			close(nRet);
+			nRet = -nErr;
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		xCtrlSock.nFd = nRet;
+		xCtrlSock.xDev = xSt.st_dev;
+		xCtrlSock.xIno = xSt.st_ino;
+		xCtrlSock.unForkGen = unCtrlSockForkGen;
+		if(bCtrlSockKeyValid)
+			pthread_setspecific(xCtrlSockKey, &xCtrlSock);
+	}
+	nRet = xCtrlSock.nFd;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockIoctl
+ **
+ **   Description      :Issues an interface/vlan/route ioctl on the control
+ **			socket of the calling thread
+ **
+ **   Parameters       :ulRequest(IN) -> ioctl request code
+ **			pvArg(INOUT) -> ioctl argument (struct ifreq, rtentry...)
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -errno of the failing call
+ **
+ **   Notes            :If the application closed our descriptor behind our back
+ **			the request is retried once on a new socket. Other errors,
+ **			ENOTTY for an unsupported request included, are returned
+ **
+ ** ============================================================================
+ */
+int scapi_ctrlSockIoctl(unsigned long ulRequest, void *pvArg)
+{
+	int nSkfd = -1, nRet = -EXIT_FAILURE;
+
+	nSkfd = scapi_ctrlSockGet(false);
+	if(nSkfd < 0)
+	{
+		nRet = nSkfd;
+		goto returnHandler;
+	}
+	if(ioctl(nSkfd, ulRequest, pvArg) == 0)
+	{
+		nRet = EXIT_SUCCESS;
+		goto returnHandler;
+	}
+	nRet = -errno;
+	if(nRet != -EBADF && nRet != -ENOTSOCK)
+		goto returnHandler;
+
+	nSkfd = scapi_ctrlSockGet(true);
+	if(nSkfd < 0)
+	{
+		nRet = nSkfd;
+		goto returnHandler;
+	}
+	nRet = (ioctl(nSkfd, ulRequest, pvArg) == 0) ? EXIT_SUCCESS : -errno;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ctrlSockClose
+ **
+ **   Description      :Closes the control socket of the calling thread. The next
+ **			ioctl API call opens a new one
+ **
+ ** ============================================================================
+ */
+void scapi_ctrlSockClose(void)
+{
+	scapi_ctrlSockDrop(&xCtrlSock);
+}
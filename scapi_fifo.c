@@ -17,6 +17,9 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
 #include "scapi_basic_types.h"
 #include "scapi_fifo.h"
 
@@ -35,21 +38,29 @@ char8 UGW_IPC_SendMsg(IN int32 iFd,	/* FIFO fd */
 				IN uint16 unMsgSize,	/* Size of message */
 				IN uint32 uiReserved, IN char8 * pcMsg)
 {				/* Pointer to message */
-	x_UGW_IPC_Msg xMsg;
-	memset(&xMsg, 0, sizeof(x_UGW_IPC_Msg));
+	x_UGW_IPC_MsgHdr xHdr;
+	struct iovec axIov[2];
+	int32 iIovCnt = 1;
 
 	if (unMsgSize > UGW_IPC_MAX_MSG_SIZE)
 		return UGW_IPC_FAIL;
 
-	xMsg.xHdr.ucFrom = ucFrom;
-	xMsg.xHdr.ucTo = ucTo;
-	xMsg.xHdr.unMsgSize = unMsgSize;
-	xMsg.xHdr.uiReserved = uiReserved;
+	xHdr.ucFrom = ucFrom;
+	xHdr.ucTo = ucTo;
+	xHdr.unMsgSize = unMsgSize;
+	xHdr.uiReserved = uiReserved;
 
-	memcpy_s(xMsg.acMsg, unMsgSize, pcMsg, unMsgSize);
+	/* Header and payload go out in one write straight from the caller's
+	   buffer, up to PIPE_BUF bytes it is atomic like a single write() */
+	axIov[0].iov_base = &xHdr;
+	axIov[0].iov_len = UGW_IPC_HDR_SIZE;
+	if (unMsgSize > 0) {
+		axIov[1].iov_base = pcMsg;
+		axIov[1].iov_len = unMsgSize;
+		iIovCnt = 2;
+	}
 
-	if (UGW_OS_WriteFifo(iFd, (char8 *) & xMsg,
-			     unMsgSize + UGW_IPC_HDR_SIZE) < 0) {
+	if (UGW_OS_WriteFifoV(iFd, axIov, iIovCnt) < 0) {
 		/* Error Writing Message to the FIFO */
 		/* Add Debugs if required */
 		return UGW_IPC_FAIL;
@@ -58,6 +69,65 @@ char8 UGW_IPC_SendMsg(IN int32 iFd,	/* FIFO fd */
 	return UGW_IPC_SUCCESS;
 }
 
+/* 
+** =============================================================================
+**   Function Name    : UGW_IPC_SendMsgBatch 
+**   Description      : To send several messages in IPC with few writes 
+**   Return Value     : Success -> UGW_IPC_SUCCESS 
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+char8
+UGW_IPC_SendMsgBatch(IN int32 iFd,
+		     IN x_UGW_IPC_MsgDesc * pxMsgs,
+		     IN uint32 uiCount, OUT uint32 * puiSent)
+{
+	struct iovec axIov[UGW_IPC_BATCH_IOV];
+	uint32 uiFirst = 0, uiLast, uiLen, uiMsgLen;
+	int32 iIovCnt;
+	ssize_t nBytes;
+
+	*puiSent = 0;
+	while (uiFirst < uiCount) {
+		/* Gather messages while the write stays within PIPE_BUF, so
+		   it is atomic and never interleaves with other writers. A
+		   message longer than that is written on its own, no more
+		   atomic than with UGW_IPC_SendMsg */
+		uiLen = 0;
+		iIovCnt = 0;
+		for (uiLast = uiFirst; uiLast < uiCount; uiLast++) {
+			if (pxMsgs[uiLast].xHdr.unMsgSize > UGW_IPC_MAX_MSG_SIZE)
+				break;
+			uiMsgLen = UGW_IPC_HDR_SIZE + pxMsgs[uiLast].xHdr.unMsgSize;
+			if (uiLast > uiFirst && (uiLen + uiMsgLen > PIPE_BUF ||
+						 iIovCnt + 2 > UGW_IPC_BATCH_IOV))
+				break;
+			axIov[iIovCnt].iov_base = &pxMsgs[uiLast].xHdr;
+			axIov[iIovCnt++].iov_len = UGW_IPC_HDR_SIZE;
+			if (pxMsgs[uiLast].xHdr.unMsgSize > 0) {
+				axIov[iIovCnt].iov_base = pxMsgs[uiLast].pcMsg;
+				axIov[iIovCnt++].iov_len = pxMsgs[uiLast].xHdr.unMsgSize;
+			}
+			uiLen += uiMsgLen;
+		}
+		if (uiLast == uiFirst) {
+			/* Oversized message */
+			return UGW_IPC_FAIL;
+		}
+
+		nBytes = UGW_OS_WriteFifoV(iFd, axIov, iIovCnt);
+		if (nBytes < 0 || (uint32) nBytes != uiLen) {
+			/* Error Writing Message to the FIFO, or a short write
+			   of a message above PIPE_BUF on a non-blocking fd */
+			return UGW_IPC_FAIL;
+		}
+		uiFirst = uiLast;
+		*puiSent = uiFirst;
+	}
+
+	return UGW_IPC_SUCCESS;
+}
+
 /* 
 ** =============================================================================
 **   Function Name    : UGW_IPC_RecvMsg 
@@ -106,3 +176,93 @@ UGW_IPC_RecvMsg(IN int32 iFd,
 	pcMsg[*punMsgSize] = '\0';
 	return UGW_IPC_SUCCESS;
 }
+
+/* 
+** =============================================================================
+**   Function Name    : UGW_IPC_ReaderInit 
+**   Description      : To set up buffered receive of IPC messages 
+**   Return Value     : None
+** ===========================================================================*/
+
+void UGW_IPC_ReaderInit(IN x_UGW_IPC_Reader * pxReader, IN int32 iFd)
+{
+	pxReader->iFd = iFd;
+	pxReader->uiHead = 0;
+	pxReader->uiTail = 0;
+}
+
+/* 
+** =============================================================================
+**   Function Name    : UGW_IPC_ReaderHasMsg 
+**   Description      : To check whether a whole message is buffered 
+**   Return Value     : 1 if UGW_IPC_ReaderNext returns without reading, else 0
+** ===========================================================================*/
+
+uint32 UGW_IPC_ReaderHasMsg(IN x_UGW_IPC_Reader * pxReader)
+{
+	x_UGW_IPC_MsgHdr xHdr;
+	uint32 uiAvail = pxReader->uiTail - pxReader->uiHead;
+
+	if (uiAvail < UGW_IPC_HDR_SIZE)
+		return 0;
+	/* The header is not aligned within the buffer, copy it out */
+	memcpy(&xHdr, pxReader->acBuf + pxReader->uiHead, UGW_IPC_HDR_SIZE);
+	if (xHdr.unMsgSize > UGW_IPC_MAX_MSG_SIZE)
+		return 1;	/* UGW_IPC_ReaderNext reports it */
+	return (uiAvail >= UGW_IPC_HDR_SIZE + xHdr.unMsgSize);
+}
+
+/* 
+** =============================================================================
+**   Function Name    : UGW_IPC_ReaderNext 
+**   Description      : To receive message in IPC through a reader 
+**   Return Value     : Success -> UGW_IPC_SUCCESS 
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+char8
+UGW_IPC_ReaderNext(IN x_UGW_IPC_Reader * pxReader,
+		   OUT x_UGW_IPC_MsgHdr ** ppxHdr,
+		   OUT char8 ** ppcMsg, OUT char8 * pErr)
+{
+	uint32 uiAvail;
+	ssize_t nBytes;
+
+	*pErr = UGW_IPC_NO_ERR;
+	while (!UGW_IPC_ReaderHasMsg(pxReader)) {
+		/* Move the partial message to the front, then read as much
+		   as the FIFO holds: one read for any number of messages */
+		uiAvail = pxReader->uiTail - pxReader->uiHead;
+		if (pxReader->uiHead > 0) {
+			memmove(pxReader->acBuf, pxReader->acBuf + pxReader->uiHead, uiAvail);
+			pxReader->uiHead = 0;
+			pxReader->uiTail = uiAvail;
+		}
+		nBytes = UGW_OS_ReadFifo(pxReader->iFd,
+					 pxReader->acBuf + pxReader->uiTail,
+					 sizeof(pxReader->acBuf) - pxReader->uiTail);
+		if (nBytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			/* Non-blocking FIFO drained, not an error */
+			return UGW_IPC_FAIL;
+		}
+		if (nBytes <= 0) {
+			/* Error Reading, or every writer closed the FIFO */
+			*pErr = UGW_IPC_FIFO_READ_ERR;
+			return UGW_IPC_FAIL;
+		}
+		pxReader->uiTail += nBytes;
+	}
+
+	memcpy(&pxReader->xHdr, pxReader->acBuf + pxReader->uiHead, UGW_IPC_HDR_SIZE);
+	if (pxReader->xHdr.unMsgSize > UGW_IPC_MAX_MSG_SIZE) {
+		/* Framing is lost, drop what is buffered */
+		pxReader->uiHead = 0;
+		pxReader->uiTail = 0;
+		*pErr = UGW_IPC_HDR_ERR;
+		return UGW_IPC_FAIL;
+	}
+	*ppxHdr = &pxReader->xHdr;
+	*ppcMsg = pxReader->acBuf + pxReader->uiHead + UGW_IPC_HDR_SIZE;
+	pxReader->uiHead += UGW_IPC_HDR_SIZE + pxReader->xHdr.unMsgSize;
+	return UGW_IPC_SUCCESS;
+}
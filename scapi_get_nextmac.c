@@ -33,12 +33,14 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <pthread.h>
 #include <net/if_arp.h>
-#include <glob.h>
 #include <ulogging.h>
 #include <ltq_api_include.h>
 #include <regex.h>
 #include <scapi_structs.h>
+#include <scapi_nextmac_store.h>
 
 #define SNPRINTF_GET_MAC(pDest, nBufSize, psFormat, ...) { \
         if((sprintf_s(pDest, nBufSize, psFormat, ##__VA_ARGS__)) <0 ) { \
@@ -59,10 +61,7 @@
 #define EDQUOTA   122
 
 #define SCAPI_MAC_LEN 32
-#define NEXT_MAC_CONF VENDOR_PATH "/servd/etc/nextmac.conf"
-#define NEXT_MAC_6g_CONF VENDOR_PATH "/servd/etc/nextmac-6g.conf"
 #define BOOT_CHK "/tmp/.bootchk"
-#define GLOB_INTERFACES "/sys/class/net/*/address"
 #define MAC_IN_USE 422
 #define MAX_CNT 1000
 
@@ -228,329 +227,233 @@ returnHandler:
 
 /* 
  ** =============================================================================
- **   Function Name    :scapi_get6gMacFromFile
+ **   Function Name    :scapi_getMacFromStore
  **
- **   Description      :gets mac address of an interface from config file(NEXT_MAC_CONFIG)
+ **   Description      :gets mac address of an interface from the config file
+ **			store, exact interface name match
  **
- **   Parameters       :pcMac(OUT) -> Pointer to a buffer which will hold the mac
- **                                     address returned by this API
+ **   Parameters       :pxStore(IN) -> opened config file store
  **			pcIfname(IN) -> Interface name
+ **			pcMac(OUT) -> Pointer to a buffer which will hold the mac
+ **                                     address returned by this API
  **
  **   Return Value     :Success -> EXIT_SUCCESS
  **                      Failure -> Different -ve values 
  ** ============================================================================
  */
-static int scapi_get6gMacFromFile(char* pcIfname,char* pcMac){
-	FILE *fp = scapi_getFilePtr(NEXT_MAC_6g_CONF, "ab+");
-	char line[64] = {0};
-	size_t len=0;
-	char* saveptr = NULL;
-	char* token = NULL;
-	char* pos = NULL;
-	char* pcFind = NULL;
-	bool got_mac = false;
-
-	char interfaceName[SCAPI_MAC_LEN] = {0};
-
+static int scapi_getMacFromStore(const NextMacStore_t *pxStore, char* pcIfname, char* pcMac){
+	const NextMacRec_t *pxRec = scapi_nmStoreFind(pxStore, pcIfname);
 	int nRet = -EXIT_FAILURE;
 
-	if(fp == NULL){
-		LOGF_LOG_ERROR("Couldn't open Mac Config File %d (%s)\n", nRet, strerror(errno));
-		goto returnHandler;
-	}
-	SNPRINTF_GET_MAC(interfaceName, SCAPI_MAC_LEN, "%s>", pcIfname);
-	while (fgets(line, sizeof(line), fp)) {
-		if ((pos=strchr(line, '\n')) != NULL)
-			*pos = '\0';
-
-		pcFind = strstr(line, interfaceName);
-		/* Interface found */
-		if( pcFind != NULL){
-			/* strtok_s is used so that we don't have to trim
-			 * extra white spaces. We have to do it manually
-			 * with strchr*/
-			if((len=strnlen_s(pcFind,MAC_IN_USE))<=0){
-				LOGF_LOG_ERROR("Fetchig len failed\n");
-				nRet = ERR_INPUT_VALIDATION_FAILED;
-				goto returnHandler;
-			}
-			token = strtok_s(pcFind, &len, "> ", &saveptr);
-			/* This is our mac address */
-			token = strtok_s(NULL, &len , "> ", &saveptr);
-			if (token == NULL){
-				nRet = ERR_INPUT_VALIDATION_FAILED;
-				fprintf(stderr, "[%s:%d]Paring Mac config string Failed\n",__func__,__LINE__);
-				goto returnHandler;
-			}
-			else{
-				got_mac = true;
-				SNPRINTF_GET_MAC(pcMac, SCAPI_MAC_LEN, "%s", token);
-			}
-			break;
-		}
-
-	}
-
 	/* We parsed whole file but could not retreive mac address of
-	   the interface */
-	if(got_mac != true){
+	 * the interface */
+	if(pxRec == NULL){
 		nRet = -EXIT_FAILURE;
 		LOGF_LOG_INFO("Failed to get Mac for the interface %s from file, generate new mac. \n", pcIfname);
 		goto returnHandler;
 	}
+	SNPRINTF_GET_MAC(pcMac, SCAPI_MAC_LEN, "%s", pxRec->sMac);
 
 	nRet = EXIT_SUCCESS;
 	LOGF_LOG_INFO("Mac <-> Iface - [ %s ] [ %s ]\n",pcIfname, pcMac);
 returnHandler:
-	if(fp != NULL)
-		fclose(fp);
 	return nRet;
 }
-/* 
+
+/* Set of mac addresses in use, open addressing over the 48 bit value.
+ * Slots hold mac + 1 so that 0 marks an empty slot */
+typedef struct {
+	uint64_t *pullSlots;
+	uint32_t unMask;
+	uint32_t unCnt;
+} MacSet_t;
+
+/*
  ** =============================================================================
- **   Function Name    :scapi_getMacFromFile
+ **   Function Name    :scapi_macToU64
  **
- **   Description      :gets mac address of an interface from config file(NEXT_MAC_CONFIG)
- **
- **   Parameters       :pcMac(OUT) -> Pointer to a buffer which will hold the mac
- **                                     address returned by this API
- **			pcIfname(IN) -> Interface name
+ **   Description      :Converts a "xx:xx:xx:xx:xx:xx" mac to its 48 bit value
  **
  **   Return Value     :Success -> EXIT_SUCCESS
- **                      Failure -> Different -ve values 
+ **                      Failure -> -EINVAL
+ **
  ** ============================================================================
  */
-static int scapi_getMacFromFile(char* pcIfname,char* pcMac){
-	FILE *fp = scapi_getFilePtr(NEXT_MAC_CONF, "ab+");
-	char line[64] = {0};
-	size_t len=0;
+static int scapi_macToU64(const char *pcMac, uint64_t *pullMac)
+{
+	unsigned char aucMac[MAC_ADDR_BYTES] = {0};
+	int i = 0;
+
+	if(sscanf_s(pcMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &aucMac[0], &aucMac[1],
+				&aucMac[2], &aucMac[3], &aucMac[4], &aucMac[5]) != MAC_ADDR_BYTES)
+		return -EINVAL;
+	*pullMac = 0;
+	for(i = 0; i < MAC_ADDR_BYTES; i++)
+		*pullMac = (*pullMac << 8) | aucMac[i];
+	return EXIT_SUCCESS;
+}
 
-	char* saveptr = NULL;
-	char* token = NULL;
-	bool got_mac = false;
+static uint32_t scapi_macSetSlot(const MacSet_t *pxSet, uint64_t ullKey)
+{
+	return (uint32_t)((ullKey * 0x9E3779B97F4A7C15ULL) >> 32) & pxSet->unMask;
+}
 
-	char interfaceName[SCAPI_MAC_LEN] = {0};
+static bool scapi_macSetHas(const MacSet_t *pxSet, uint64_t ullMac)
+{
+	uint32_t unSlot = 0;
+
+	if(pxSet->pullSlots == NULL)
+		return false;
+	for(unSlot = scapi_macSetSlot(pxSet, ullMac + 1); pxSet->pullSlots[unSlot] != 0; unSlot = (unSlot + 1) & pxSet->unMask)
+		if(pxSet->pullSlots[unSlot] == ullMac + 1)
+			return true;
+	return false;
+}
 
-	int nRet = -EXIT_FAILURE;
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_macSetAdd
+ **
+ **   Description      :Adds a mac to the set, growing it at half load
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> -ENOMEM
+ **
+ ** ============================================================================
+ */
+static int scapi_macSetAdd(MacSet_t *pxSet, uint64_t ullMac)
+{
+	MacSet_t xNew = {0};
+	uint32_t unSlot = 0, i = 0;
 
-	if(fp == NULL){
-		LOGF_LOG_ERROR("Couldn't open Mac Config File %d (%s)\n", nRet, strerror(errno));
-		goto returnHandler;
-	}
-	/* or else 'eth0' will match with eth0_1 during strstr */
-	SNPRINTF_GET_MAC(interfaceName, SCAPI_MAC_LEN, "%s>", pcIfname);
-	while (fgets(line, sizeof(line), fp)) {
-		char *pos;
-		if ((pos=strchr(line, '\n')) != NULL)
-			*pos = '\0';
-
-		char* pcFind = strstr(line, interfaceName);
-		/* Interface found */
-		if( pcFind != NULL){
-			/* strtok_s is used so that we don't have to trim
-			 * extra white spaces. We have to do it manually
-			 * with strchr*/
-			if((len=strnlen_s(pcFind,MAC_IN_USE))<=0){
-				LOGF_LOG_ERROR("Fetchig len failed\n");
-				nRet = ERR_INPUT_VALIDATION_FAILED;
-				goto returnHandler;
-			}
-			token = strtok_s(pcFind, &len, "> ", &saveptr);
-			/* This is our mac address */
-			token = strtok_s(NULL, &len , "> ", &saveptr);
-			if (token == NULL){
-				nRet = ERR_INPUT_VALIDATION_FAILED;
-				fprintf(stderr, "[%s:%d]Paring Mac config string Failed\n",__func__,__LINE__);
-				goto returnHandler;
-			}
-			else{
-				got_mac = true;
-				SNPRINTF_GET_MAC(pcMac, SCAPI_MAC_LEN, "%s", token);
-			}
-			break;
+	if(scapi_macSetHas(pxSet, ullMac))
+		return EXIT_SUCCESS;
+	if(pxSet->pullSlots == NULL || (pxSet->unCnt + 1) * 2 > pxSet->unMask + 1)
+	{
+		xNew.unMask = pxSet->pullSlots ? pxSet->unMask * 2 + 1 : 63;
+		xNew.pullSlots = calloc(xNew.unMask + 1, sizeof(uint64_t));
+		if(xNew.pullSlots == NULL)
+			return -ENOMEM;
+		for(i = 0; pxSet->pullSlots != NULL && i <= pxSet->unMask; i++)
+		{
+			if(pxSet->pullSlots[i] == 0)
+				continue;
+			for(unSlot = scapi_macSetSlot(&xNew, pxSet->pullSlots[i]); xNew.pullSlots[unSlot] != 0; unSlot = (unSlot + 1) & xNew.unMask)
+				;
+			xNew.pullSlots[unSlot] = pxSet->pullSlots[i];
 		}
+		xNew.unCnt = pxSet->unCnt;
+		free(pxSet->pullSlots);
+		*pxSet = xNew;
+	}
+	for(unSlot = scapi_macSetSlot(pxSet, ullMac + 1); pxSet->pullSlots[unSlot] != 0; unSlot = (unSlot + 1) & pxSet->unMask)
+		;
+	pxSet->pullSlots[unSlot] = ullMac + 1;
+	pxSet->unCnt++;
+	return EXIT_SUCCESS;
+}
 
-	}
-
-	/* We parsed whole file but could not retreive mac address of
-	 * the interface */
-	if(got_mac != true){
-		nRet = -EXIT_FAILURE;
-		LOGF_LOG_INFO("Failed to get Mac for the interface %s from file, generate new mac. \n", pcIfname);
-		goto returnHandler;
-	}
-
-	nRet = EXIT_SUCCESS;
-	LOGF_LOG_INFO("Mac <-> Iface - [ %s ] [ %s ]\n",pcIfname, pcMac);
-returnHandler:
-	if(fp != NULL)
-		fclose(fp);
-	return nRet;
+static void scapi_macSetFree(MacSet_t *pxSet)
+{
+	free(pxSet->pullSlots);
+	memset(pxSet, 0, sizeof(*pxSet));
 }
 
 /* 
  ** =============================================================================
- **   Function Name    :scapi_validate6gMacaddr
+ **   Function Name    :scapi_loadUsedMacs
  **
- **   Description      :Validates a given mac address (incremented) with the mac
- **			addresses of other interfaces in the system as well as
- **			with the interfaces (which might be not added to the system yet)
- **			in the config file
+ **   Description      :Collects the mac addresses in use, once per allocation:
+ **			the ones assigned in the config file (interfaces which
+ **			might be not added to the system yet) and, optionally,
+ **			the ones of the interfaces in the system
  **
- **   Parameters       :pcMac(IN) -> Mac address to be validated
- **                     pcIfName(IN) -> Interface name
+ **   Parameters       :pxUsed(OUT) -> set of macs in use
+ **			pxStore(IN) -> opened config file store
+ **			ppcIfnames(IN) -> interface names being allocated, their
+ **			current mac is not taken as in use because it might be
+ **			garbage when the interface is just up
+ **			nCount(IN) -> number of interface names
+ **			bSystem(IN) -> add the macs of the system interfaces
  **
  **   Return Value     :Success -> EXIT_SUCCESS
  **                      Failure -> Different -ve values
  **
- **   NOTES            :Doesn't validate with mac of pcIfname because it might be garbage
- **			When the interface is just up 
  ** ============================================================================
  */
-static int scapi_validate6gMacaddr(char* pcIfname, char* pcMac){
-	int nRet = -EXIT_FAILURE;
-	FILE *fp = scapi_getFilePtr(NEXT_MAC_6g_CONF, "r");
-	char line[128] = {0};
+static int scapi_loadUsedMacs(MacSet_t *pxUsed, const NextMacStore_t *pxStore, char **ppcIfnames, int nCount,
+		bool bSystem)
+{
+	IfcSnapshot_t *pxSnap = NULL;
+	uint64_t ullMac = 0;
+	int i = 0, j = 0, nSnapCnt = 0, nRet = -EXIT_FAILURE;
 
-	UNUSED(pcIfname);
-	if(fp == NULL){
-		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
-		LOGF_LOG_ERROR("Couldn't open interfaces config File : %s \n", NEXT_MAC_CONF);
-		goto returnHandler;
+	/* macs assigned in the config file */
+	for(i = 0; i < pxStore->nCnt; i++)
+	{
+		if(scapi_macToU64(pxStore->pxRecs[i].sMac, &ullMac) == EXIT_SUCCESS && (nRet = scapi_macSetAdd(pxUsed, ullMac)) < 0)
+			goto returnHandler;
 	}
 
-	/* Validate with interfaces in config file now. Some interfaces
-	   might be added to the config but not to the system */
-	while (fgets(line, sizeof(line), fp)) {
-		char *pos;
-		if ((pos=strchr(line, '\n')) != NULL)
-			*pos = '\0';
-		char* pcFind = strstr(line, pcMac);
-		/* This mac is already in use for some other interface*/
-		if( pcFind != NULL){
-			nRet = -MAC_IN_USE;
-			LOGF_LOG_ERROR("Mac [ %s ] is been already used by other interface\n", pcMac);
+	if(bSystem)
+	{
+		if((nRet = scapi_getIfcSnapshot(&pxSnap, &nSnapCnt)) < 0)
+		{
+			nRet = ERR_MACADDRESS_GLOB_FETCH_FAILED;
+			LOGF_LOG_ERROR("Failed to get the mac addresses of the system interfaces\n");
 			goto returnHandler;
 		}
-
+		for(i = 0; i < nSnapCnt; i++)
+		{
+			/* Validate against all other interfaces except the requested ones */
+			for(j = 0; j < nCount; j++)
+				if(strcmp(ppcIfnames[j], pxSnap[i].sIfname) == 0)
+					break;
+			if(j < nCount)
+				continue;
+			if(scapi_macToU64(pxSnap[i].sMac, &ullMac) == EXIT_SUCCESS && (nRet = scapi_macSetAdd(pxUsed, ullMac)) < 0)
+				goto returnHandler;
+		}
 	}
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	//globfree(&results);
-	if(fp != NULL)
-		fclose(fp);
+	free(pxSnap);
 	return nRet;
 }
+
 /* 
  ** =============================================================================
  **   Function Name    :scapi_validateMacaddr
  **
  **   Description      :Validates a given mac address (incremented) with the mac
- **			addresses of other interfaces in the system as well as
- **			with the interfaces (which might be not added to the system yet)
- **			in the config file
+ **			addresses in use, loaded by scapi_loadUsedMacs()
  **
- **   Parameters       :pcMac(IN) -> Mac address to be validated
- **                     pcIfName(IN) -> Interface name
+ **   Parameters       :pxUsed(IN) -> set of macs in use
+ **                     pcMac(IN) -> Mac address to be validated
  **
  **   Return Value     :Success -> EXIT_SUCCESS
  **                      Failure -> Different -ve values
  **
- **   NOTES            :Doesn't validate with mac of pcIfname because it might be garbage
- **			When the interface is just up 
  ** ============================================================================
  */
-static int scapi_validateMacaddr(char* pcIfname, char* pcMac){
-	int nRet = -EXIT_FAILURE;
-	FILE *fp = scapi_getFilePtr(NEXT_MAC_CONF, "r");
-	char ifcStr[64] = {0};
-	glob_t results = {0};
-	char line[128] = {0};
+static int scapi_validateMacaddr(const MacSet_t *pxUsed, char* pcMac){
+	uint64_t ullMac = 0;
 
-
-	if(fp == NULL){
-		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
-		LOGF_LOG_ERROR("Couldn't open interfaces config File : %s \n", NEXT_MAC_CONF);
-		goto returnHandler;
-	}
-
-	nRet = glob(GLOB_INTERFACES, 0, NULL, &results);
-
-	if(nRet != 0){
-		nRet = ERR_MACADDRESS_GLOB_FETCH_FAILED;
-		fprintf(stderr,"Glob fetch failed ret=%d , reason=%s\n", nRet, strerror(errno));
-		goto returnHandler;
+	if(scapi_macToU64(pcMac, &ullMac) != EXIT_SUCCESS)
+		return ERR_INPUT_VALIDATION_FAILED;
+	/* This mac is already in use for some other interface*/
+	if(scapi_macSetHas(pxUsed, ullMac)){
+		LOGF_LOG_INFO("MAC address in use, Mac should be incremented further\n");
+		return -MAC_IN_USE;
 	}
-
-	unsigned int i = 0;
-	/* Validate the mac with interfaces in the system */
-	/* Loop through all interfaces interfaces in the system and
-	 * validate*/
-	for (i = 0; i < results.gl_pathc; i++){
-		SNPRINTF_GET_MAC(ifcStr, 64, "%s", results.gl_pathv[i]);
-		char* pcCurrentIfName = strrchr(ifcStr, '/');
-		if(pcCurrentIfName == NULL){
-			nRet = ERR_INPUT_VALIDATION_FAILED;
-			fprintf(stderr,"[%s:%d] Couldn't get interface name\n",__func__, __LINE__);
-			goto returnHandler;
-		}
-		*pcCurrentIfName = '\0';
-		pcCurrentIfName = strrchr(ifcStr, '/');
-		pcCurrentIfName++;
-		/* Validate against all other interfaces except pcIfname*/
-		if(strcmp(pcIfname, pcCurrentIfName) != 0){
-			char pcMacIfc[SCAPI_MAC_LEN] = {0};
-			nRet = scapi_getIfcMacaddr(pcCurrentIfName, pcMacIfc);
-			if( nRet < 0){
-				if ( (-nRet) == ENODEV ) {
-					nRet = 0;
-					LOGF_LOG_ERROR("Failed to get Mac Address for [ %s ],No such device\n", pcCurrentIfName);
-					continue;
-				} else {
-					nRet = ERR_MACADDRESS_INTERFACE_NOT_UP;
-					LOGF_LOG_ERROR("Failed to get Mac Address for [ %s ]\n", pcCurrentIfName);
-					goto returnHandler;
-				}
-			}
-			//printf("Interface = %s, IfcMac = %s, MacTest = %s\n", pcCurrentIfName, pcMacIfc, pcMac);
-			/* If a match is found. Current mac is invalid*/
-			if( strcmp(pcMac, pcMacIfc) == 0){
-				nRet = -MAC_IN_USE;
-				LOGF_LOG_INFO("MAC address in use, Mac should be incremented further\n");
-				goto returnHandler;
-			}
-		}
-	}
-
-	/* Validate with interfaces in config file now. Some interfaces
-	   might be added to the config but not to the system */
-	while (fgets(line, sizeof(line), fp)) {
-		char *pos;
-		if ((pos=strchr(line, '\n')) != NULL)
-			*pos = '\0';
-		//printf("Line = %s, MacTest = %s\n", line, pcMac);
-		char* pcFind = strstr(line, pcMac);
-		/* This mac is already in use for some other interface*/
-		if( pcFind != NULL){
-			nRet = -MAC_IN_USE;
-			LOGF_LOG_ERROR("Mac [ %s ] is been already used by other interface\n", pcMac);
-			goto returnHandler;
-		}
-
-	}
-	nRet = EXIT_SUCCESS;
-returnHandler:
-	globfree(&results);
-	if(fp != NULL)
-		fclose(fp);
-	return nRet;
+	return EXIT_SUCCESS;
 }
 
 /* 
  ** =============================================================================
- **   Function Name    :scapi_getBaseMac
+ **   Function Name    :scapi_readBaseMac
  **
- **   Description      :Gets base mac from /proc/cmdline.
+ **   Description      :Reads base mac from /proc/cmdline (or the nvram env).
  **
  **   Parameters       :pcMac(OUT) -> Pointer to a buffer which will hold the mac
  **					address returned by this API
@@ -560,7 +463,7 @@ returnHandler:
  ** ============================================================================
  */
 
-int scapi_getBaseMac(char* pcMac){
+static int scapi_readBaseMac(char* pcMac){
 	FILE* fpProc = NULL;
 	char fbuf[512] = {0};
 	//char proc_mac_addr[SCAPI_MAC_LEN] = {0};
@@ -624,6 +527,192 @@ returnHandler:
 	return nRet;
 }
 
+/* Caches shared between processes live beside the conf files, in a
+ * directory only root writes, never in the world writable /tmp */
+#define SCAPI_CACHE_PATH_LEN 256
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_cacheOpen
+ **
+ **   Description      :Opens a cache file for reading, only when it is a
+ **			regular file written by root or by us and nobody else
+ **			can write it
+ **
+ **   Return Value     :Success -> descriptor
+ **                      Failure -> -errno, -EPERM for a file not trusted
+ **
+ ** ============================================================================
+ */
+static int scapi_cacheOpen(const char *pcPath)
+{
+	struct stat st;
+	int nFd = -1;
+
+	if((nFd = open(pcPath, O_RDONLY | O_NOFOLLOW | O_CLOEXEC)) < 0)
+		return -errno;
+	if(fstat(nFd, &st) != 0 || !S_ISREG(st.st_mode) ||
+			(st.st_uid != 0 && st.st_uid != geteuid()) || (st.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+	{
+		LOGF_LOG_ERROR("Ignoring cache %s, not a private file\n", pcPath);
+		close(nFd);
+		return -EPERM;
+	}
+	return nFd;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_cacheCreate
+ **
+ **   Description      :Creates the new file that replaces a cache once written,
+ **			a fresh name beside it, never an existing file or link
+ **
+ **   Parameters       :pcPath(IN) -> cache file
+ **			pcTmp(OUT) -> SCAPI_CACHE_PATH_LEN bytes, name to rename
+ **					over pcPath or unlink
+ **
+ **   Return Value     :Success -> descriptor
+ **                      Failure -> -errno
+ **
+ ** ============================================================================
+ */
+static int scapi_cacheCreate(const char *pcPath, char *pcTmp)
+{
+	int nFd = -1, nRet = -EXIT_FAILURE;
+
+	if(sprintf_s(pcTmp, SCAPI_CACHE_PATH_LEN, "%s.XXXXXX", pcPath) < 0)
+		return -EINVAL;
+	/* O_EXCL with mode 0600 */
+	if((nFd = mkostemp(pcTmp, O_CLOEXEC)) < 0)
+		return -errno;
+	if(fchmod(nFd, 0644) != 0)
+	{
+		nRet = -errno;
+		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+		close(nFd);
+		unlink(pcTmp);
+		return nRet;
+	}
+	return nFd;
+}
+
+/* Base mac never changes within a boot: kept once per process, and across
+ * processes in a file holding "<boot id> <mac>". A change of the nvram
+ * ethaddr is only seen after a reboot */
+#define BASE_MAC_CACHE_FILE VENDOR_PATH "/servd/etc/.scapi_basemac"
+#define BOOT_ID_FILE "/proc/sys/kernel/random/boot_id"
+#define BOOT_ID_LEN 36
+#define BASE_MAC_STR_LEN 17
+
+static pthread_mutex_t xBaseMacLock = PTHREAD_MUTEX_INITIALIZER;
+static char sBaseMacCache[SCAPI_MAC_LEN];
+
+static int scapi_readBootId(char *pcBootId)
+{
+	int nFd = -1, nRet = -EXIT_FAILURE;
+
+	if((nFd = open(BOOT_ID_FILE, O_RDONLY | O_CLOEXEC)) < 0)
+		return -errno;
+	nRet = (read(nFd, pcBootId, BOOT_ID_LEN) == BOOT_ID_LEN) ? EXIT_SUCCESS : -EIO;
+	pcBootId[BOOT_ID_LEN] = '\0';
+	close(nFd);
+	return nRet;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_loadBaseMacCache
+ **
+ **   Description      :Base mac from BASE_MAC_CACHE_FILE, when it was written
+ **			during this boot
+ **
+ ** ============================================================================
+ */
+static int scapi_loadBaseMacCache(const char *pcBootId, char *pcMac)
+{
+	char sBuf[BOOT_ID_LEN + SCAPI_MAC_LEN + 2] = {0};
+	ssize_t nLen = 0;
+	int nFd = -1;
+
+	if((nFd = scapi_cacheOpen(BASE_MAC_CACHE_FILE)) < 0)
+		return nFd;
+	nLen = read(nFd, sBuf, sizeof(sBuf) - 1);
+	close(nFd);
+	if(nLen < BOOT_ID_LEN + 1 + BASE_MAC_STR_LEN || strncmp(sBuf, pcBootId, BOOT_ID_LEN) != 0 ||
+			sBuf[BOOT_ID_LEN] != ' ')
+		return -ESTALE;
+	sBuf[BOOT_ID_LEN + 1 + BASE_MAC_STR_LEN] = '\0';
+	if(scapi_isValidMac(sBuf + BOOT_ID_LEN + 1) != EXIT_SUCCESS)
+		return -ESTALE;
+	return strncpy_s(pcMac, SCAPI_MAC_LEN, sBuf + BOOT_ID_LEN + 1, BASE_MAC_STR_LEN) == EOK ? EXIT_SUCCESS : -EINVAL;
+}
+
+static void scapi_storeBaseMacCache(const char *pcBootId, const char *pcMac)
+{
+	char sTmp[SCAPI_CACHE_PATH_LEN] = {0}, sBuf[BOOT_ID_LEN + SCAPI_MAC_LEN + 2] = {0};
+	int nFd = -1, nLen = 0;
+
+	if((nLen = sprintf_s(sBuf, sizeof(sBuf), "%s %s\n", pcBootId, pcMac)) < 0)
+		return;
+	if((nFd = scapi_cacheCreate(BASE_MAC_CACHE_FILE, sTmp)) < 0)
+		return;
+	if(write(nFd, sBuf, nLen) != nLen || rename(sTmp, BASE_MAC_CACHE_FILE) != 0)
+		unlink(sTmp);
+	close(nFd);
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_getBaseMac
+ **
+ **   Description      :Gets base mac. Read from /proc/cmdline once per boot,
+ **			then served from the process cache and the root owned
+ **			BASE_MAC_CACHE_FILE. That file outlives a reboot, it is
+ **			only trusted while its boot id matches the running one
+ **
+ **   Parameters       :pcMac(OUT) -> Pointer to a buffer which will hold the mac
+ **					address returned by this API
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values 
+ ** ============================================================================
+ */
+int scapi_getBaseMac(char* pcMac){
+	char sBootId[BOOT_ID_LEN + 1] = {0};
+	char sMac[SCAPI_MAC_LEN] = {0};
+	bool bBootId = false;
+	int nRet = -EXIT_FAILURE;
+
+	if(pcMac == NULL)
+		return ERR_INPUT_VALIDATION_FAILED;
+
+	pthread_mutex_lock(&xBaseMacLock);
+	if(sBaseMacCache[0] == '\0')
+	{
+		bBootId = (scapi_readBootId(sBootId) == EXIT_SUCCESS);
+		if(!bBootId || scapi_loadBaseMacCache(sBootId, sMac) != EXIT_SUCCESS)
+		{
+			if((nRet = scapi_readBaseMac(sMac)) != EXIT_SUCCESS)
+				goto returnHandler;
+			/* only a well formed mac is worth keeping */
+			if(scapi_isValidMac(sMac) != EXIT_SUCCESS)
+			{
+				memcpy(pcMac, sMac, BASE_MAC_STR_LEN);
+				goto returnHandler;
+			}
+			if(bBootId)
+				scapi_storeBaseMacCache(sBootId, sMac);
+		}
+		strncpy_s(sBaseMacCache, sizeof(sBaseMacCache), sMac, BASE_MAC_STR_LEN);
+	}
+	memcpy(pcMac, sBaseMacCache, BASE_MAC_STR_LEN);
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	pthread_mutex_unlock(&xBaseMacLock);
+	return nRet;
+}
+
 /* 
  ** =============================================================================
  **   Function Name    :scapi_validateWithBase
@@ -660,147 +749,398 @@ returnHandler:
 	return nRet;
 }
 
-/* 
+/* Reserved (global) mac pool: reserved macs as offsets from a 48 bit base.
+ * Bit n of pullMember is set when base + n is in the reserved table, bit n
+ * of pullUsed when base + n is already assigned */
+typedef struct {
+	uint64_t ullBase;
+	uint32_t unSpan;
+	uint64_t *pullMember;
+	uint64_t *pullUsed;
+} ResvMacPool_t;
+
+/* Binary copy of a reserved mac table, valid while the table file keeps the
+ * stat() data it was made from */
+typedef struct {
+	uint32_t unMagic;
+	uint32_t unVersion;
+	uint64_t ullDev;
+	uint64_t ullIno;
+	uint64_t ullSize;
+	int64_t llMtimeSec;
+	int64_t llMtimeNsec;
+	uint64_t ullBase;
+	uint32_t unSpan;
+	uint32_t unReserved;
+} ResvMacSidecar_t;
+
+#define RESV_MAC_SIDECAR_MAGIC 0x52534d43
+#define RESV_MAC_SIDECAR_VERSION 1
+#define RESV_MAC_SIDECAR_FILE VENDOR_PATH "/servd/etc/.resv-mac.bin"
+#define RESV_MAC_6G_SIDECAR_FILE VENDOR_PATH "/servd/etc/.resv-mac-6g.bin"
+/* Reserved macs only ever change the last 3 octets */
+#define RESV_MAC_MAX_SPAN 0x1000000
+#define MAC_BITMAP_WORDS(span) (((span) + 63) / 64)
+
+/*
  ** =============================================================================
- **   Function Name    :scapi_incMacAddr
+ **   Function Name    :scapi_u64ToMac
  **
- **   Description      : Increment the public mac.
+ **   Description      :Formats a 48 bit mac the way the conf files store it
  **
- **   Parameters       :pAddr(INOUT) -> Mac address to increment
- **			pnIncCnt -> increment count
- ** 			pnPrCnt -> prent count
- ** 			max_val -> increment range
- ** 
- **   Return Value     :
+ ** ============================================================================
+ */
+static int scapi_u64ToMac(uint64_t ullMac, char *pcMac)
+{
+	int nRet = -EXIT_FAILURE;
+
+	SNPRINTF_GET_MAC(pcMac, SCAPI_MAC_LEN, "%02x:%02x:%02x:%02x:%02x:%02x",
+			(unsigned char)(ullMac >> 40), (unsigned char)(ullMac >> 32),
+			(unsigned char)(ullMac >> 24), (unsigned char)(ullMac >> 16),
+			(unsigned char)(ullMac >> 8), (unsigned char)ullMac);
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
+
+static bool scapi_bitTest(const uint64_t *pullMap, uint32_t unBit)
+{
+	return (pullMap[unBit / 64] >> (unBit % 64)) & 1;
+}
+
+static void scapi_bitSet(uint64_t *pullMap, uint32_t unBit)
+{
+	pullMap[unBit / 64] |= 1ULL << (unBit % 64);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_bitFindZero
+ **
+ **   Description      :First clear bit at or after unFrom, a word at a time
+ **
+ **   Return Value     :bit index, unSpan when there is none
  **
  ** ============================================================================
  */
-static void scapi_incMacAddr(unsigned char *pAddr, unsigned int *pnIncCnt, unsigned int *pnPrCnt, unsigned int max_val)
+static uint32_t scapi_bitFindZero(const uint64_t *pullMap, uint32_t unSpan, uint32_t unFrom)
 {
-	unsigned int incr_index, parent_index ;
-	incr_index = *pnIncCnt ;
-	parent_index = *pnPrCnt ;
-	if ( pAddr[incr_index] == max_val )
+	uint32_t unWord = unFrom / 64;
+	uint64_t ullInv = 0;
+
+	if(unFrom >= unSpan)
+		return unSpan;
+	ullInv = ~pullMap[unWord] & (~0ULL << (unFrom % 64));
+	while(ullInv == 0)
+	{
+		if(++unWord >= MAC_BITMAP_WORDS(unSpan))
+			return unSpan;
+		ullInv = ~pullMap[unWord];
+	}
+	unFrom = unWord * 64 + __builtin_ctzll(ullInv);
+	return (unFrom < unSpan) ? unFrom : unSpan;
+}
+
+static void scapi_resvPoolFree(ResvMacPool_t *pxPool)
+{
+	free(pxPool->pullMember);
+	free(pxPool->pullUsed);
+	memset(pxPool, 0, sizeof(*pxPool));
+}
+
+static int scapi_resvPoolAlloc(ResvMacPool_t *pxPool, uint64_t ullBase, uint32_t unSpan)
+{
+	pxPool->ullBase = ullBase;
+	pxPool->unSpan = unSpan;
+	pxPool->pullMember = calloc(MAC_BITMAP_WORDS(unSpan) + 1, sizeof(uint64_t));
+	pxPool->pullUsed = calloc(MAC_BITMAP_WORDS(unSpan) + 1, sizeof(uint64_t));
+	if(pxPool->pullMember == NULL || pxPool->pullUsed == NULL)
+	{
+		scapi_resvPoolFree(pxPool);
+		return -ENOMEM;
+	}
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_resvPoolParse
+ **
+ **   Description      :Builds the pool from the text table, "sup_mac=N" followed
+ **			by one mac per line. Tables written by older releases
+ **			may have gaps, they are kept as they are
+ **
+ ** ============================================================================
+ */
+static int scapi_resvPoolParse(const char *pcTable, ResvMacPool_t *pxPool)
+{
+	FILE *fp = scapi_getFilePtr(pcTable, "r");
+	char line[128] = {0};
+	uint64_t *pullMacs = NULL, *pullNew = NULL, ullMax = 0;
+	uint64_t ullMac = 0;
+	int nCnt = 0, nCap = 0, i = 0, nRet = -EXIT_FAILURE;
+
+	if(fp == NULL)
 	{
-		if ( pAddr[parent_index] == max_val) 
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		goto returnHandler;
+	}
+	while(fgets(line, sizeof(line), fp))
+	{
+		if(scapi_macToU64(line, &ullMac) != EXIT_SUCCESS || strchr(line, '=') != NULL)
+			continue;
+		if(nCnt == nCap)
 		{
-			pAddr[parent_index] = 0 ;
-			parent_index--;
+			nCap = nCap ? nCap * 2 : 64;
+			if((pullNew = realloc(pullMacs, nCap * sizeof(uint64_t))) == NULL)
+			{
+				nRet = -ENOMEM;
+				goto returnHandler;
+			}
+			pullMacs = pullNew;
 		}
-		pAddr[parent_index] +=1 ;
-		pAddr[incr_index] = 0 ;
+		pullMacs[nCnt++] = ullMac;
 	}
-	else
+	if(nCnt == 0)
 	{
-		pAddr[incr_index]++ ;
+		/* Empty table, nothing is reserved */
+		nRet = scapi_resvPoolAlloc(pxPool, 0, 0);
+		goto returnHandler;
 	}
 
-	*pnIncCnt = incr_index ;
-	*pnPrCnt = parent_index ;
+	/* Base is the first mac written, which is also the lowest one */
+	for(i = 0; i < nCnt; i++)
+	{
+		if(pullMacs[i] < pullMacs[0])
+			continue;
+		if(pullMacs[i] > ullMax)
+			ullMax = pullMacs[i];
+	}
+	if(ullMax - pullMacs[0] >= RESV_MAC_MAX_SPAN)
+	{
+		nRet = ERR_INPUT_VALIDATION_FAILED;
+		LOGF_LOG_ERROR("Reserved mac table %s is not valid\n", pcTable);
+		goto returnHandler;
+	}
+	if((nRet = scapi_resvPoolAlloc(pxPool, pullMacs[0], (uint32_t)(ullMax - pullMacs[0] + 1))) != EXIT_SUCCESS)
+		goto returnHandler;
+	for(i = 0; i < nCnt; i++)
+		if(pullMacs[i] >= pxPool->ullBase)
+			scapi_bitSet(pxPool->pullMember, (uint32_t)(pullMacs[i] - pxPool->ullBase));
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	free(pullMacs);
+	if(fp != NULL)
+		fclose(fp);
+	return nRet;
 }
 
-/* 
+/*
  ** =============================================================================
- **   Function Name    :scapi_validate6gLimit
+ **   Function Name    :scapi_resvPoolLoad
  **
- **   Description      :validate the limit of the mac address supported by DUT
+ **   Description      :Loads the reserved pool from its binary sidecar, or from
+ **			the text table when the sidecar is missing or stale, in
+ **			which case the sidecar is rewritten
  **
- **   Parameters       :pcMac(IN) -> mac address
- **                      bGlobal(IN) -> flag to chk private or global mac
+ **   Parameters       :pcTable(IN) -> reserved mac table (text)
+ **			pcSidecar(IN) -> binary copy of the table
+ **			pxPool(OUT) -> pool, all macs free
  **
  **   Return Value     :Success -> EXIT_SUCCESS
- **                      Failure -> Different -ve values 
- ** 
- **   Notes            :Top layer should allocate a NULL terminated array of size SCAPI_MAC_LEN  
+ **                      Failure -> Different -ve values
  **
  ** ============================================================================
  */
-static int scapi_validate6gLimit(char *pcMac, bool bGlobal)
+static int scapi_resvPoolLoad(const char *pcTable, const char *pcSidecar, ResvMacPool_t *pxPool)
 {
+	ResvMacSidecar_t xHdr;
+	struct stat st;
+	char sTmp[SCAPI_CACHE_PATH_LEN] = {0};
+	size_t nWords = 0;
+	int nFd = -1, nRet = -EXIT_FAILURE;
 
-	FILE *fFp;
-	char * line = NULL;
-	size_t len = 0;
-	ssize_t read;
-	int nRet;
-	if(bGlobal == true)
+	memset(pxPool, 0, sizeof(*pxPool));
+	if(stat(pcTable, &st) != 0)
+	{
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		goto returnHandler;
+	}
+
+	if((nFd = scapi_cacheOpen(pcSidecar)) >= 0)
 	{
-		// verify against reserved mac
-		fFp = scapi_getFilePtr(SUPPORTED_6G_MAC_TABLE_FILE, "r");	
-		if(fFp != NULL)
+		if(read(nFd, &xHdr, sizeof(xHdr)) == (ssize_t)sizeof(xHdr) &&
+				xHdr.unMagic == RESV_MAC_SIDECAR_MAGIC && xHdr.unVersion == RESV_MAC_SIDECAR_VERSION &&
+				xHdr.ullDev == (uint64_t)st.st_dev && xHdr.ullIno == (uint64_t)st.st_ino &&
+				xHdr.ullSize == (uint64_t)st.st_size && xHdr.llMtimeSec == (int64_t)st.st_mtim.tv_sec &&
+				xHdr.llMtimeNsec == (int64_t)st.st_mtim.tv_nsec && xHdr.unSpan <= RESV_MAC_MAX_SPAN &&
+				scapi_resvPoolAlloc(pxPool, xHdr.ullBase, xHdr.unSpan) == EXIT_SUCCESS)
 		{
-			while ((read = getline(&line, &len, fFp)) != -1) 
+			nWords = MAC_BITMAP_WORDS(xHdr.unSpan);
+			if(read(nFd, pxPool->pullMember, nWords * sizeof(uint64_t)) == (ssize_t)(nWords * sizeof(uint64_t)))
 			{
-				if(strncasecmp(pcMac,line,17)==0)
-				{
-					fclose(fFp);
-					nRet=EXIT_SUCCESS;
-					goto finish;
-				}
+				nRet = EXIT_SUCCESS;
+				goto returnHandler;
 			}
+			scapi_resvPoolFree(pxPool);
 		}
-		if(fFp != NULL) fclose(fFp);
-		nRet=EDQUOTA;
+		close(nFd);
+		nFd = -1;
 	}
-	else
+
+	if((nRet = scapi_resvPoolParse(pcTable, pxPool)) != EXIT_SUCCESS)
+		goto returnHandler;
+
+	/* Refresh the sidecar, a failure only costs a parse next time */
+	memset(&xHdr, 0, sizeof(xHdr));
+	xHdr.unMagic = RESV_MAC_SIDECAR_MAGIC;
+	xHdr.unVersion = RESV_MAC_SIDECAR_VERSION;
+	xHdr.ullDev = st.st_dev;
+	xHdr.ullIno = st.st_ino;
+	xHdr.ullSize = st.st_size;
+	xHdr.llMtimeSec = st.st_mtim.tv_sec;
+	xHdr.llMtimeNsec = st.st_mtim.tv_nsec;
+	xHdr.ullBase = pxPool->ullBase;
+	xHdr.unSpan = pxPool->unSpan;
+	nWords = MAC_BITMAP_WORDS(pxPool->unSpan);
+	if((nFd = scapi_cacheCreate(pcSidecar, sTmp)) >= 0)
 	{
-		// mac is from private pool.
-		nRet=EXIT_SUCCESS;
+		if(write(nFd, &xHdr, sizeof(xHdr)) != (ssize_t)sizeof(xHdr) ||
+				write(nFd, pxPool->pullMember, nWords * sizeof(uint64_t)) != (ssize_t)(nWords * sizeof(uint64_t)) ||
+				rename(sTmp, pcSidecar) != 0)
+			unlink(sTmp);
 	}
-finish:
-	if(line) free(line);
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	if(nFd >= 0)
+		close(nFd);
 	return nRet;
 }
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_resvPoolMarkUsed
+ **
+ **   Description      :Marks the reserved macs found in the set of macs in use
+ **
+ ** ============================================================================
+ */
+static void scapi_resvPoolMarkUsed(ResvMacPool_t *pxPool, const MacSet_t *pxUsed)
+{
+	uint64_t ullMac = 0;
+	uint32_t i = 0;
+
+	for(i = 0; pxUsed->pullSlots != NULL && i <= pxUsed->unMask; i++)
+	{
+		if(pxUsed->pullSlots[i] == 0)
+			continue;
+		ullMac = pxUsed->pullSlots[i] - 1;
+		if(ullMac >= pxPool->ullBase && ullMac - pxPool->ullBase < pxPool->unSpan)
+			scapi_bitSet(pxPool->pullUsed, (uint32_t)(ullMac - pxPool->ullBase));
+	}
+}
+
 /* 
  ** =============================================================================
  **   Function Name    :scapi_validateLimit
  **
  **   Description      :validate the limit of the mac address supported by DUT
  **
- **   Parameters       :pcMac(IN) -> mac address
+ **   Parameters       :pxPool(IN) -> reserved mac pool
+ **                      pcMac(IN) -> mac address
  **                      bGlobal(IN) -> flag to chk private or global mac
  **
  **   Return Value     :Success -> EXIT_SUCCESS
- **                      Failure -> Different -ve values 
+ **                      Failure -> EDQUOTA when the mac is not reserved
  ** 
- **   Notes            :Top layer should allocate a NULL terminated array of size SCAPI_MAC_LEN  
+ ** ============================================================================
+ */
+static int scapi_validateLimit(const ResvMacPool_t *pxPool, char *pcMac, bool bGlobal)
+{
+	uint64_t ullMac = 0;
+
+	// mac is from private pool.
+	if(bGlobal != true)
+		return EXIT_SUCCESS;
+	// verify against reserved mac
+	if(scapi_macToU64(pcMac, &ullMac) != EXIT_SUCCESS || ullMac < pxPool->ullBase ||
+			ullMac - pxPool->ullBase >= pxPool->unSpan ||
+			!scapi_bitTest(pxPool->pullMember, (uint32_t)(ullMac - pxPool->ullBase)))
+		return EDQUOTA;
+	return EXIT_SUCCESS;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_resvPoolNext
+ **
+ **   Description      :Picks the global mac of an interface: the caller's mac
+ **			when it is reserved and free, otherwise the first free
+ **			reserved mac from the base mac on. Same result as
+ **			incrementing and validating one mac at a time
+ **
+ **   Parameters       :pxPool(IN) -> reserved mac pool, used macs marked
+ **			pxIfr(IN) -> base mac
+ **			bStep(IN) -> start after the base mac, the base is taken
+ **			once the config file has entries
+ **			bTryCaller(IN) -> try pcMac first
+ **			pcMac(INOUT) -> resultant mac address
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> ERR_MACADDRESS_POOL_EXHAUSTED
  **
  ** ============================================================================
  */
-static int scapi_validateLimit(char *pcMac, bool bGlobal)
+static int scapi_resvPoolNext(const ResvMacPool_t *pxPool, struct ifreq *pxIfr, bool bStep, bool bTryCaller, char *pcMac)
 {
+	uint64_t ullMac = 0;
+	uint32_t unOff = 0, unFree = 0;
+	int i = 0, nRet = -EXIT_FAILURE;
 
-	FILE *fFp;
-	char * line = NULL;
-	size_t len = 0;
-	ssize_t read;
-	int nRet;
-	if(bGlobal == true)
+	if(bTryCaller)
 	{
-		// verify against reserved mac
-		fFp = scapi_getFilePtr(SUPPORTED_MAC_TABLE_FILE, "r");	
-		if(fFp != NULL)
+		if(scapi_validateLimit(pxPool, pcMac, true) != EXIT_SUCCESS)
 		{
-			while ((read = getline(&line, &len, fFp)) != -1) 
-			{
-				if(strncasecmp(pcMac,line,17)==0)
-				{
-					fclose(fFp);
-					nRet=EXIT_SUCCESS;
-					goto finish;
-				}
-			}
+			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+			goto returnHandler;
+		}
+		scapi_macToU64(pcMac, &ullMac);
+		if(!scapi_bitTest(pxPool->pullUsed, (uint32_t)(ullMac - pxPool->ullBase)))
+		{
+			nRet = EXIT_SUCCESS;
+			goto returnHandler;
 		}
-		if(fFp != NULL) fclose(fFp);
-		nRet=EDQUOTA;
 	}
-	else
+
+	for(i = 0; i < MAC_ADDR_BYTES; i++)
+		ullMac = (ullMac << 8) | (unsigned char)pxIfr->ifr_hwaddr.sa_data[i];
+	if(bStep)
+	{
+		/* only last 3 octets are allowed to change */
+		if((ullMac & 0xFFFFFF) == 0xFFFFFF)
+		{
+			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+			goto returnHandler;
+		}
+		ullMac++;
+	}
+	if(ullMac < pxPool->ullBase || ullMac - pxPool->ullBase >= pxPool->unSpan)
 	{
-		// mac is from private pool.
-		nRet=EXIT_SUCCESS;
+		nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+		goto returnHandler;
 	}
-finish:
-	if(line) free(line);
+	unOff = (uint32_t)(ullMac - pxPool->ullBase);
+	/* First free one, every mac up to it has to be reserved */
+	unFree = scapi_bitFindZero(pxPool->pullUsed, pxPool->unSpan, unOff);
+	if(unFree == pxPool->unSpan || scapi_bitFindZero(pxPool->pullMember, pxPool->unSpan, unOff) <= unFree)
+	{
+		nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+		goto returnHandler;
+	}
+	nRet = scapi_u64ToMac(pxPool->ullBase + unFree, pcMac);
+returnHandler:
+	if(nRet == ERR_MACADDRESS_POOL_EXHAUSTED)
+		fprintf(stderr, " [%s:%d] Generated mac not matching with reserved mac list or max limit reached %s\n",__func__,__LINE__,pcMac);
 	return nRet;
 }
 
@@ -888,11 +1228,8 @@ static int scapi_gen6gResevMacTable(char *pcBaseMac)
 {
 	int nCnt=0;
 	FILE *fp=NULL;
-	unsigned char mac_addr[MAC_ADDR_BYTES]={0};
-	char *pcTmp=NULL,*pcSavePtr=NULL;
-	unsigned int nMacCurIdx=MAC_ADDR_BYTES-1,nPranetIdx=MAC_ADDR_BYTES-2;
+	uint64_t ullMac=0;
 	int nMacMaxCnt=0, nResMacCnt=0;
-	size_t len=0;
 	int nRet=EXIT_SUCCESS;
 
 	char *pcMac=NULL;
@@ -911,19 +1248,11 @@ static int scapi_gen6gResevMacTable(char *pcBaseMac)
 		nMacMaxCnt=0; nResMacCnt=0; 
 
 		LOGF_LOG_INFO ("\n @@@@@ mac : %s @@@@@@ \n",pcMac);
-		if((len=strnlen_s(pcMac,SCAPI_MAC_LEN)) <=0 ){
-			fprintf(stderr, "[%s: %d] Fectching len failed\n",__func__, __LINE__);
+		if(scapi_macToU64(pcMac, &ullMac) != EXIT_SUCCESS){
+			fprintf(stderr, "[%s: %d] Invalid base mac\n",__func__, __LINE__);
 			nRet = ERR_INPUT_VALIDATION_FAILED;
 			goto returnHandler;
 		}
-		pcTmp=strtok_s(pcMac,&len, ":",&pcSavePtr);
-		nCnt=0;
-		while(pcTmp!=NULL)
-		{
-			sscanf_s (pcTmp,"%hhx",&(mac_addr[nCnt]));
-			nCnt++;
-			pcTmp=strtok_s(NULL,&len, ":",&pcSavePtr);
-		}
 
 		nMacMaxCnt = DEF_6g_MAC_SUPPORT_CNT;
  		fprintf(fp,"sup_mac=%d\n",nMacMaxCnt);
@@ -937,15 +1266,15 @@ static int scapi_gen6gResevMacTable(char *pcBaseMac)
 			goto returnHandler;
 		}
 
+		/* Consecutive macs from the base, which is what the pool
+		 * offset arithmetic relies on */
 		while (nCnt>0)
 		{
-			LOGF_LOG_INFO("%02x:%02x:%02x:%02x:%02x:%02x\n", 
-					mac_addr[0], mac_addr[1], mac_addr[2], 
-					mac_addr[3], mac_addr[4], mac_addr[5]);
 			fprintf(fp,"%02x:%02x:%02x:%02x:%02x:%02x\n", 
-					mac_addr[0], mac_addr[1], mac_addr[2], 
-					mac_addr[3], mac_addr[4], mac_addr[5]);
-			scapi_incMacAddr(mac_addr, &nMacCurIdx, &nPranetIdx, MAX_U8_VAL);
+					(unsigned char)(ullMac >> 40), (unsigned char)(ullMac >> 32),
+					(unsigned char)(ullMac >> 24), (unsigned char)(ullMac >> 16),
+					(unsigned char)(ullMac >> 8), (unsigned char)ullMac);
+			ullMac++;
 			nCnt--;
 		}
 	}
@@ -973,11 +1302,8 @@ static int scapi_genResevMacTable(char *pcBaseMac)
 {
 	int nCnt=0;
 	FILE *fp=NULL;
-	unsigned char mac_addr[MAC_ADDR_BYTES]={0};
-	char *pcTmp=NULL,*pcSavePtr=NULL;
-	unsigned int nMacCurIdx=MAC_ADDR_BYTES-1,nPranetIdx=MAC_ADDR_BYTES-2;
+	uint64_t ullMac=0;
 	int nMacMaxCnt=0, nResMacCnt=0;
-	size_t len=0;
 	int nRet=EXIT_SUCCESS;
 
 	char *pcMac=NULL;
@@ -996,19 +1322,11 @@ static int scapi_genResevMacTable(char *pcBaseMac)
 		nMacMaxCnt=0; nResMacCnt=0; 
 
 		LOGF_LOG_INFO ("\n @@@@@ mac : %s @@@@@@ \n",pcMac);
-		if((len=strnlen_s(pcMac,SCAPI_MAC_LEN)) <=0 ){
-			fprintf(stderr, "[%s: %d] Fectching len failed\n",__func__, __LINE__);
+		if(scapi_macToU64(pcMac, &ullMac) != EXIT_SUCCESS){
+			fprintf(stderr, "[%s: %d] Invalid base mac\n",__func__, __LINE__);
 			nRet = ERR_INPUT_VALIDATION_FAILED;
 			goto returnHandler;
 		}
-		pcTmp=strtok_s(pcMac,&len, ":",&pcSavePtr);
-		nCnt=0;
-		while(pcTmp!=NULL)
-		{
-			sscanf_s (pcTmp,"%hhx",&(mac_addr[nCnt]));
-			nCnt++;
-			pcTmp=strtok_s(NULL,&len, ":",&pcSavePtr);
-		}
 
 		// call api to read uboot value
 		if (scapi_getRunTimeVal("sup_mac", &nMacMaxCnt) != EXIT_SUCCESS)
@@ -1032,15 +1350,15 @@ static int scapi_genResevMacTable(char *pcBaseMac)
 			goto returnHandler;
 		}
 
+		/* Consecutive macs from the base, which is what the pool
+		 * offset arithmetic relies on */
 		while (nCnt>0)
 		{
-			LOGF_LOG_INFO("%02x:%02x:%02x:%02x:%02x:%02x\n", 
-					mac_addr[0], mac_addr[1], mac_addr[2], 
-					mac_addr[3], mac_addr[4], mac_addr[5]);
 			fprintf(fp,"%02x:%02x:%02x:%02x:%02x:%02x\n", 
-					mac_addr[0], mac_addr[1], mac_addr[2], 
-					mac_addr[3], mac_addr[4], mac_addr[5]);
-			scapi_incMacAddr(mac_addr, &nMacCurIdx, &nPranetIdx, MAX_U8_VAL);
+					(unsigned char)(ullMac >> 40), (unsigned char)(ullMac >> 32),
+					(unsigned char)(ullMac >> 24), (unsigned char)(ullMac >> 16),
+					(unsigned char)(ullMac >> 8), (unsigned char)ullMac);
+			ullMac++;
 			nCnt--;
 		}
 	}
@@ -1118,53 +1436,33 @@ fail:
 
 /* 
  ** =============================================================================
- **   Function Name    :scapi_getMbssidNextMacaddr
+ **   Function Name    :scapi_nextMac6gPrep
  **
- **   Description      :Gets next mac address of an interface and saves it in config file
+ **   Description      :Reads the base mac and makes sure the 6g reserved mac table
+ **			matches it, shared by the single and batch allocations
  **
- **   Parameters       :pcIfname(IN) -> interface name
- **                      pcMac(OUT) -> resultant mac address. 
+ **   Parameters       :pcIfname(IN) -> interface name, for logging
+ **			pxIfr(OUT) -> base mac to allocate from
+ **			pcBaseMac(OUT) -> base mac, SCAPI_MAC_LEN buffer
+ **			pnMacModified(OUT) -> set to 1 when the reserved table
+ **			was regenerated and the assignments dropped
  **
  **   Return Value     :Success -> EXIT_SUCCESS
  **                      Failure -> Different -ve values 
- ** 
- **   Notes            :Top layer should allocate a NULL terminated array of size SCAPI_MAC_LEN  
  **
  ** ============================================================================
  */
-
-int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
+static int scapi_nextMac6gPrep(char *pcIfname, struct ifreq *pxIfr, char *pcBaseMac, int *pnMacModified)
 {
-	struct ifreq xIfr = {.ifr_ifru={0}};
-	int nRet = -EXIT_FAILURE, nCnt = 0;
-	FILE* fp = NULL;
-	struct stat st;
-	int nMacMaxCnt = 0, nMacCnt = 0, nMacModified = 0;
-	char sBaseMac[SCAPI_MAC_LEN] = {0};
+	NextMacStore_t xStore;
+	int nRet = -EXIT_FAILURE;
+	int nMacMaxCnt = 0, nMacCnt = 0;
 	char sBuf[SCAPI_MAC_LEN] = {0};
 
-	memset(&st, 0, sizeof(st));
-
-	if(pcIfname == NULL || pcMac == NULL || !strcmp(pcIfname,""))
-	{
-		nRet = ERR_INPUT_VALIDATION_FAILED;
-		LOGF_LOG_CRITICAL("Invalid Values either pcIfname[%s] or pcMac is NULL\n", pcIfname);
-		goto returnHandler;
-	}
-	/*Only Global address saved in the DB*/
-	if(pcMac[0] != '\0')
-	{
-		if(bGlobal == false)
-		{
-			pcMac[0] = '0';
-			pcMac[1] = '2';
-		}
-	}
-
 	/* get base mac */
-	nRet = scapi_getBaseMac(sBaseMac);
-	sBaseMac[15] = '0';
-	sBaseMac[16] = '0';
+	nRet = scapi_getBaseMac(pcBaseMac);
+	pcBaseMac[15] = '0';
+	pcBaseMac[16] = '0';
 
 	if(nRet != EXIT_SUCCESS)
 	{
@@ -1173,18 +1471,18 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 		goto returnHandler;
 	}
 
-	sscanf_s(sBaseMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[0]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[1]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[2]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[3]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[4]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[5]));
+	sscanf_s(pcBaseMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[0]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[1]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[2]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[3]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[4]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[5]));
 
 
 	if (scapi_fileExists(SUPPORTED_6G_MAC_TABLE_FILE) == UGW_FAILURE) {
 		//call api to generate res mac table	
-		nRet = scapi_gen6gResevMacTable(sBaseMac);
+		nRet = scapi_gen6gResevMacTable(pcBaseMac);
 		if( nRet != EXIT_SUCCESS)
 			goto returnHandler;
 	} else {
@@ -1198,14 +1496,21 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 				}
 			}
 			if ((nRet = scapi_getRunTimeVal("sup_mac",&nMacCnt)) == EXIT_SUCCESS) {
-				if ((nMacMaxCnt != nMacCnt) || (strncasecmp(sBuf, sBaseMac,17) != 0)) {
+				if ((nMacMaxCnt != nMacCnt) || (strncasecmp(sBuf, pcBaseMac,17) != 0)) {
 					LOGF_LOG_INFO( "uboot env cnt:%d previous cnt: %d current mac:%s previous mac :%s\n",
-							nMacCnt, nMacMaxCnt, sBuf, sBaseMac);
+							nMacCnt, nMacMaxCnt, sBuf, pcBaseMac);
 					/* regenrate the mac table */
-					remove(NEXT_MAC_6g_CONF);
-					remove(SUPPORTED_6G_MAC_TABLE_FILE);
-					nMacModified = 1;
-					if (scapi_gen6gResevMacTable(sBaseMac) != EXIT_SUCCESS)
+					/* Under the store lock, a writer must not append to
+					   the conf being dropped or see the old table */
+					if ((nRet = scapi_nmStoreOpen(&xStore, NEXT_MAC_6g_CONF, NEXT_MAC_6g_LOCK, true)) != EXIT_SUCCESS)
+						goto returnHandler;
+					if ((nRet = scapi_nmStoreClear(&xStore)) == EXIT_SUCCESS) {
+						remove(SUPPORTED_6G_MAC_TABLE_FILE);
+						*pnMacModified = 1;
+						nRet = scapi_gen6gResevMacTable(pcBaseMac);
+					}
+					scapi_nmStoreClose(&xStore);
+					if (nRet != EXIT_SUCCESS)
 						goto returnHandler;
 				}
 			} else {
@@ -1214,12 +1519,173 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 			}	
 		}
 	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_nextMacPrep
+ **
+ **   Description      :Reads the base mac and makes sure the reserved mac table
+ **			matches it, shared by the single and batch allocations
+ **
+ **   Parameters       :pcIfname(IN) -> interface name, for logging
+ **			pxIfr(OUT) -> base mac to allocate from
+ **			pcBaseMac(OUT) -> base mac, SCAPI_MAC_LEN buffer
+ **			pnMacModified(OUT) -> set to 1 when the reserved table
+ **			was regenerated and the assignments dropped
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values 
+ **
+ ** ============================================================================
+ */
+static int scapi_nextMacPrep(char *pcIfname, struct ifreq *pxIfr, char *pcBaseMac, int *pnMacModified)
+{
+	NextMacStore_t xStore;
+	int nRet = -EXIT_FAILURE;
+	int nMacMaxCnt = 0, nMacCnt = 0, nFd = -1;
+	char sBuf[SCAPI_MAC_LEN] = {0};
+
+	/* get base mac */
+	nRet = scapi_getBaseMac(pcBaseMac);
+
+	if(nRet != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"scapi_getBaseMac(..) returned Failure for [ %s ] = ret(%d)\n", 
+				pcIfname, nRet);
+		goto returnHandler;
+	}
+
+	/* Modify Base MAC if 6G is enabled for first boot */
+	if (scapi_fileExists(UCI_6G_FILE) == UGW_SUCCESS) {
+		pcBaseMac[15] = '2';
+		pcBaseMac[16] = '0';
+	} else {
+		/* Take the last byte Base Mac from resv list from Second reboot onwards */
+		if (scapi_fileExists(SUPPORTED_MAC_TABLE_FILE) == UGW_SUCCESS) {
+			nRet = scapi_getMacAddrFromResvList(SUPPORTED_MAC_TABLE_FILE, sBuf, &nMacMaxCnt);
+			if (nRet != EXIT_SUCCESS) {
+				LOGF_LOG_DEBUG("Get BaseMAC for resv list failed\n");
+				goto returnHandler;
+			}
+			pcBaseMac[15] = sBuf[15];
+			pcBaseMac[16] = sBuf[16];
+		}
+	}
+
+	sscanf_s(pcBaseMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[0]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[1]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[2]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[3]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[4]),
+			(unsigned char *)&(pxIfr->ifr_hwaddr.sa_data[5]));
+
+
+	if(scapi_fileExists(SUPPORTED_MAC_TABLE_FILE) == UGW_FAILURE) {
+		//call api to generate res mac table	
+		nRet = scapi_genResevMacTable(pcBaseMac);
+		if ( nRet != EXIT_SUCCESS) {
+			goto returnHandler;
+		}
+	} else {
+		if (scapi_fileExists(BOOT_CHK) == UGW_FAILURE) {
+			if ((nRet = scapi_getRunTimeVal("sup_mac", &nMacCnt)) == EXIT_SUCCESS) {
+				if ((nMacMaxCnt != nMacCnt) || (strncasecmp(sBuf, pcBaseMac, 17) != 0)) {
+					LOGF_LOG_INFO( "uboot env cnt:%d previous cnt: %d current mac:%s previous mac :%s\n",
+							nMacCnt, nMacMaxCnt, sBuf, pcBaseMac);
+					/* regenrate the mac table */
+					/* Under the store lock, a writer must not append to
+					   the conf being dropped or see the old table */
+					if ((nRet = scapi_nmStoreOpen(&xStore, NEXT_MAC_CONF, NEXT_MAC_LOCK, true)) != EXIT_SUCCESS)
+						goto returnHandler;
+					if ((nRet = scapi_nmStoreClear(&xStore)) == EXIT_SUCCESS) {
+						remove(SUPPORTED_MAC_TABLE_FILE);
+						*pnMacModified = 1;
+						nRet = scapi_genResevMacTable(pcBaseMac);
+					}
+					scapi_nmStoreClose(&xStore);
+					if (nRet != EXIT_SUCCESS)
+						goto returnHandler;
+				}
+			} else {
+				fprintf(stderr, "Retrival of supported mac info is failed reason:%d\n", nRet);
+				goto returnHandler;
+			}	
+		}
+	}
+
+	if(scapi_fileExists(BOOT_CHK) == UGW_FAILURE)
+	{
+		if((nFd = open(BOOT_CHK, O_RDWR|O_CREAT,0666)) == -1) 
+			perror("open");
+		if(nFd >= 0)
+			close(nFd);
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_getMbssidNextMacaddr
+ **
+ **   Description      :Gets next mac address of an interface and saves it in config file
+ **
+ **   Parameters       :pcIfname(IN) -> interface name
+ **                      pcMac(OUT) -> resultant mac address. 
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values 
+ ** 
+ **   Notes            :Top layer should allocate a NULL terminated array of size SCAPI_MAC_LEN  
+ **
+ ** ============================================================================
+ */
+
+int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
+{
+	struct ifreq xIfr = {.ifr_ifru={0}};
+	int nRet = -EXIT_FAILURE, nCnt = 0;
+	int nMacModified = 0;
+	bool bExists = false;
+	char sBaseMac[SCAPI_MAC_LEN] = {0};
+	MacSet_t xUsed = {0};
+	ResvMacPool_t xPool = {0};
+	NextMacStore_t xStore = {.nLockFd = -1};
+
+	if(pcIfname == NULL || pcMac == NULL || !strcmp(pcIfname,""))
+	{
+		nRet = ERR_INPUT_VALIDATION_FAILED;
+		LOGF_LOG_CRITICAL("Invalid Values either pcIfname[%s] or pcMac is NULL\n", pcIfname);
+		goto returnHandler;
+	}
+	/*Only Global address saved in the DB*/
+	if(pcMac[0] != '\0')
+	{
+		if(bGlobal == false)
+		{
+			pcMac[0] = '0';
+			pcMac[1] = '2';
+		}
+	}
+
+	if((nRet = scapi_nextMac6gPrep(pcIfname, &xIfr, sBaseMac, &nMacModified)) != EXIT_SUCCESS)
+		goto returnHandler;
+
+	bExists = (scapi_fileExists(NEXT_MAC_6g_CONF) == UGW_SUCCESS);
+	if((nRet = scapi_nmStoreOpen(&xStore, NEXT_MAC_6g_CONF, NEXT_MAC_6g_LOCK, true)) != EXIT_SUCCESS)
+		goto returnHandler;
 
 	LOGF_LOG_INFO("Generating Mac for [%s] From BaseMac \n",pcIfname);
 
-	if(scapi_fileExists(NEXT_MAC_6g_CONF) == UGW_SUCCESS)
+	if(bExists)
 	{
-		nRet = scapi_get6gMacFromFile(pcIfname, pcMac);
+		nRet = scapi_getMacFromStore(&xStore, pcIfname, pcMac);
 		if(nRet == EXIT_SUCCESS)
 		{
 			if(scapi_isValidMac(pcMac) == EXIT_SUCCESS)
@@ -1230,12 +1696,10 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 			else
 			{
 				// if retrived mac is corrupted
-				nRet=scapi_removeNextMacaddr(pcIfname);
-				if(nRet != EXIT_SUCCESS)
-					remove(NEXT_MAC_CONF);
+				pcMac[0] = '\0';
+				if((nRet = scapi_nmStoreRemove(&xStore, pcIfname)) != EXIT_SUCCESS)
+					goto returnHandler;
 			}
-		}else if(nRet == ERR_INPUT_VALIDATION_FAILED){
-			goto returnHandler;
 		}else{
 			LOGF_LOG_INFO("Getting MAC Address from file is failed,new mac request\n");
 		}
@@ -1263,7 +1727,10 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 				SNPRINTF_GET_MAC(pcMac, SCAPI_MAC_LEN, "%s",sBaseMac);
 			}
 			//validate mac against limit
-			nRet = scapi_validate6gLimit(pcMac,bGlobal);
+			if(scapi_resvPoolLoad(SUPPORTED_6G_MAC_TABLE_FILE, RESV_MAC_6G_SIDECAR_FILE, &xPool) != EXIT_SUCCESS)
+				nRet = EDQUOTA;
+			else
+				nRet = scapi_validateLimit(&xPool, pcMac, bGlobal);
 			if(nRet == EDQUOTA)
 			{
 				fprintf(stderr, " [%s:%d] Generated mac not matching with reserved mac list or max limit reached %s\n",__func__,__LINE__,pcMac);
@@ -1274,15 +1741,36 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 		goto finish;
 	}
 
+	/* Macs in use are collected once, each candidate is then a lookup */
+	if((nRet = scapi_loadUsedMacs(&xUsed, &xStore, &pcIfname, 1, false)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"Unable to validate the mac with interfaces ret=%d\n",nRet);
+		goto returnHandler;
+	}
+
+	/* Global macs: first free reserved one, found with the pool bitmaps */
+	if(bGlobal == true)
+	{
+		if(scapi_resvPoolLoad(SUPPORTED_6G_MAC_TABLE_FILE, RESV_MAC_6G_SIDECAR_FILE, &xPool) != EXIT_SUCCESS)
+		{
+			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+			fprintf(stderr, " [%s:%d] Reserved mac list not available\n",__func__,__LINE__);
+			goto returnHandler;
+		}
+		scapi_resvPoolMarkUsed(&xPool, &xUsed);
+		nRet = scapi_resvPoolNext(&xPool, &xIfr, (xStore.nCnt != 0), (pcMac[0] != '\0' && nMacModified != 1), pcMac);
+		if(nRet != EXIT_SUCCESS)
+			goto returnHandler;
+		goto finish;
+	}
+
 	nRet = UGW_SUCCESS;
 	//KL fix
 	while(nCnt<1000)
 	{
-		memset(&st, 0, sizeof(st));
-
 		if((pcMac[0] == '\0') || (nMacModified == 1) || (nRet == -MAC_IN_USE))
 		{
-			if (stat(NEXT_MAC_6g_CONF, &st) == 0 && st.st_size != 0) {
+			if (xStore.nCnt != 0) {
 				nRet = scapi_incrementMacaddr(&xIfr,bGlobal);
 
 				if(nRet != EXIT_SUCCESS){
@@ -1302,16 +1790,7 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 					(unsigned char)xIfr.ifr_hwaddr.sa_data[5]);
 
 		}
-		nRet = scapi_validate6gLimit(pcMac,bGlobal);
-
-		if(nRet == EDQUOTA)
-		{
-			fprintf(stderr, " [%s:%d] Generated mac not matching with reserved mac list or max limit reached %s\n",__func__,__LINE__,pcMac);
-			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
-			goto returnHandler;
-		}
-
-		nRet  = scapi_validate6gMacaddr(pcIfname, pcMac);
+		nRet  = scapi_validateMacaddr(&xUsed, pcMac);
 
 		/* Validation successful */
 		if( nRet == 0){
@@ -1325,20 +1804,19 @@ int scapi_getMbssidNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 		}
 	}
 finish:
-	/* This file is already created by scapi_getNextMacFromFile() API */
-	fp = scapi_getFilePtr(NEXT_MAC_6g_CONF, "a+");
-	if(fp == NULL){
-		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
-		fprintf(stderr,"[%s:%d] next_mac_conf file update failed reason:%s\n", __func__, __LINE__, strerror(errno));
+	if((nRet = scapi_nmStoreSet(&xStore, pcIfname, pcMac)) != EXIT_SUCCESS ||
+			(nRet = scapi_nmStoreCommit(&xStore)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"[%s:%d] next_mac_conf file update failed ret:%d\n", __func__, __LINE__, nRet);
 		goto returnHandler;
 	}
-	fprintf(fp, "%s> %s\n", pcIfname, pcMac);
 
 	nRet = UGW_SUCCESS;
 	LOGF_LOG_INFO("Mac Generated [ %s ] : [%s ]\n",pcIfname, pcMac);
 returnHandler:
-	if(fp != NULL)
-		fclose(fp);
+	scapi_nmStoreClose(&xStore);
+	scapi_macSetFree(&xUsed);
+	scapi_resvPoolFree(&xPool);
 	return nRet;
 }
 
@@ -1364,13 +1842,12 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 {
 	struct ifreq xIfr = {.ifr_ifru={0}};
 	int nRet = -EXIT_FAILURE, nCnt = 0;
-	FILE* fp = NULL;
-	struct stat st;
-	int nMacMaxCnt = 0, nMacCnt = 0, nFd = -1, nMacModified = 0;
+	int nMacModified = 0;
+	bool bExists = false;
 	char sBaseMac[SCAPI_MAC_LEN] = {0};
-	char sBuf[SCAPI_MAC_LEN] = {0};
-
-	memset(&st, 0, sizeof(st));
+	MacSet_t xUsed = {0};
+	ResvMacPool_t xPool = {0};
+	NextMacStore_t xStore = {.nLockFd = -1};
 
 	if(pcIfname == NULL || pcMac == NULL || !strcmp(pcIfname,""))
 	{
@@ -1388,82 +1865,18 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 		}
 	}
 
-	/* get base mac */
-	nRet = scapi_getBaseMac(sBaseMac);
-
-	if(nRet != EXIT_SUCCESS)
-	{
-		fprintf(stderr,"scapi_getBaseMac(..) returned Failure for [ %s ] = ret(%d)\n", 
-				pcIfname, nRet);
+	if((nRet = scapi_nextMacPrep(pcIfname, &xIfr, sBaseMac, &nMacModified)) != EXIT_SUCCESS)
 		goto returnHandler;
-	}
-
-	/* Modify Base MAC if 6G is enabled for first boot */
-	if (scapi_fileExists(UCI_6G_FILE) == UGW_SUCCESS) {
-		sBaseMac[15] = '2';
-		sBaseMac[16] = '0';
-	} else {
-		/* Take the last byte Base Mac from resv list from Second reboot onwards */
-		if (scapi_fileExists(SUPPORTED_MAC_TABLE_FILE) == UGW_SUCCESS) {
-			nRet = scapi_getMacAddrFromResvList(SUPPORTED_MAC_TABLE_FILE, sBuf, &nMacMaxCnt);
-			if (nRet != EXIT_SUCCESS) {
-				LOGF_LOG_DEBUG("Get BaseMAC for resv list failed\n");
-				goto returnHandler;
-			}
-			sBaseMac[15] = sBuf[15];
-			sBaseMac[16] = sBuf[16];
-		}
-	}
-
-	sscanf_s(sBaseMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[0]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[1]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[2]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[3]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[4]),
-			(unsigned char *)&(xIfr.ifr_hwaddr.sa_data[5]));
-
-
-	if(scapi_fileExists(SUPPORTED_MAC_TABLE_FILE) == UGW_FAILURE) {
-		//call api to generate res mac table	
-		nRet = scapi_genResevMacTable(sBaseMac);
-		if ( nRet != EXIT_SUCCESS) {
-			goto returnHandler;
-		}
-	} else {
-		if (scapi_fileExists(BOOT_CHK) == UGW_FAILURE) {
-			if ((nRet = scapi_getRunTimeVal("sup_mac", &nMacCnt)) == EXIT_SUCCESS) {
-				if ((nMacMaxCnt != nMacCnt) || (strncasecmp(sBuf, sBaseMac, 17) != 0)) {
-					LOGF_LOG_INFO( "uboot env cnt:%d previous cnt: %d current mac:%s previous mac :%s\n",
-							nMacCnt, nMacMaxCnt, sBuf, sBaseMac);
-					/* regenrate the mac table */
-					remove(NEXT_MAC_CONF);
-					remove(SUPPORTED_MAC_TABLE_FILE);
-					nMacModified = 1;
-					if (scapi_genResevMacTable(sBaseMac) != EXIT_SUCCESS) {
-						goto returnHandler;
-					}
-				}
-			} else {
-				fprintf(stderr, "Retrival of supported mac info is failed reason:%d\n", nRet);
-				goto returnHandler;
-			}	
-		}
-	}
 
-	if(scapi_fileExists(BOOT_CHK) == UGW_FAILURE)
-	{
-		if((nFd = open(BOOT_CHK, O_RDWR|O_CREAT,0666)) == -1) 
-			perror("open");
-		if(nFd >= 0)
-			close(nFd);
-	}
+	bExists = (scapi_fileExists(NEXT_MAC_CONF) == UGW_SUCCESS);
+	if((nRet = scapi_nmStoreOpen(&xStore, NEXT_MAC_CONF, NEXT_MAC_LOCK, true)) != EXIT_SUCCESS)
+		goto returnHandler;
 
 	LOGF_LOG_INFO("Generating Mac for [%s] From BaseMac \n",pcIfname);
 
-	if(scapi_fileExists(NEXT_MAC_CONF) == UGW_SUCCESS)
+	if(bExists)
 	{
-		nRet = scapi_getMacFromFile(pcIfname, pcMac);
+		nRet = scapi_getMacFromStore(&xStore, pcIfname, pcMac);
 		if(nRet == EXIT_SUCCESS)
 		{
 			if(scapi_isValidMac(pcMac) == EXIT_SUCCESS)
@@ -1474,12 +1887,10 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 			else
 			{
 				// if retrived mac is corrupted
-				nRet=scapi_removeNextMacaddr(pcIfname);
-				if(nRet != EXIT_SUCCESS)
-					remove(NEXT_MAC_CONF);
+				pcMac[0] = '\0';
+				if((nRet = scapi_nmStoreRemove(&xStore, pcIfname)) != EXIT_SUCCESS)
+					goto returnHandler;
 			}
-		}else if(nRet == ERR_INPUT_VALIDATION_FAILED){
-			goto returnHandler;
 		}else{
 			LOGF_LOG_INFO("Getting MAC Address from file is failed,new mac request\n");
 		}
@@ -1507,7 +1918,10 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 				SNPRINTF_GET_MAC(pcMac, SCAPI_MAC_LEN, "%s",sBaseMac);
 			}
 			//validate mac against limit
-			nRet = scapi_validateLimit(pcMac,bGlobal);
+			if(scapi_resvPoolLoad(SUPPORTED_MAC_TABLE_FILE, RESV_MAC_SIDECAR_FILE, &xPool) != EXIT_SUCCESS)
+				nRet = EDQUOTA;
+			else
+				nRet = scapi_validateLimit(&xPool, pcMac, bGlobal);
 			if(nRet == EDQUOTA)
 			{
 				fprintf(stderr, " [%s:%d] Generated mac not matching with reserved mac list or max limit reached %s\n",__func__,__LINE__,pcMac);
@@ -1518,15 +1932,36 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 		goto finish;
 	}
 
+	/* Macs in use are collected once, each candidate is then a lookup */
+	if((nRet = scapi_loadUsedMacs(&xUsed, &xStore, &pcIfname, 1, true)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"Unable to validate the mac with interfaces ret=%d\n",nRet);
+		goto returnHandler;
+	}
+
+	/* Global macs: first free reserved one, found with the pool bitmaps */
+	if(bGlobal == true)
+	{
+		if(scapi_resvPoolLoad(SUPPORTED_MAC_TABLE_FILE, RESV_MAC_SIDECAR_FILE, &xPool) != EXIT_SUCCESS)
+		{
+			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+			fprintf(stderr, " [%s:%d] Reserved mac list not available\n",__func__,__LINE__);
+			goto returnHandler;
+		}
+		scapi_resvPoolMarkUsed(&xPool, &xUsed);
+		nRet = scapi_resvPoolNext(&xPool, &xIfr, (xStore.nCnt != 0), (pcMac[0] != '\0' && nMacModified != 1), pcMac);
+		if(nRet != EXIT_SUCCESS)
+			goto returnHandler;
+		goto finish;
+	}
+
 	nRet = UGW_SUCCESS;
 	//KL fix
 	while(nCnt<1000)
 	{
-		memset(&st, 0, sizeof(st));
-
 		if((pcMac[0] == '\0') || (nMacModified == 1) || (nRet == -MAC_IN_USE))
 		{
-			if (stat(NEXT_MAC_CONF, &st) == 0 && st.st_size != 0) {
+			if (xStore.nCnt != 0) {
 				nRet = scapi_incrementMacaddr(&xIfr,bGlobal);
 
 				if(nRet != EXIT_SUCCESS){
@@ -1546,16 +1981,7 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 					(unsigned char)xIfr.ifr_hwaddr.sa_data[5]);
 
 		}
-		nRet = scapi_validateLimit(pcMac,bGlobal);
-
-		if(nRet == EDQUOTA)
-		{
-			fprintf(stderr, " [%s:%d] Generated mac not matching with reserved mac list or max limit reached %s\n",__func__,__LINE__,pcMac);
-			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
-			goto returnHandler;
-		}
-
-		nRet  = scapi_validateMacaddr(pcIfname, pcMac);
+		nRet  = scapi_validateMacaddr(&xUsed, pcMac);
 
 		/* Validation successful */
 		if( nRet == 0){
@@ -1569,20 +1995,268 @@ int scapi_getNextMacaddr(char* pcIfname, bool bGlobal, char* pcMac)
 		}
 	}
 finish:
-	/* This file is already created by scapi_getNextMacFromFile() API */
-	fp = scapi_getFilePtr(NEXT_MAC_CONF, "a+");
-	if(fp == NULL){
-		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
-		fprintf(stderr,"[%s:%d] next_mac_conf file update failed reason:%s\n", __func__, __LINE__, strerror(errno));
+	if((nRet = scapi_nmStoreSet(&xStore, pcIfname, pcMac)) != EXIT_SUCCESS ||
+			(nRet = scapi_nmStoreCommit(&xStore)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"[%s:%d] next_mac_conf file update failed ret:%d\n", __func__, __LINE__, nRet);
 		goto returnHandler;
 	}
-	fprintf(fp, "%s> %s\n", pcIfname, pcMac);
 
 	nRet = UGW_SUCCESS;
 	LOGF_LOG_INFO("Mac Generated [ %s ] : [%s ]\n",pcIfname, pcMac);
 returnHandler:
-	if(fp != NULL)
-		fclose(fp);
+	scapi_nmStoreClose(&xStore);
+	scapi_macSetFree(&xUsed);
+	scapi_resvPoolFree(&xPool);
+	return nRet;
+}
+
+/* Files one allocation family works on */
+typedef struct {
+	const char *pcConf;
+	const char *pcLock;
+	const char *pcTable;
+	const char *pcSidecar;
+	bool bSystem;
+} NextMacFiles_t;
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_nextMacBatch
+ **
+ **   Description      :Allocates the macs of several interfaces at once: the
+ **			config file is locked, the macs in use and the reserved
+ **			pool are loaded once, and all new assignments are appended
+ **			with a single write, or none of them on failure
+ **
+ **   Parameters       :pxFiles(IN) -> config and reserved table files
+ **			pxIfr(IN) -> base mac, from the prep function
+ **			nMacModified(IN) -> reserved table was regenerated
+ **			ppcIfnames(IN) -> interface names
+ **			nCount(IN) -> number of interfaces
+ **			bGlobal(IN) -> global or private macs
+ **			ppcMacs(INOUT) -> SCAPI_MAC_LEN buffers, a non empty
+ **			one is the mac requested for that interface
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values, ppcMacs cleared
+ **
+ ** ============================================================================
+ */
+static int scapi_nextMacBatch(const NextMacFiles_t *pxFiles, struct ifreq *pxIfr, int nMacModified,
+		char **ppcIfnames, int nCount, bool bGlobal, char **ppcMacs)
+{
+	MacSet_t xUsed = {0};
+	ResvMacPool_t xPool = {0};
+	NextMacStore_t xStore = {.nLockFd = -1};
+	const NextMacRec_t *pxRec = NULL;
+	uint64_t ullMac = 0;
+	int nCnt = 0, i = 0, j = 0, nRet = -EXIT_FAILURE;
+	bool bStep = false, bTryCaller = false;
+
+	/* One writer at a time, from the first read to the append */
+	if((nRet = scapi_nmStoreOpen(&xStore, pxFiles->pcConf, pxFiles->pcLock, true)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"[%s:%d] %s open/lock failed ret:%d\n", __func__, __LINE__, pxFiles->pcConf, nRet);
+		goto returnHandler;
+	}
+	/* The base mac itself is handed out first, as long as nothing is assigned */
+	bStep = (xStore.nCnt != 0);
+
+	if((nRet = scapi_loadUsedMacs(&xUsed, &xStore, ppcIfnames, nCount, pxFiles->bSystem)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"Unable to validate the mac with interfaces ret=%d\n",nRet);
+		goto returnHandler;
+	}
+	if(bGlobal == true)
+	{
+		if(scapi_resvPoolLoad(pxFiles->pcTable, pxFiles->pcSidecar, &xPool) != EXIT_SUCCESS)
+		{
+			nRet = ERR_MACADDRESS_POOL_EXHAUSTED;
+			fprintf(stderr, " [%s:%d] Reserved mac list not available\n",__func__,__LINE__);
+			goto returnHandler;
+		}
+		scapi_resvPoolMarkUsed(&xPool, &xUsed);
+	}
+	else
+	{
+		pxIfr->ifr_hwaddr.sa_data[0] = 2;
+	}
+
+	for(i = 0; i < nCount; i++)
+	{
+		/* Already assigned, in the file or earlier in this batch */
+		if((pxRec = scapi_nmStoreFind(&xStore, ppcIfnames[i])) != NULL && scapi_isValidMac(pxRec->sMac) == EXIT_SUCCESS)
+		{
+			strncpy_s(ppcMacs[i], SCAPI_MAC_LEN, pxRec->sMac, SCAPI_MAC_LEN - 1);
+			continue;
+		}
+
+		bTryCaller = (ppcMacs[i][0] != '\0' && nMacModified != 1);
+		if(bGlobal == true)
+		{
+			if((nRet = scapi_resvPoolNext(&xPool, pxIfr, bStep, bTryCaller, ppcMacs[i])) != EXIT_SUCCESS)
+				goto returnHandler;
+		}
+		else
+		{
+			if(bTryCaller)
+			{
+				ppcMacs[i][0] = '0';
+				ppcMacs[i][1] = '2';
+				nRet = scapi_validateMacaddr(&xUsed, ppcMacs[i]);
+			}
+			else
+			{
+				nRet = -MAC_IN_USE;
+			}
+			/* Candidates before pxIfr are all taken, so it only ever moves forward */
+			for(nCnt = 0; nRet == -MAC_IN_USE && nCnt < MAX_CNT; nCnt++)
+			{
+				if(bStep && (nRet = scapi_incrementMacaddr(pxIfr, bGlobal)) != EXIT_SUCCESS)
+				{
+					fprintf(stderr, "[%s:%d] Next incrementMacAddr API failed \n", __func__,__LINE__); 
+					goto returnHandler;
+				}
+				bStep = true;
+				SNPRINTF_GET_MAC(ppcMacs[i], SCAPI_MAC_LEN, "%.2x:%.2x:%.2x:%.2x:%.2x:%.2x",
+						(unsigned char)pxIfr->ifr_hwaddr.sa_data[0],
+						(unsigned char)pxIfr->ifr_hwaddr.sa_data[1],
+						(unsigned char)pxIfr->ifr_hwaddr.sa_data[2],
+						(unsigned char)pxIfr->ifr_hwaddr.sa_data[3],
+						(unsigned char)pxIfr->ifr_hwaddr.sa_data[4],
+						(unsigned char)pxIfr->ifr_hwaddr.sa_data[5]);
+				nRet = scapi_validateMacaddr(&xUsed, ppcMacs[i]);
+			}
+			if(nRet != EXIT_SUCCESS)
+			{
+				fprintf(stderr,"Unable to validate the mac with interfaces ret=%d\n",nRet);
+				goto returnHandler;
+			}
+		}
+
+		/* Taken for the rest of the batch */
+		scapi_macToU64(ppcMacs[i], &ullMac);
+		if((nRet = scapi_macSetAdd(&xUsed, ullMac)) != EXIT_SUCCESS)
+			goto returnHandler;
+		if(bGlobal == true && ullMac >= xPool.ullBase && ullMac - xPool.ullBase < xPool.unSpan)
+			scapi_bitSet(xPool.pullUsed, (uint32_t)(ullMac - xPool.ullBase));
+		bStep = true;
+
+		if((nRet = scapi_nmStoreSet(&xStore, ppcIfnames[i], ppcMacs[i])) != EXIT_SUCCESS)
+			goto returnHandler;
+	}
+
+	if((nRet = scapi_nmStoreCommit(&xStore)) != EXIT_SUCCESS)
+	{
+		fprintf(stderr,"[%s:%d] next_mac_conf file update failed ret:%d\n", __func__, __LINE__, nRet);
+		goto returnHandler;
+	}
+	nRet = EXIT_SUCCESS;
+	LOGF_LOG_INFO("Macs Generated for %d interfaces\n", nCount);
+returnHandler:
+	if(nRet != EXIT_SUCCESS && ppcMacs != NULL)
+		for(j = 0; j < nCount; j++)
+			ppcMacs[j][0] = '\0';
+	scapi_nmStoreClose(&xStore);
+	scapi_macSetFree(&xUsed);
+	scapi_resvPoolFree(&xPool);
+	return nRet;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_nextMacBatchCheck
+ **
+ **   Description      :Input validation shared by the batch APIs
+ **
+ ** ============================================================================
+ */
+static int scapi_nextMacBatchCheck(char **ppcIfnames, int nCount, char **ppcMacs)
+{
+	int i = 0;
+
+	if(ppcIfnames == NULL || ppcMacs == NULL || nCount <= 0)
+		return ERR_INPUT_VALIDATION_FAILED;
+	for(i = 0; i < nCount; i++)
+	{
+		if(ppcIfnames[i] == NULL || ppcMacs[i] == NULL || ppcIfnames[i][0] == '\0' ||
+				strnlen_s(ppcIfnames[i], IFNAMSIZ) >= IFNAMSIZ)
+		{
+			LOGF_LOG_CRITICAL("Invalid interface name or mac buffer at index %d\n", i);
+			return ERR_INPUT_VALIDATION_FAILED;
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_getNextMacaddrBatch
+ **
+ **   Description      :Gets next mac addresses of several interfaces and saves
+ **			them in config file, all or none
+ **
+ **   Parameters       :ppcIfnames(IN) -> interface names
+ **			nCount(IN) -> number of interfaces
+ **			bGlobal(IN) -> global or private macs
+ **			ppcMacs(INOUT) -> resultant mac addresses
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values 
+ ** 
+ **   Notes            :Top layer should allocate nCount NULL terminated arrays of size SCAPI_MAC_LEN
+ **
+ ** ============================================================================
+ */
+int scapi_getNextMacaddrBatch(char **ppcIfnames, int nCount, bool bGlobal, char **ppcMacs)
+{
+	static const NextMacFiles_t xFiles = { NEXT_MAC_CONF, NEXT_MAC_LOCK, SUPPORTED_MAC_TABLE_FILE, RESV_MAC_SIDECAR_FILE, true };
+	struct ifreq xIfr = {.ifr_ifru={0}};
+	char sBaseMac[SCAPI_MAC_LEN] = {0};
+	int nMacModified = 0, nRet = -EXIT_FAILURE;
+
+	if((nRet = scapi_nextMacBatchCheck(ppcIfnames, nCount, ppcMacs)) != EXIT_SUCCESS)
+		goto returnHandler;
+	if((nRet = scapi_nextMacPrep(ppcIfnames[0], &xIfr, sBaseMac, &nMacModified)) != EXIT_SUCCESS)
+		goto returnHandler;
+	nRet = scapi_nextMacBatch(&xFiles, &xIfr, nMacModified, ppcIfnames, nCount, bGlobal, ppcMacs);
+returnHandler:
+	return nRet;
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :scapi_getMbssidNextMacaddrBatch
+ **
+ **   Description      :Gets next 6g mac addresses of several interfaces and saves
+ **			them in config file, all or none
+ **
+ **   Parameters       :ppcIfnames(IN) -> interface names
+ **			nCount(IN) -> number of interfaces
+ **			bGlobal(IN) -> global or private macs
+ **			ppcMacs(INOUT) -> resultant mac addresses
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values 
+ ** 
+ **   Notes            :Top layer should allocate nCount NULL terminated arrays of size SCAPI_MAC_LEN
+ **
+ ** ============================================================================
+ */
+int scapi_getMbssidNextMacaddrBatch(char **ppcIfnames, int nCount, bool bGlobal, char **ppcMacs)
+{
+	static const NextMacFiles_t xFiles = { NEXT_MAC_6g_CONF, NEXT_MAC_6g_LOCK, SUPPORTED_6G_MAC_TABLE_FILE, RESV_MAC_6G_SIDECAR_FILE, false };
+	struct ifreq xIfr = {.ifr_ifru={0}};
+	char sBaseMac[SCAPI_MAC_LEN] = {0};
+	int nMacModified = 0, nRet = -EXIT_FAILURE;
+
+	if((nRet = scapi_nextMacBatchCheck(ppcIfnames, nCount, ppcMacs)) != EXIT_SUCCESS)
+		goto returnHandler;
+	if((nRet = scapi_nextMac6gPrep(ppcIfnames[0], &xIfr, sBaseMac, &nMacModified)) != EXIT_SUCCESS)
+		goto returnHandler;
+	nRet = scapi_nextMacBatch(&xFiles, &xIfr, nMacModified, ppcIfnames, nCount, bGlobal, ppcMacs);
+returnHandler:
 	return nRet;
 }
 /* 
@@ -1647,11 +2321,8 @@ end:
 int scapi_getReserevdMac(INOUT ResvMAC **pxMac, INOUT int *nResCnt)
 {
 	int32_t nMacMaxCnt=0,nResMacCnt=0,nCnt=0,nRet=EXIT_SUCCESS;
-	unsigned char mac_addr[MAC_ADDR_BYTES]={0};
-	char *pcTmp=NULL,*pcSavePtr=NULL;
 	char sBuf[SCAPI_MAC_LEN]={0};
-	unsigned int nMacCurIdx=MAC_ADDR_BYTES-1,nPranetIdx=MAC_ADDR_BYTES-2;
-	size_t len=0;
+	uint64_t ullMac=0;
 
 	if (scapi_getRunTimeVal("sup_mac", &nMacMaxCnt) != EXIT_SUCCESS)
 	{
@@ -1680,19 +2351,11 @@ int scapi_getReserevdMac(INOUT ResvMAC **pxMac, INOUT int *nResCnt)
 		goto returnHandler;
 	}
 
-	if((len=strnlen_s(sBuf,SCAPI_MAC_LEN)) <= 0){
-		LOGF_LOG_ERROR("Fetching len failed\n");
+	if(scapi_macToU64(sBuf, &ullMac) != EXIT_SUCCESS){
+		LOGF_LOG_ERROR("Invalid base mac\n");
 		nRet = -EXIT_FAILURE;
 		goto returnHandler;
 	}
-	pcTmp=strtok_s(sBuf,&len, ":",&pcSavePtr);
-	nCnt=0;
-	while(pcTmp!=NULL)
-	{
-		sscanf_s (pcTmp,"%hhx",&(mac_addr[nCnt]));
-		nCnt++;
-		pcTmp=strtok_s(NULL,&len, ":",&pcSavePtr);
-	}	
 
 	nCnt = nMacMaxCnt-nResMacCnt;
 
@@ -1704,11 +2367,9 @@ int scapi_getReserevdMac(INOUT ResvMAC **pxMac, INOUT int *nResCnt)
 		goto returnHandler;
 	}
 
-	while (nCnt>1)	
-	{
-		scapi_incMacAddr(mac_addr, &nMacCurIdx, &nPranetIdx, MAX_U8_VAL);
-		nCnt--;
-	}
+	/* Reserved macs follow the pool */
+	if(nCnt > 1)
+		ullMac += nCnt - 1;
 
 
 	*pxMac=(ResvMAC *)malloc(nResMacCnt * sizeof(ResvMAC));
@@ -1720,11 +2381,12 @@ int scapi_getReserevdMac(INOUT ResvMAC **pxMac, INOUT int *nResCnt)
 	}
 	for(nCnt=0; nCnt<nResMacCnt; nCnt++)
 	{
-		scapi_incMacAddr(mac_addr, &nMacCurIdx, &nPranetIdx, MAX_U8_VAL);
-
-		SNPRINTF_GET_MAC((*pxMac+nCnt)->pcMac,SCAPI_MAC_LEN, "%02x:%02x:%02x:%02x:%02x:%02x", 
-				mac_addr[0], mac_addr[1], mac_addr[2], 
-				mac_addr[3], mac_addr[4], mac_addr[5]);
+		ullMac++;
+		if(scapi_u64ToMac(ullMac, (*pxMac+nCnt)->pcMac) != EXIT_SUCCESS)
+		{
+			nRet = -EXIT_FAILURE;
+			goto returnHandler;
+		}
 	}
 returnHandler:
 	return nRet;
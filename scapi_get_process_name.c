@@ -30,82 +30,194 @@
 #include <errno.h>
 #include <stdio.h> 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
-#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include <ltq_api_include.h>
+#include <scapi_procscan.h>
 
 #define FAIL "INVAL PROCESS"
+
+/* Number of /proc/PID/stat descriptors kept open for repeated lookups */
+#define PROC_NAME_CACHE_SIZE 8
+
+/* A kept stat descriptor, identifies one process for as long as it lives */
+typedef struct {
+	pid_t nPid;
+	uint64_t ullStartTime;
+	int nStatFd;
+	dev_t xDev;
+	ino_t xIno;
+	unsigned int unLastUse;
+} ProcNameEnt_t;
+
+static pthread_mutex_t xProcNameLock = PTHREAD_MUTEX_INITIALIZER;
+static ProcNameEnt_t axProcNameCache[PROC_NAME_CACHE_SIZE];
+static unsigned int unProcNameClock = 0;
+static pid_t nProcNameOwner = 0;
+
+/* Checks the descriptor number still refers to the file it was kept for,
+ * the application may have closed it (daemonizing) and reused the number */
+static bool procNameEntValid(const ProcNameEnt_t *pxEnt)
+{
+	struct stat xSt;
+
+	return fstat(pxEnt->nStatFd, &xSt) == 0 && xSt.st_dev == pxEnt->xDev && xSt.st_ino == pxEnt->xIno;
+}
+
+static void procNameEntDrop(ProcNameEnt_t *pxEnt)
+{
+	if(procNameEntValid(pxEnt))
+		close(pxEnt->nStatFd);
+	memset(pxEnt, 0, sizeof(*pxEnt));
+}
+
+static void procNameEntKeep(pid_t nPid, uint64_t ullStartTime, int nStatFd)
+{
+	ProcNameEnt_t *pxVictim = &axProcNameCache[0];
+	struct stat xSt;
+	int i = 0;
+
+	if(fstat(nStatFd, &xSt) != 0)
+	{
+		close(nStatFd);
+		return;
+	}
+	for(i = 0; i < PROC_NAME_CACHE_SIZE; i++)
+	{
+		/* a dead process with the same pid is replaced in place */
+		if(axProcNameCache[i].nPid == nPid)
+		{
+			pxVictim = &axProcNameCache[i];
+			break;
+		}
+		if(axProcNameCache[i].nPid == 0)
+			pxVictim = &axProcNameCache[i];
+		else if(pxVictim->nPid != 0 && axProcNameCache[i].unLastUse < pxVictim->unLastUse)
+			pxVictim = &axProcNameCache[i];
+	}
+	if(pxVictim->nPid != 0)
+		procNameEntDrop(pxVictim);
+	pxVictim->nPid = nPid;
+	pxVictim->ullStartTime = ullStartTime;
+	pxVictim->nStatFd = nStatFd;
+	pxVictim->xDev = xSt.st_dev;
+	pxVictim->xIno = xSt.st_ino;
+	pxVictim->unLastUse = ++unProcNameClock;
+}
+
 /* 
 ** =============================================================================
-**   Function Name    :	scapi_get_process_name
+**   Function Name    :	scapi_get_process_name_r
 **
-**   Description      :	Gets process name from process number
+**   Description      :	Gets process name from process number into a caller
+**			buffer. The stat descriptors of the last
+**			PROC_NAME_CACHE_SIZE processes are kept open, so a
+**			repeated lookup costs one pread() instead of an open
 **
-**   Parameters       :	process_num(IN) -> Process number
+**   Parameters       :	nPid(IN) -> Process number
+**			pcBuf(OUT) -> Process name
+**			unLen(IN) -> size of pcBuf, longer names are truncated
 **
-**   Return Value     :	Success -> Process name string
-**			Failure -> FAIL
+**   Return Value     :	Success -> EXIT_SUCCESS
+**			Failure -> -EINVAL / -ENOENT if there is no such process
 ** 
-**   Notes            :  
+**   Notes            :  Entries are keyed by (pid, start time): a kept
+**			descriptor stops reading once its process is reaped,
+**			so a reused pid is never answered with the old name
 **
 ** ============================================================================
 */
-
-char process_name[16]; /*  To BSS */
-
-char* scapi_get_process_name(IN pid_t process_num)
+int scapi_get_process_name_r(pid_t nPid, char *pcBuf, size_t unLen)
 {
-	char* ret = NULL;
-	char cBuff[128] = {0};
-	if (sprintf_s(cBuff, sizeof(cBuff), "/proc/%d/stat", (int)process_num) <= 0) {
-                fprintf( stderr, "Error : sprintf_s failed %s:%d %s\n", __func__, __LINE__, strerror(errno)); 
-		return FAIL;
+	char sStat[SCAPI_PROC_STAT_LEN];
+	char *pcComm = NULL;
+	uint64_t ullStart = 0;
+	pid_t nSelf = getpid();
+	int i = 0, nFd = -1, nDirFd = -1, nRet = -EXIT_FAILURE;
+
+	if(pcBuf == NULL || unLen == 0 || nPid <= 0)
+		return -EINVAL;
+
+	pthread_mutex_lock(&xProcNameLock);
+	/* after fork, the inherited descriptors belong to the parent's bookkeeping */
+	if(nProcNameOwner != nSelf)
+	{
+		for(i = 0; i < PROC_NAME_CACHE_SIZE; i++)
+			if(axProcNameCache[i].nPid != 0)
+				procNameEntDrop(&axProcNameCache[i]);
+		nProcNameOwner = nSelf;
 	}
-	char* start = NULL, *end = NULL;
 
-
-	FILE* process_stat_file = scapi_getFilePtr(cBuff, "r");
-	if(NULL == process_stat_file)
+	for(i = 0; i < PROC_NAME_CACHE_SIZE; i++)
 	{
-		ret = FAIL; /* String literals are stored in data/code memory of the process. So no prob */
-		goto returnHandler;
+		if(axProcNameCache[i].nPid != nPid)
+			continue;
+		if(procNameEntValid(&axProcNameCache[i]) &&
+				scapi_procReadStatFd(axProcNameCache[i].nStatFd, sStat, sizeof(sStat), &pcComm, &ullStart) == EXIT_SUCCESS &&
+				ullStart == axProcNameCache[i].ullStartTime)
+		{
+			axProcNameCache[i].unLastUse = ++unProcNameClock;
+			goto found;
+		}
+		procNameEntDrop(&axProcNameCache[i]);
+		break;
 	}
 
-	/*  Using the same cBuff for reading line. Reading one line is enough as process
-	 *  name will definetely be in first line */
-	if(NULL == fgets(cBuff, sizeof(cBuff), process_stat_file))
+	if((nDirFd = scapi_procDirFd()) < 0)
 	{
-		ret = FAIL;
+		nRet = nDirFd;
 		goto returnHandler;
 	}
-	if(NULL == (start = strchr(cBuff, '(') ))
+	if((nFd = scapi_procOpenStat(nDirFd, nPid)) < 0)
 	{
-		ret = FAIL;
+		nRet = nFd;
 		goto returnHandler;
 	}
-
-	++start;
-
-	if(NULL == (end = strchr(cBuff, ')') ))
+	if((nRet = scapi_procReadStatFd(nFd, sStat, sizeof(sStat), &pcComm, &ullStart)) != EXIT_SUCCESS)
 	{
-		ret = FAIL;
+		close(nFd);
 		goto returnHandler;
 	}
-	/*  null terminating after our string of interest */
-	*end = '\0';
-	memset(process_name, 0, sizeof(process_name));
-	if (sprintf_s(process_name, sizeof(process_name), "%s", start) <= 0) {
-                fprintf( stderr, "Error : sprintf_s failed %s:%d %s\n", __func__, __LINE__, strerror(errno)); 
-		ret = FAIL;
+	procNameEntKeep(nPid, ullStart, nFd);
+
+found:
+	if(strncpy_s(pcBuf, unLen, pcComm, unLen - 1) != EOK)
+	{
+		nRet = -EINVAL;
 		goto returnHandler;
 	}
-	ret = process_name;
-
+	nRet = EXIT_SUCCESS;
 returnHandler:
-	if(process_stat_file != NULL)
-		fclose(process_stat_file);
-	return ret;
+	pthread_mutex_unlock(&xProcNameLock);
+	return nRet;
 }
 
+/* 
+** =============================================================================
+**   Function Name    :	scapi_get_process_name
+**
+**   Description      :	Gets process name from process number
+**
+**   Parameters       :	process_num(IN) -> Process number
+**
+**   Return Value     :	Success -> Process name string
+**			Failure -> FAIL
+** 
+**   Notes            :  The name is kept in a per thread buffer, valid until
+**			the next call from the same thread
+**
+** ============================================================================
+*/
+
+static __thread char process_name[SCAPI_PROC_COMM_LEN + 1];
 
+char* scapi_get_process_name(IN pid_t process_num)
+{
+	if(scapi_get_process_name_r(process_num, process_name, sizeof(process_name)) != EXIT_SUCCESS)
+		return FAIL; /* String literals are stored in data/code memory of the process. So no prob */
+	return process_name;
+}
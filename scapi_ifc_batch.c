@@ -0,0 +1,728 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_ifc_batch.c                                          *
+ *     Project    : UGW                                                        *
+ *     Description: Batched interface configuration, all operations of a batch *
+ *                  are sent as one rtnetlink message stream                   *
+ *                                                                             *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <linux/if.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+#include <scapi_netlink.h>
+
+#ifndef NETLINK_CAP_ACK
+#define NETLINK_CAP_ACK 10
+#endif
+
+/* Requests per sendmsg, keeps the acks of one chunk within the default
+ * socket receive buffer */
+#define IFC_BATCH_CHUNK_MSGS 128
+/* Acks read per recvmmsg, only the nlmsgerr header of each is needed */
+#define IFC_BATCH_ACK_VLEN 64
+#define IFC_BATCH_ACK_LEN 128
+/* Largest single request built by this file */
+#define IFC_BATCH_MSG_MAX 128
+#define IFC_BATCH_OP_PENDING 1
+
+typedef struct {
+	int nOp;		/* operation the message belongs to */
+	bool bIgnoreMissing;	/* removal of an address that may already be gone */
+	bool bAcked;
+} IfcBatchMsg_t;
+
+struct IfcBatch {
+	char *pcBuf;		/* request stream, sequence of nlmsghdr */
+	uint32_t unLen;
+	uint32_t unCap;
+	IfcBatchMsg_t *pxMsgs;	/* indexed by nlmsg_seq - 1 */
+	int nMsgCnt;
+	int nMsgCap;
+	int *pnOpRet;		/* per operation result */
+	int nOpCnt;
+	int nOpCap;
+	bool bCommitted;	/* pnOpRet holds the results of the last commit */
+};
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchAddAttr
+ **
+ **   Description      :Appends a rtattr to a request being built on the stack
+ **
+ ** ============================================================================
+ */
+static void scapi_ifcBatchAddAttr(struct nlmsghdr *pxNlh, uint16_t unType, const void *pvData, uint16_t unLen)
+{
+	struct rtattr *pxRta = (struct rtattr *)((char *)pxNlh + NLMSG_ALIGN(pxNlh->nlmsg_len));
+
+	pxRta->rta_type = unType;
+	pxRta->rta_len = RTA_LENGTH(unLen);
+	memcpy(RTA_DATA(pxRta), pvData, unLen);
+	pxNlh->nlmsg_len = NLMSG_ALIGN(pxNlh->nlmsg_len) + RTA_ALIGN(pxRta->rta_len);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchNewOp
+ **
+ **   Description      :Reserves the result slot of a new operation
+ **
+ **   Return Value     :Success -> operation index
+ **			Failure -> -ENOMEM
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcBatchNewOp(IfcBatch_t *pxBatch)
+{
+	int *pnNew = NULL;
+
+	/* The first operation after a commit starts a new set of results */
+	if(pxBatch->bCommitted)
+	{
+		pxBatch->nOpCnt = 0;
+		pxBatch->bCommitted = false;
+	}
+	if(pxBatch->nOpCnt == pxBatch->nOpCap)
+	{
+		pnNew = realloc(pxBatch->pnOpRet, (pxBatch->nOpCap ? pxBatch->nOpCap * 2 : 16) * sizeof(int));
+		if(pnNew == NULL)
+			return -ENOMEM;
+		pxBatch->pnOpRet = pnNew;
+		pxBatch->nOpCap = pxBatch->nOpCap ? pxBatch->nOpCap * 2 : 16;
+	}
+	pxBatch->pnOpRet[pxBatch->nOpCnt] = IFC_BATCH_OP_PENDING;
+	return pxBatch->nOpCnt++;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchAppend
+ **
+ **   Description      :Copies a request to the batch, giving it the next
+ **			sequence number and asking the kernel for an ack
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -ENOMEM
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcBatchAppend(IfcBatch_t *pxBatch, int nOp, struct nlmsghdr *pxNlh, bool bIgnoreMissing)
+{
+	IfcBatchMsg_t *pxNewMsgs = NULL;
+	char *pcNew = NULL;
+	uint32_t unNeed = pxBatch->unLen + NLMSG_ALIGN(pxNlh->nlmsg_len);
+
+	if(unNeed > pxBatch->unCap)
+	{
+		pcNew = realloc(pxBatch->pcBuf, (unNeed > pxBatch->unCap * 2) ? unNeed : pxBatch->unCap * 2);
+		if(pcNew == NULL)
+			return -ENOMEM;
+		pxBatch->pcBuf = pcNew;
+		pxBatch->unCap = (unNeed > pxBatch->unCap * 2) ? unNeed : pxBatch->unCap * 2;
+	}
+	if(pxBatch->nMsgCnt == pxBatch->nMsgCap)
+	{
+		pxNewMsgs = realloc(pxBatch->pxMsgs, (pxBatch->nMsgCap ? pxBatch->nMsgCap * 2 : 16) * sizeof(*pxNewMsgs));
+		if(pxNewMsgs == NULL)
+			return -ENOMEM;
+		pxBatch->pxMsgs = pxNewMsgs;
+		pxBatch->nMsgCap = pxBatch->nMsgCap ? pxBatch->nMsgCap * 2 : 16;
+	}
+
+	pxNlh->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+	pxNlh->nlmsg_seq = pxBatch->nMsgCnt + 1;
+	memcpy(pxBatch->pcBuf + pxBatch->unLen, pxNlh, pxNlh->nlmsg_len);
+	memset(pxBatch->pcBuf + pxBatch->unLen + pxNlh->nlmsg_len, 0, NLMSG_ALIGN(pxNlh->nlmsg_len) - pxNlh->nlmsg_len);
+	pxBatch->unLen = unNeed;
+
+	pxBatch->pxMsgs[pxBatch->nMsgCnt].nOp = nOp;
+	pxBatch->pxMsgs[pxBatch->nMsgCnt].bIgnoreMissing = bIgnoreMissing;
+	pxBatch->pxMsgs[pxBatch->nMsgCnt].bAcked = false;
+	pxBatch->nMsgCnt++;
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchIfindex
+ **
+ **   Description      :Index of an interface
+ **
+ **   Return Value     :Success -> ifindex
+ **			Failure -> -EINVAL, -ENODEV
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcBatchIfindex(const char *pcIfname)
+{
+	struct ifreq xIfr = {.ifr_ifru={0}};
+	int nRet = -EXIT_FAILURE;
+
+	if(pcIfname == NULL || strnlen_s(pcIfname, IFNAMSIZ) >= IFNAMSIZ)
+		return -EINVAL;
+	if(strncpy_s(xIfr.ifr_name, IFNAMSIZ, pcIfname, IFNAMSIZ - 1) != EOK)
+		return -EINVAL;
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFINDEX, &xIfr)) < 0)
+		return nRet;
+	return xIfr.ifr_ifindex;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchLinkOp
+ **
+ **   Description      :Queues a RTM_NEWLINK request changing one attribute or
+ **			the IFF_UP flag of an existing interface
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcBatchLinkOp(IfcBatch_t *pxBatch, const char *pcIfname,
+		uint32_t unFlags, uint32_t unChange, uint16_t unAttr, const void *pvData, uint16_t unLen)
+{
+	union {
+		struct nlmsghdr xNlh;
+		char acBuf[IFC_BATCH_MSG_MAX];
+	} xReq;
+	struct ifinfomsg *pxIfi = NLMSG_DATA(&xReq.xNlh);
+	int nIfindex = 0, nOp = -EXIT_FAILURE, nRet = -EXIT_FAILURE;
+
+	if(pxBatch == NULL)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	if((nIfindex = scapi_ifcBatchIfindex(pcIfname)) < 0)
+	{
+		nRet = nIfindex;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	memset(&xReq, 0, sizeof(xReq));
+	xReq.xNlh.nlmsg_len = NLMSG_LENGTH(sizeof(*pxIfi));
+	xReq.xNlh.nlmsg_type = RTM_NEWLINK;
+	pxIfi->ifi_family = AF_UNSPEC;
+	pxIfi->ifi_index = nIfindex;
+	pxIfi->ifi_flags = unFlags;
+	pxIfi->ifi_change = unChange;
+	if(pvData != NULL)
+		scapi_ifcBatchAddAttr(&xReq.xNlh, unAttr, pvData, unLen);
+
+	if((nOp = scapi_ifcBatchNewOp(pxBatch)) < 0)
+	{
+		nRet = nOp;
+		goto returnHandler;
+	}
+	if((nRet = scapi_ifcBatchAppend(pxBatch, nOp, &xReq.xNlh, false)) < 0)
+	{
+		pxBatch->nOpCnt--;
+		goto returnHandler;
+	}
+	nRet = nOp;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchAddrMsg
+ **
+ **   Description      :Builds a RTM_NEWADDR/RTM_DELADDR request for an ipv4
+ **			address, with the broadcast address ifconfig would use
+ **
+ ** ============================================================================
+ */
+static void scapi_ifcBatchAddrMsg(struct nlmsghdr *pxNlh, uint16_t unType, int nIfindex,
+		struct in_addr xAddr, uint8_t ucPrefixLen)
+{
+	struct ifaddrmsg *pxIfa = NLMSG_DATA(pxNlh);
+	struct in_addr xBrd;
+
+	memset(pxNlh, 0, NLMSG_LENGTH(sizeof(*pxIfa)));
+	pxNlh->nlmsg_len = NLMSG_LENGTH(sizeof(*pxIfa));
+	pxNlh->nlmsg_type = unType;
+	if(unType == RTM_NEWADDR)
+		pxNlh->nlmsg_flags = NLM_F_CREATE | NLM_F_REPLACE;
+	pxIfa->ifa_family = AF_INET;
+	pxIfa->ifa_prefixlen = ucPrefixLen;
+	pxIfa->ifa_index = nIfindex;
+	pxIfa->ifa_scope = ((ntohl(xAddr.s_addr) >> 24) == IN_LOOPBACKNET) ? RT_SCOPE_HOST : RT_SCOPE_UNIVERSE;
+	scapi_ifcBatchAddAttr(pxNlh, IFA_LOCAL, &xAddr, sizeof(xAddr));
+	scapi_ifcBatchAddAttr(pxNlh, IFA_ADDRESS, &xAddr, sizeof(xAddr));
+	if(unType == RTM_NEWADDR && ucPrefixLen < 31)
+	{
+		xBrd.s_addr = xAddr.s_addr | htonl(ucPrefixLen ? ~(~0U << (32 - ucPrefixLen)) : ~0U);
+		scapi_ifcBatchAddAttr(pxNlh, IFA_BROADCAST, &xBrd, sizeof(xBrd));
+	}
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchBegin
+ **
+ **   Description      :Starts an empty batch
+ **
+ **   Parameters       :ppxBatch(OUT) -> new batch
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchBegin(IfcBatch_t **ppxBatch)
+{
+	int nRet = -EXIT_FAILURE;
+
+	if(ppxBatch == NULL)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	*ppxBatch = calloc(1, sizeof(IfcBatch_t));
+	if(*ppxBatch == NULL)
+	{
+		nRet = -ENOMEM;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchSetMacaddr
+ **
+ **   Description      :Queues a mac address change
+ **
+ **   Parameters       :pxBatch(IN) -> batch
+ **			pcIfname(IN) -> interface name
+ **			pcMac(IN) -> mac address to be set
+ **
+ **   Return Value     :Success -> operation index, see scapi_ifcBatchResult()
+ **			Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchSetMacaddr(IfcBatch_t *pxBatch, char *pcIfname, char *pcMac)
+{
+	unsigned char aucMac[6] = {0};
+	int nRet = -EXIT_FAILURE;
+
+	if(pcMac == NULL || sscanf_s(pcMac, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+				&aucMac[0], &aucMac[1], &aucMac[2], &aucMac[3], &aucMac[4], &aucMac[5]) != 6)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	nRet = scapi_ifcBatchLinkOp(pxBatch, pcIfname, 0, 0, IFLA_ADDRESS, aucMac, sizeof(aucMac));
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchSetIpaddr
+ **
+ **   Description      :Queues an ipv4 address and netmask change
+ **
+ **   Parameters       :pxBatch(IN) -> batch
+ **			pcIfname(IN) -> interface name
+ **			pcIp(IN) -> ip address to be set
+ **			pcNetmask(IN) -> netmask to be set
+ **
+ **   Return Value     :Success -> operation index, see scapi_ifcBatchResult()
+ **			Failure -> Different -ve values
+ **
+ **   Notes            :Like scapi_setIfcIpaddr() the address replaces the one
+ **			the interface has when the operation is added
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchSetIpaddr(IfcBatch_t *pxBatch, char *pcIfname, char *pcIp, char *pcNetmask)
+{
+	union {
+		struct nlmsghdr xNlh;
+		char acBuf[IFC_BATCH_MSG_MAX];
+	} xReq;
+	struct ifreq xIfr = {.ifr_ifru={0}};
+	IfcSnapshotAddr_t xOld;
+	struct in_addr xAddr, xMask, xOldAddr;
+	uint32_t unMask = 0, unLen = 0;
+	uint8_t ucPrefixLen = 0, ucOldPrefixLen = 0;
+	bool bHaveOld = false;
+	int nIfindex = 0, nOp = -EXIT_FAILURE, nMsgCnt = 0, nRet = -EXIT_FAILURE;
+
+	if(pxBatch == NULL || pcIp == NULL || pcNetmask == NULL ||
+			inet_pton(AF_INET, pcIp, &xAddr) != 1 || inet_pton(AF_INET, pcNetmask, &xMask) != 1)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	/* Only contiguous netmasks have a prefix length */
+	unMask = ntohl(xMask.s_addr);
+	if((~unMask & (~unMask + 1)) != 0)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	ucPrefixLen = (uint8_t)__builtin_popcount(unMask);
+
+	if((nIfindex = scapi_ifcBatchIfindex(pcIfname)) < 0)
+	{
+		nRet = nIfindex;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+
+	/* Current primary address, removed first unless it stays */
+	if((nRet = scapi_ifcCacheGetIpv4(pcIfname, &xOld)) == EXIT_SUCCESS)
+	{
+		bHaveOld = (inet_pton(AF_INET, xOld.sAddr, &xOldAddr) == 1);
+		ucOldPrefixLen = xOld.ucPrefixLen;
+	}
+	else if(nRet == -ENOENT)
+	{
+		xIfr.ifr_addr.sa_family = AF_INET;
+		if(strncpy_s(xIfr.ifr_name, IFNAMSIZ, pcIfname, IFNAMSIZ - 1) == EOK &&
+				scapi_ctrlSockIoctl(SIOCGIFADDR, &xIfr) == EXIT_SUCCESS)
+		{
+			xOldAddr = ((struct sockaddr_in *)&xIfr.ifr_addr)->sin_addr;
+			if(scapi_ctrlSockIoctl(SIOCGIFNETMASK, &xIfr) == EXIT_SUCCESS)
+			{
+				ucOldPrefixLen = (uint8_t)__builtin_popcount(((struct sockaddr_in *)&xIfr.ifr_addr)->sin_addr.s_addr);
+				bHaveOld = true;
+			}
+		}
+	}
+
+	if((nOp = scapi_ifcBatchNewOp(pxBatch)) < 0)
+	{
+		nRet = nOp;
+		goto returnHandler;
+	}
+	unLen = pxBatch->unLen;
+	nMsgCnt = pxBatch->nMsgCnt;
+	if(bHaveOld && (xOldAddr.s_addr != xAddr.s_addr || ucOldPrefixLen != ucPrefixLen))
+	{
+		scapi_ifcBatchAddrMsg(&xReq.xNlh, RTM_DELADDR, nIfindex, xOldAddr, ucOldPrefixLen);
+		if((nRet = scapi_ifcBatchAppend(pxBatch, nOp, &xReq.xNlh, true)) < 0)
+			goto rollback;
+	}
+	scapi_ifcBatchAddrMsg(&xReq.xNlh, RTM_NEWADDR, nIfindex, xAddr, ucPrefixLen);
+	if((nRet = scapi_ifcBatchAppend(pxBatch, nOp, &xReq.xNlh, false)) < 0)
+		goto rollback;
+	nRet = nOp;
+	goto returnHandler;
+rollback:
+	pxBatch->unLen = unLen;
+	pxBatch->nMsgCnt = nMsgCnt;
+	pxBatch->nOpCnt--;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchSetTxQueuelen
+ **
+ **   Description      :Queues a tx queue length change
+ **
+ **   Parameters       :pxBatch(IN) -> batch
+ **			pcIfname(IN) -> interface name
+ **			nTxqueuelen(IN) -> queue len to be set
+ **
+ **   Return Value     :Success -> operation index, see scapi_ifcBatchResult()
+ **			Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchSetTxQueuelen(IfcBatch_t *pxBatch, char *pcIfname, int nTxqueuelen)
+{
+	uint32_t unQlen = (uint32_t)nTxqueuelen;
+
+	if(nTxqueuelen < 0)
+	{
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", -EINVAL, strerror(EINVAL));
+		return -EINVAL;
+	}
+	return scapi_ifcBatchLinkOp(pxBatch, pcIfname, 0, 0, IFLA_TXQLEN, &unQlen, sizeof(unQlen));
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchSetUpdown
+ **
+ **   Description      :Queues bringing an interface up or down, other flags
+ **			are left untouched
+ **
+ **   Parameters       :pxBatch(IN) -> batch
+ **			pcIfname(IN) -> interface name
+ **			updown(IN) -> 0(DOWN), 1(UP)
+ **
+ **   Return Value     :Success -> operation index, see scapi_ifcBatchResult()
+ **			Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchSetUpdown(IfcBatch_t *pxBatch, char *pcIfname, bool updown)
+{
+	return scapi_ifcBatchLinkOp(pxBatch, pcIfname, updown ? IFF_UP : 0, IFF_UP, 0, NULL, 0);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchAck
+ **
+ **   Description      :Records one ack in the result of its operation
+ **
+ **   Return Value     :true if the ack belonged to a pending request
+ **
+ ** ============================================================================
+ */
+static bool scapi_ifcBatchAck(IfcBatch_t *pxBatch, struct nlmsghdr *pxNlh, int nLen)
+{
+	struct nlmsgerr *pxErr = NLMSG_DATA(pxNlh);
+	IfcBatchMsg_t *pxMsg = NULL;
+	int nErr = 0;
+
+	if(!NLMSG_OK(pxNlh, (unsigned int)nLen) || pxNlh->nlmsg_type != NLMSG_ERROR ||
+			nLen < (int)NLMSG_LENGTH(sizeof(*pxErr)) ||
+			pxNlh->nlmsg_seq == 0 || pxNlh->nlmsg_seq > (uint32_t)pxBatch->nMsgCnt)
+		return false;
+	pxMsg = &pxBatch->pxMsgs[pxNlh->nlmsg_seq - 1];
+	if(pxMsg->bAcked)
+		return false;
+	pxMsg->bAcked = true;
+
+	nErr = pxErr->error;
+	if(nErr == -EADDRNOTAVAIL && pxMsg->bIgnoreMissing)
+		nErr = 0;
+	/* First failure of an operation is kept */
+	if(nErr < 0 && pxBatch->pnOpRet[pxMsg->nOp] >= 0)
+		pxBatch->pnOpRet[pxMsg->nOp] = nErr;
+	return true;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchRecvAcks
+ **
+ **   Description      :Waits for the acks of nCount requests, several acks
+ **			are read per system call
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -errno
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcBatchRecvAcks(IfcBatch_t *pxBatch, int nFd, int nCount)
+{
+	struct mmsghdr axMsgs[IFC_BATCH_ACK_VLEN];
+	struct iovec axIov[IFC_BATCH_ACK_VLEN];
+	struct sockaddr_nl axFrom[IFC_BATCH_ACK_VLEN];
+	/* Error acks echo the request, the truncated tail is not needed */
+	char acBuf[IFC_BATCH_ACK_VLEN][IFC_BATCH_ACK_LEN] __attribute__((aligned(NLMSG_ALIGNTO)));
+	int i = 0, nRecv = 0, nLen = 0, nRet = -EXIT_FAILURE;
+
+	while(nCount > 0)
+	{
+		memset(axMsgs, 0, sizeof(axMsgs));
+		for(i = 0; i < IFC_BATCH_ACK_VLEN; i++)
+		{
+			axIov[i].iov_base = acBuf[i];
+			axIov[i].iov_len = IFC_BATCH_ACK_LEN;
+			axMsgs[i].msg_hdr.msg_iov = &axIov[i];
+			axMsgs[i].msg_hdr.msg_iovlen = 1;
+			axMsgs[i].msg_hdr.msg_name = &axFrom[i];
+			axMsgs[i].msg_hdr.msg_namelen = sizeof(axFrom[i]);
+		}
+		/* Block for the first ack, take whatever else is queued */
+		nRecv = recvmmsg(nFd, axMsgs, (nCount < IFC_BATCH_ACK_VLEN) ? nCount : IFC_BATCH_ACK_VLEN, MSG_WAITFORONE, NULL);
+		if(nRecv < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			nRet = -errno;
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		for(i = 0; i < nRecv; i++)
+		{
+			if(axFrom[i].nl_pid != 0)
+				continue;
+			nLen = (axMsgs[i].msg_len < IFC_BATCH_ACK_LEN) ? (int)axMsgs[i].msg_len : IFC_BATCH_ACK_LEN;
+			if(scapi_ifcBatchAck(pxBatch, (struct nlmsghdr *)acBuf[i], nLen))
+				nCount--;
+		}
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchCommit
+ **
+ **   Description      :Sends all queued operations and collects their results.
+ **			Requests go in chunks of up to IFC_BATCH_CHUNK_MSGS
+ **			messages, one sendmsg per chunk, and are applied by the
+ **			kernel in the order they were added
+ **
+ **   Parameters       :pxBatch(IN) -> batch
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS when every operation succeeded
+ **			Failure -> result of the first failed operation or the
+ **			transport error
+ **
+ **   Notes            :A failed operation does not stop the ones after it.
+ **			Per operation results are read with scapi_ifcBatchResult()
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchCommit(IfcBatch_t *pxBatch)
+{
+	struct sockaddr_nl xKernel = {0};
+	struct nlmsghdr *pxNlh = NULL;
+	int nFd = -1, nOne = 1, nMsg = 0, nChunkMsgs = 0, i = 0, nRet = -EXIT_FAILURE;
+	uint32_t unOff = 0, unChunkLen = 0;
+
+	if(pxBatch == NULL)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	if(pxBatch->nMsgCnt == 0)
+	{
+		nRet = EXIT_SUCCESS;
+		goto returnHandler;
+	}
+	if((nFd = scapi_nlOpen(0)) < 0)
+	{
+		nRet = nFd;
+		goto returnHandler;
+	}
+	/* Error acks without the echoed request, best effort */
+	setsockopt(nFd, SOL_NETLINK, NETLINK_CAP_ACK, &nOne, sizeof(nOne));
+	xKernel.nl_family = AF_NETLINK;
+
+	while(nMsg < pxBatch->nMsgCnt)
+	{
+		for(nChunkMsgs = 0, unChunkLen = 0; nMsg + nChunkMsgs < pxBatch->nMsgCnt && nChunkMsgs < IFC_BATCH_CHUNK_MSGS; nChunkMsgs++)
+		{
+			pxNlh = (struct nlmsghdr *)(pxBatch->pcBuf + unOff + unChunkLen);
+			if(unChunkLen + NLMSG_ALIGN(pxNlh->nlmsg_len) > SCAPI_NL_BUF_SIZE)
+				break;
+			unChunkLen += NLMSG_ALIGN(pxNlh->nlmsg_len);
+		}
+		if(sendto(nFd, pxBatch->pcBuf + unOff, unChunkLen, 0, (struct sockaddr *)&xKernel, sizeof(xKernel)) < 0)
+		{
+			nRet = -errno;
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		if((nRet = scapi_ifcBatchRecvAcks(pxBatch, nFd, nChunkMsgs)) < 0)
+			goto returnHandler;
+		nMsg += nChunkMsgs;
+		unOff += unChunkLen;
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	if(pxBatch != NULL && !pxBatch->bCommitted)
+	{
+		for(i = 0; i < pxBatch->nMsgCnt; i++)
+		{
+			/* Requests never acked take the transport error */
+			if(!pxBatch->pxMsgs[i].bAcked && pxBatch->pnOpRet[pxBatch->pxMsgs[i].nOp] >= 0)
+				pxBatch->pnOpRet[pxBatch->pxMsgs[i].nOp] = (nRet < 0) ? nRet : -EIO;
+		}
+		for(i = 0; i < pxBatch->nOpCnt; i++)
+		{
+			if(pxBatch->pnOpRet[i] == IFC_BATCH_OP_PENDING)
+				pxBatch->pnOpRet[i] = EXIT_SUCCESS;
+			else if(pxBatch->pnOpRet[i] < 0 && nRet == EXIT_SUCCESS)
+				nRet = pxBatch->pnOpRet[i];
+		}
+		if(nMsg > 0)
+			scapi_ifcCacheInvalidate();
+		/* Everything was sent, the batch can be reused. The results
+		   stay readable until the next operation is added */
+		pxBatch->unLen = 0;
+		pxBatch->nMsgCnt = 0;
+		pxBatch->bCommitted = true;
+	}
+	if(nFd >= 0)
+		close(nFd);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchResult
+ **
+ **   Description      :Result of one operation of a committed batch
+ **
+ **   Parameters       :pxBatch(IN) -> batch
+ **			nOp(IN) -> index returned when the operation was added
+ **
+ **   Return Value     :EXIT_SUCCESS or -errno reported by the kernel,
+ **			-EINVAL for an unknown index, -EINPROGRESS before commit
+ **
+ ** ============================================================================
+ */
+int scapi_ifcBatchResult(IfcBatch_t *pxBatch, int nOp)
+{
+	if(pxBatch == NULL || nOp < 0 || nOp >= pxBatch->nOpCnt)
+		return -EINVAL;
+	if(pxBatch->pnOpRet[nOp] == IFC_BATCH_OP_PENDING)
+		return -EINPROGRESS;
+	return pxBatch->pnOpRet[nOp];
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcBatchFree
+ **
+ **   Description      :Frees a batch, queued operations are dropped
+ **
+ ** ============================================================================
+ */
+void scapi_ifcBatchFree(IfcBatch_t *pxBatch)
+{
+	if(pxBatch == NULL)
+		return;
+	free(pxBatch->pcBuf);
+	free(pxBatch->pxMsgs);
+	free(pxBatch->pnOpRet);
+	free(pxBatch);
+}
@@ -0,0 +1,744 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_ifc_cache.c                                          *
+ *     Project    : UGW                                                        *
+ *     Description: Opt-in interface state cache kept up to date from the      *
+ *                  rtnetlink link and ipv4 address multicast groups           *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+#include <scapi_netlink.h>
+
+#define IFC_CACHE_BUCKETS 256
+#define IFC_CACHE_MAX_RETRY 3
+#define IFC_CACHE_RETRY_MS 1000
+
+/* Kernel view of one interface: link attributes plus its ipv4 addresses
+ * in the order the kernel keeps them (primaries first) */
+typedef struct IfcCacheEntry {
+	IfcSnapshot_t xLink;
+	IfcSnapshotAddr_t *pxIpv4;
+	int nIpv4Cnt;
+	int nIpv4Cap;
+	struct IfcCacheEntry *pxIdxNext;
+	struct IfcCacheEntry *pxNameNext;
+} IfcCacheEntry_t;
+
+typedef struct {
+	IfcCacheEntry_t *apxByIdx[IFC_CACHE_BUCKETS];
+	IfcCacheEntry_t *apxByName[IFC_CACHE_BUCKETS];
+} IfcCacheTable_t;
+
+static pthread_once_t xIfcCacheOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t xIfcCacheCtlLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_rwlock_t xIfcCacheLock = PTHREAD_RWLOCK_INITIALIZER;
+static IfcCacheTable_t *pxIfcCache = NULL;
+static pthread_t xIfcCacheThread;
+static int nIfcCacheEvFd = -1;
+static int nIfcCacheWakeFd = -1;
+static bool bIfcCacheEnabled = false;
+static bool bIfcCacheStop = false;
+static uint32_t unIfcCacheGen = 0;
+/* Bumped by the setter APIs, unIfcCacheSynced catches up once the cache
+ * thread has drained every notification queued before the bump */
+static uint32_t unIfcCacheSetSeq = 0;
+static uint32_t unIfcCacheSynced = 0;
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheHashName
+ **
+ **   Description      :Bucket of an interface name
+ **
+ ** ============================================================================
+ */
+static uint32_t scapi_ifcCacheHashName(const char *pcIfname)
+{
+	uint32_t unHash = 5381;
+
+	while(*pcIfname != '\0')
+		unHash = unHash * 33 + (unsigned char)*pcIfname++;
+	return unHash % IFC_CACHE_BUCKETS;
+}
+
+static IfcCacheEntry_t *scapi_ifcCacheFindIdx(IfcCacheTable_t *pxTable, int32_t nIfindex)
+{
+	IfcCacheEntry_t *pxEntry = pxTable->apxByIdx[(uint32_t)nIfindex % IFC_CACHE_BUCKETS];
+
+	while(pxEntry != NULL && pxEntry->xLink.nIfindex != nIfindex)
+		pxEntry = pxEntry->pxIdxNext;
+	return pxEntry;
+}
+
+static IfcCacheEntry_t *scapi_ifcCacheFindName(IfcCacheTable_t *pxTable, const char *pcIfname)
+{
+	IfcCacheEntry_t *pxEntry = pxTable->apxByName[scapi_ifcCacheHashName(pcIfname)];
+
+	while(pxEntry != NULL && strncmp(pxEntry->xLink.sIfname, pcIfname, IFNAMSIZ) != 0)
+		pxEntry = pxEntry->pxNameNext;
+	return pxEntry;
+}
+
+static void scapi_ifcCacheUnlinkName(IfcCacheTable_t *pxTable, IfcCacheEntry_t *pxEntry)
+{
+	IfcCacheEntry_t **ppxLink = &pxTable->apxByName[scapi_ifcCacheHashName(pxEntry->xLink.sIfname)];
+
+	while(*ppxLink != NULL && *ppxLink != pxEntry)
+		ppxLink = &(*ppxLink)->pxNameNext;
+	if(*ppxLink != NULL)
+		*ppxLink = pxEntry->pxNameNext;
+	pxEntry->pxNameNext = NULL;
+}
+
+static void scapi_ifcCacheLinkName(IfcCacheTable_t *pxTable, IfcCacheEntry_t *pxEntry)
+{
+	uint32_t unBucket = scapi_ifcCacheHashName(pxEntry->xLink.sIfname);
+
+	pxEntry->pxNameNext = pxTable->apxByName[unBucket];
+	pxTable->apxByName[unBucket] = pxEntry;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheFree
+ **
+ **   Description      :Frees a table and all its entries
+ **
+ ** ============================================================================
+ */
+static void scapi_ifcCacheFree(IfcCacheTable_t *pxTable)
+{
+	IfcCacheEntry_t *pxEntry = NULL, *pxNext = NULL;
+	int i = 0;
+
+	if(pxTable == NULL)
+		return;
+	for(i = 0; i < IFC_CACHE_BUCKETS; i++)
+	{
+		for(pxEntry = pxTable->apxByIdx[i]; pxEntry != NULL; pxEntry = pxNext)
+		{
+			pxNext = pxEntry->pxIdxNext;
+			free(pxEntry->pxIpv4);
+			free(pxEntry);
+		}
+	}
+	free(pxTable);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheApplyLink
+ **
+ **   Description      :Applies a RTM_NEWLINK/RTM_DELLINK message to a table
+ **
+ **   Return Value     :1 if the table changed, 0 if not, -ENOMEM
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcCacheApplyLink(IfcCacheTable_t *pxTable, struct nlmsghdr *pxNlh)
+{
+	IfcCacheEntry_t *pxEntry = NULL, **ppxLink = NULL;
+	IfcSnapshot_t xLink;
+	uint32_t unBucket = 0;
+
+	if(scapi_nlParseLink(pxNlh, &xLink) != EXIT_SUCCESS)
+		return 0;
+	unBucket = (uint32_t)xLink.nIfindex % IFC_CACHE_BUCKETS;
+	pxEntry = scapi_ifcCacheFindIdx(pxTable, xLink.nIfindex);
+
+	if(pxNlh->nlmsg_type == RTM_DELLINK)
+	{
+		if(pxEntry == NULL)
+			return 0;
+		scapi_ifcCacheUnlinkName(pxTable, pxEntry);
+		for(ppxLink = &pxTable->apxByIdx[unBucket]; *ppxLink != pxEntry; ppxLink = &(*ppxLink)->pxIdxNext)
+			;
+		*ppxLink = pxEntry->pxIdxNext;
+		free(pxEntry->pxIpv4);
+		free(pxEntry);
+		return 1;
+	}
+
+	if(pxEntry == NULL)
+	{
+		pxEntry = calloc(1, sizeof(*pxEntry));
+		if(pxEntry == NULL)
+			return -ENOMEM;
+		pxEntry->xLink = xLink;
+		pxEntry->pxIdxNext = pxTable->apxByIdx[unBucket];
+		pxTable->apxByIdx[unBucket] = pxEntry;
+		scapi_ifcCacheLinkName(pxTable, pxEntry);
+		return 1;
+	}
+	if(strncmp(pxEntry->xLink.sIfname, xLink.sIfname, IFNAMSIZ) != 0)
+	{
+		/* renamed */
+		scapi_ifcCacheUnlinkName(pxTable, pxEntry);
+		pxEntry->xLink = xLink;
+		scapi_ifcCacheLinkName(pxTable, pxEntry);
+		return 1;
+	}
+	if(memcmp(&pxEntry->xLink, &xLink, sizeof(xLink)) == 0)
+		return 0;
+	pxEntry->xLink = xLink;
+	return 1;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheApplyAddr
+ **
+ **   Description      :Applies a RTM_NEWADDR/RTM_DELADDR message to a table,
+ **			only ipv4 addresses are tracked
+ **
+ **   Return Value     :1 if the table changed, 0 if not, -ENOMEM
+ **
+ **   Notes            :New primaries go after the last primary, secondaries at
+ **			the end, which is where the kernel puts them
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcCacheApplyAddr(IfcCacheTable_t *pxTable, struct nlmsghdr *pxNlh)
+{
+	IfcCacheEntry_t *pxEntry = NULL;
+	IfcSnapshotAddr_t xAddr, *pxNew = NULL;
+	int32_t nIfindex = 0;
+	int i = 0, nPos = 0;
+
+	if(scapi_nlParseAddr(pxNlh, &nIfindex, &xAddr) != EXIT_SUCCESS || xAddr.ucFamily != AF_INET)
+		return 0;
+	pxEntry = scapi_ifcCacheFindIdx(pxTable, nIfindex);
+	if(pxEntry == NULL)
+		return 0;
+
+	for(i = 0; i < pxEntry->nIpv4Cnt; i++)
+		if(pxEntry->pxIpv4[i].ucPrefixLen == xAddr.ucPrefixLen && strcmp(pxEntry->pxIpv4[i].sAddr, xAddr.sAddr) == 0)
+			break;
+
+	if(pxNlh->nlmsg_type == RTM_DELADDR)
+	{
+		if(i == pxEntry->nIpv4Cnt)
+			return 0;
+		memmove(&pxEntry->pxIpv4[i], &pxEntry->pxIpv4[i + 1], (pxEntry->nIpv4Cnt - i - 1) * sizeof(xAddr));
+		pxEntry->nIpv4Cnt--;
+		return 1;
+	}
+	if(i < pxEntry->nIpv4Cnt)
+	{
+		/* Promotion of a secondary or label/flag change */
+		if((pxEntry->pxIpv4[i].unFlags & IFA_F_SECONDARY) == (xAddr.unFlags & IFA_F_SECONDARY))
+		{
+			if(memcmp(&pxEntry->pxIpv4[i], &xAddr, sizeof(xAddr)) == 0)
+				return 0;
+			pxEntry->pxIpv4[i] = xAddr;
+			return 1;
+		}
+		memmove(&pxEntry->pxIpv4[i], &pxEntry->pxIpv4[i + 1], (pxEntry->nIpv4Cnt - i - 1) * sizeof(xAddr));
+		pxEntry->nIpv4Cnt--;
+	}
+
+	if(pxEntry->nIpv4Cnt == pxEntry->nIpv4Cap)
+	{
+		pxNew = realloc(pxEntry->pxIpv4, (pxEntry->nIpv4Cap + 4) * sizeof(xAddr));
+		if(pxNew == NULL)
+			return -ENOMEM;
+		pxEntry->pxIpv4 = pxNew;
+		pxEntry->nIpv4Cap += 4;
+	}
+	nPos = pxEntry->nIpv4Cnt;
+	if((xAddr.unFlags & IFA_F_SECONDARY) == 0)
+	{
+		for(nPos = 0; nPos < pxEntry->nIpv4Cnt; nPos++)
+			if(pxEntry->pxIpv4[nPos].unFlags & IFA_F_SECONDARY)
+				break;
+	}
+	memmove(&pxEntry->pxIpv4[nPos + 1], &pxEntry->pxIpv4[nPos], (pxEntry->nIpv4Cnt - nPos) * sizeof(xAddr));
+	pxEntry->pxIpv4[nPos] = xAddr;
+	pxEntry->nIpv4Cnt++;
+	return 1;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheApply
+ **
+ **   Description      :netlink callback, applies one message to a table
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcCacheApply(struct nlmsghdr *pxNlh, void *pvArg)
+{
+	IfcCacheTable_t *pxTable = pvArg;
+
+	switch(pxNlh->nlmsg_type)
+	{
+		case RTM_NEWLINK:
+		case RTM_DELLINK:
+			return scapi_ifcCacheApplyLink(pxTable, pxNlh);
+		case RTM_NEWADDR:
+		case RTM_DELADDR:
+			return scapi_ifcCacheApplyAddr(pxTable, pxNlh);
+		default:
+			return 0;
+	}
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheApplyLive
+ **
+ **   Description      :netlink callback for notifications, applies one message
+ **			to the live table under the write lock
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcCacheApplyLive(struct nlmsghdr *pxNlh, void *pvArg)
+{
+	int nRet = 0;
+
+	(void)pvArg;
+	pthread_rwlock_wrlock(&xIfcCacheLock);
+	nRet = scapi_ifcCacheApply(pxNlh, pxIfcCache);
+	if(nRet > 0)
+		__atomic_add_fetch(&unIfcCacheGen, 1, __ATOMIC_RELEASE);
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	return (nRet < 0) ? nRet : EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheLoad
+ **
+ **   Description      :Builds a new table from a link and an ipv4 address dump
+ **
+ **   Parameters       :ppxTable(OUT) -> new table
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcCacheLoad(IfcCacheTable_t **ppxTable)
+{
+	IfcCacheTable_t *pxTable = NULL;
+	int nFd = -1, nTry = 0, nRet = -EXIT_FAILURE;
+
+	nFd = scapi_nlOpen(0);
+	if(nFd < 0)
+	{
+		nRet = nFd;
+		goto returnHandler;
+	}
+	for(nTry = 0; nTry < IFC_CACHE_MAX_RETRY; nTry++)
+	{
+		scapi_ifcCacheFree(pxTable);
+		pxTable = calloc(1, sizeof(*pxTable));
+		if(pxTable == NULL)
+		{
+			nRet = -ENOMEM;
+			goto returnHandler;
+		}
+		nRet = scapi_nlDump(nFd, RTM_GETLINK, AF_UNSPEC, 2 * nTry + 1, scapi_ifcCacheApply, pxTable);
+		if(nRet == EXIT_SUCCESS)
+			nRet = scapi_nlDump(nFd, RTM_GETADDR, AF_INET, 2 * nTry + 2, scapi_ifcCacheApply, pxTable);
+		if(nRet != -EAGAIN)
+			break;
+	}
+	if(nRet < 0)
+	{
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	*ppxTable = pxTable;
+	pxTable = NULL;
+returnHandler:
+	scapi_ifcCacheFree(pxTable);
+	if(nFd >= 0)
+		close(nFd);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheResync
+ **
+ **   Description      :Replaces the live table after the kernel dropped
+ **			notifications (ENOBUFS on the multicast socket)
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> Different -ve values, the cache is off until
+ **			a later resync works
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcCacheResync(void)
+{
+	IfcCacheTable_t *pxTable = NULL, *pxOld = NULL;
+	int nRet = -EXIT_FAILURE;
+
+	if((nRet = scapi_ifcCacheLoad(&pxTable)) != EXIT_SUCCESS)
+	{
+		/* Keep serving from the ioctl path until the next resync works */
+		pthread_rwlock_wrlock(&xIfcCacheLock);
+		bIfcCacheEnabled = false;
+		pthread_rwlock_unlock(&xIfcCacheLock);
+		return nRet;
+	}
+	pthread_rwlock_wrlock(&xIfcCacheLock);
+	pxOld = pxIfcCache;
+	pxIfcCache = pxTable;
+	bIfcCacheEnabled = true;
+	__atomic_add_fetch(&unIfcCacheGen, 1, __ATOMIC_RELEASE);
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	scapi_ifcCacheFree(pxOld);
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheThreadFn
+ **
+ **   Description      :Applies notifications until scapi_ifcCacheDisable()
+ **
+ ** ============================================================================
+ */
+static void *scapi_ifcCacheThreadFn(void *pvArg)
+{
+	struct pollfd axPfd[2];
+	uint64_t ullVal = 0;
+	uint32_t unSeq = 0;
+	bool bResync = false;
+	int nRet = 0;
+
+	(void)pvArg;
+	axPfd[0].fd = nIfcCacheEvFd;
+	axPfd[0].events = POLLIN;
+	axPfd[1].fd = nIfcCacheWakeFd;
+	axPfd[1].events = POLLIN;
+
+	while(!__atomic_load_n(&bIfcCacheStop, __ATOMIC_ACQUIRE))
+	{
+		/* A failed resync is retried until it works, nothing else
+		   may come to trigger it */
+		if((nRet = poll(axPfd, 2, bResync ? IFC_CACHE_RETRY_MS : -1)) < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", -errno, strerror(errno));
+			break;
+		}
+		if(axPfd[1].revents & POLLIN)
+		{
+			if(read(nIfcCacheWakeFd, &ullVal, sizeof(ullVal)) < 0)
+				ullVal = 0;
+		}
+		unSeq = __atomic_load_n(&unIfcCacheSetSeq, __ATOMIC_ACQUIRE);
+		while((nRet = scapi_nlRecv(nIfcCacheEvFd, MSG_DONTWAIT, scapi_ifcCacheApplyLive, NULL)) > 0)
+			;
+		if(nRet == -ENOBUFS || nRet == -ENOMEM)
+			bResync = true;
+		if(bResync)
+			bResync = (scapi_ifcCacheResync() != EXIT_SUCCESS);
+		__atomic_store_n(&unIfcCacheSynced, unSeq, __ATOMIC_RELEASE);
+	}
+	return NULL;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheTeardown
+ **
+ **   Description      :Releases descriptors and the table, thread already gone
+ **
+ ** ============================================================================
+ */
+static void scapi_ifcCacheTeardown(void)
+{
+	IfcCacheTable_t *pxOld = NULL;
+
+	/* scapi_ifcCacheInvalidate() uses the wakeup fd under the lock */
+	pthread_rwlock_wrlock(&xIfcCacheLock);
+	bIfcCacheEnabled = false;
+	pxOld = pxIfcCache;
+	pxIfcCache = NULL;
+	if(nIfcCacheWakeFd >= 0)
+		close(nIfcCacheWakeFd);
+	nIfcCacheWakeFd = -1;
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	scapi_ifcCacheFree(pxOld);
+
+	if(nIfcCacheEvFd >= 0)
+		close(nIfcCacheEvFd);
+	nIfcCacheEvFd = -1;
+}
+
+static void scapi_ifcCacheAtforkPrepare(void)
+{
+	pthread_mutex_lock(&xIfcCacheCtlLock);
+	pthread_rwlock_wrlock(&xIfcCacheLock);
+}
+
+static void scapi_ifcCacheAtforkParent(void)
+{
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	pthread_mutex_unlock(&xIfcCacheCtlLock);
+}
+
+/* The cache thread does not exist in the child, getters fall back to ioctl */
+static void scapi_ifcCacheAtforkChild(void)
+{
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	if(pxIfcCache != NULL || nIfcCacheEvFd >= 0)
+		scapi_ifcCacheTeardown();
+	pthread_mutex_unlock(&xIfcCacheCtlLock);
+}
+
+static void scapi_ifcCacheInit(void)
+{
+	pthread_atfork(scapi_ifcCacheAtforkPrepare, scapi_ifcCacheAtforkParent, scapi_ifcCacheAtforkChild);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheEnable
+ **
+ **   Description      :Loads the interface table and starts following link and
+ **			ipv4 address changes. From then on the scapi_getIfc* getters
+ **			are served from memory
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_ifcCacheEnable(void)
+{
+	IfcCacheTable_t *pxTable = NULL;
+	int nRet = -EXIT_FAILURE;
+
+	pthread_once(&xIfcCacheOnce, scapi_ifcCacheInit);
+	pthread_mutex_lock(&xIfcCacheCtlLock);
+	if(nIfcCacheEvFd >= 0)
+	{
+		nRet = EXIT_SUCCESS;
+		goto returnHandler;
+	}
+
+	/* Subscribe before dumping so that no change falls in between */
+	nIfcCacheEvFd = scapi_nlOpen(RTMGRP_LINK | RTMGRP_IPV4_IFADDR);
+	if(nIfcCacheEvFd < 0)
+	{
+		nRet = nIfcCacheEvFd;
+		goto returnHandler;
+	}
+	nIfcCacheWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if(nIfcCacheWakeFd < 0)
+	{
+		nRet = -errno;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	if((nRet = scapi_ifcCacheLoad(&pxTable)) < 0)
+		goto returnHandler;
+
+	pthread_rwlock_wrlock(&xIfcCacheLock);
+	pxIfcCache = pxTable;
+	bIfcCacheEnabled = true;
+	__atomic_store_n(&unIfcCacheSynced, __atomic_load_n(&unIfcCacheSetSeq, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+	__atomic_add_fetch(&unIfcCacheGen, 1, __ATOMIC_RELEASE);
+	pthread_rwlock_unlock(&xIfcCacheLock);
+
+	__atomic_store_n(&bIfcCacheStop, false, __ATOMIC_RELEASE);
+	if((nRet = pthread_create(&xIfcCacheThread, NULL, scapi_ifcCacheThreadFn, NULL)) != 0)
+	{
+		nRet = -nRet;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	if(nRet < 0)
+		scapi_ifcCacheTeardown();
+	pthread_mutex_unlock(&xIfcCacheCtlLock);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheDisable
+ **
+ **   Description      :Stops the cache, getters go back to ioctl
+ **
+ **   Return Value     :EXIT_SUCCESS
+ **
+ ** ============================================================================
+ */
+int scapi_ifcCacheDisable(void)
+{
+	uint64_t ullOne = 1;
+
+	pthread_mutex_lock(&xIfcCacheCtlLock);
+	if(nIfcCacheEvFd >= 0)
+	{
+		__atomic_store_n(&bIfcCacheStop, true, __ATOMIC_RELEASE);
+		if(write(nIfcCacheWakeFd, &ullOne, sizeof(ullOne)) < 0)
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", -errno, strerror(errno));
+		pthread_join(xIfcCacheThread, NULL);
+		scapi_ifcCacheTeardown();
+	}
+	pthread_mutex_unlock(&xIfcCacheCtlLock);
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheGeneration
+ **
+ **   Description      :Generation counter, incremented on every change applied
+ **			to the cache. Pollers can skip work while it is unchanged
+ **
+ ** ============================================================================
+ */
+uint32_t scapi_ifcCacheGeneration(void)
+{
+	return __atomic_load_n(&unIfcCacheGen, __ATOMIC_ACQUIRE);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheInvalidate
+ **
+ **   Description      :Called by the setter APIs after a successful change.
+ **			Getters bypass the cache until the notification of that
+ **			change has been applied
+ **
+ **   Notes            :The kernel queues the notification before the ioctl or
+ **			netlink request returns, so draining the socket once after
+ **			this call is enough
+ **
+ ** ============================================================================
+ */
+void scapi_ifcCacheInvalidate(void)
+{
+	uint64_t ullOne = 1;
+
+	if(!__atomic_load_n(&bIfcCacheEnabled, __ATOMIC_ACQUIRE))
+		return;
+	/* Teardown closes the wakeup fd under the write lock */
+	pthread_rwlock_rdlock(&xIfcCacheLock);
+	if(nIfcCacheWakeFd >= 0)
+	{
+		__atomic_add_fetch(&unIfcCacheSetSeq, 1, __ATOMIC_ACQ_REL);
+		if(write(nIfcCacheWakeFd, &ullOne, sizeof(ullOne)) < 0)
+			LOGF_LOG_DEBUG("DEBUG = cache wakeup failed %s\n", strerror(errno));
+	}
+	pthread_rwlock_unlock(&xIfcCacheLock);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheUsable
+ **
+ **   Description      :Cache is enabled and has caught up with our own changes
+ **
+ ** ============================================================================
+ */
+static bool scapi_ifcCacheUsable(void)
+{
+	return __atomic_load_n(&bIfcCacheEnabled, __ATOMIC_ACQUIRE) &&
+		__atomic_load_n(&unIfcCacheSynced, __ATOMIC_ACQUIRE) == __atomic_load_n(&unIfcCacheSetSeq, __ATOMIC_ACQUIRE);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheGetLink
+ **
+ **   Description      :Link attributes of an interface from the cache
+ **
+ **   Parameters       :pcIfname(IN) -> interface name
+ **			pxLink(OUT) -> link attributes, no addresses
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -ENOENT when the cache cannot answer, caller
+ **			then asks the kernel
+ **
+ ** ============================================================================
+ */
+int scapi_ifcCacheGetLink(const char *pcIfname, IfcSnapshot_t *pxLink)
+{
+	IfcCacheEntry_t *pxEntry = NULL;
+	int nRet = -ENOENT;
+
+	if(!scapi_ifcCacheUsable())
+		return nRet;
+	pthread_rwlock_rdlock(&xIfcCacheLock);
+	if(bIfcCacheEnabled && pxIfcCache != NULL && (pxEntry = scapi_ifcCacheFindName(pxIfcCache, pcIfname)) != NULL)
+	{
+		*pxLink = pxEntry->xLink;
+		nRet = EXIT_SUCCESS;
+	}
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcCacheGetIpv4
+ **
+ **   Description      :ipv4 address SIOCGIFADDR would return for an interface,
+ **			i.e the first one whose label is the interface name
+ **
+ **   Parameters       :pcIfname(IN) -> interface name
+ **			pxAddr(OUT) -> address and prefix length
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -EADDRNOTAVAIL when the interface has none,
+ **			-ENOENT when the cache cannot answer
+ **
+ ** ============================================================================
+ */
+int scapi_ifcCacheGetIpv4(const char *pcIfname, IfcSnapshotAddr_t *pxAddr)
+{
+	IfcCacheEntry_t *pxEntry = NULL;
+	int i = 0, nRet = -ENOENT;
+
+	if(!scapi_ifcCacheUsable())
+		return nRet;
+	pthread_rwlock_rdlock(&xIfcCacheLock);
+	if(bIfcCacheEnabled && pxIfcCache != NULL && (pxEntry = scapi_ifcCacheFindName(pxIfcCache, pcIfname)) != NULL)
+	{
+		nRet = -EADDRNOTAVAIL;
+		for(i = 0; i < pxEntry->nIpv4Cnt; i++)
+		{
+			if(strncmp(pxEntry->pxIpv4[i].sLabel, pcIfname, IFNAMSIZ) == 0)
+			{
+				*pxAddr = pxEntry->pxIpv4[i];
+				nRet = EXIT_SUCCESS;
+				break;
+			}
+		}
+	}
+	pthread_rwlock_unlock(&xIfcCacheLock);
+	return nRet;
+}
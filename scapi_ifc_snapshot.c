@@ -0,0 +1,282 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_ifc_snapshot.c                                       *
+ *     Project    : UGW                                                        *
+ *     Description: Snapshot of all interfaces and their addresses using one   *
+ *                  rtnetlink link dump and one address dump                   *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+#include <scapi_netlink.h>
+
+/* Number of times a dump interrupted by a concurrent change is redone */
+#define IFC_SNAPSHOT_MAX_RETRY 3
+
+typedef struct {
+	IfcSnapshot_t *pxLinks;
+	int nLinkCnt;
+	int nLinkCap;
+	IfcSnapshotAddr_t *pxAddrs;
+	int32_t *pnAddrIfindex;
+	int nAddrCnt;
+	int nAddrCap;
+} IfcSnapshotCtx_t;
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcSnapshotLinkCb
+ **
+ **   Description      :RTM_GETLINK dump callback, appends one interface
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcSnapshotLinkCb(struct nlmsghdr *pxNlh, void *pvArg)
+{
+	IfcSnapshotCtx_t *pxCtx = pvArg;
+	IfcSnapshot_t *pxNew = NULL;
+
+	if(pxNlh->nlmsg_type != RTM_NEWLINK)
+		return EXIT_SUCCESS;
+
+	if(pxCtx->nLinkCnt == pxCtx->nLinkCap)
+	{
+		pxCtx->nLinkCap = pxCtx->nLinkCap ? pxCtx->nLinkCap * 2 : 32;
+		pxNew = realloc(pxCtx->pxLinks, pxCtx->nLinkCap * sizeof(*pxNew));
+		if(pxNew == NULL)
+			return -ENOMEM;
+		pxCtx->pxLinks = pxNew;
+	}
+	if(scapi_nlParseLink(pxNlh, &pxCtx->pxLinks[pxCtx->nLinkCnt]) == EXIT_SUCCESS)
+		pxCtx->nLinkCnt++;
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcSnapshotAddrCb
+ **
+ **   Description      :RTM_GETADDR dump callback, appends one address
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcSnapshotAddrCb(struct nlmsghdr *pxNlh, void *pvArg)
+{
+	IfcSnapshotCtx_t *pxCtx = pvArg;
+	IfcSnapshotAddr_t *pxNew = NULL;
+	int32_t *pnNewIdx = NULL;
+
+	if(pxNlh->nlmsg_type != RTM_NEWADDR)
+		return EXIT_SUCCESS;
+
+	if(pxCtx->nAddrCnt == pxCtx->nAddrCap)
+	{
+		pxCtx->nAddrCap = pxCtx->nAddrCap ? pxCtx->nAddrCap * 2 : 64;
+		pxNew = realloc(pxCtx->pxAddrs, pxCtx->nAddrCap * sizeof(*pxNew));
+		if(pxNew == NULL)
+			return -ENOMEM;
+		pxCtx->pxAddrs = pxNew;
+		pnNewIdx = realloc(pxCtx->pnAddrIfindex, pxCtx->nAddrCap * sizeof(*pnNewIdx));
+		if(pnNewIdx == NULL)
+			return -ENOMEM;
+		pxCtx->pnAddrIfindex = pnNewIdx;
+	}
+	if(scapi_nlParseAddr(pxNlh, &pxCtx->pnAddrIfindex[pxCtx->nAddrCnt], &pxCtx->pxAddrs[pxCtx->nAddrCnt]) == EXIT_SUCCESS)
+		pxCtx->nAddrCnt++;
+	return EXIT_SUCCESS;
+}
+
+/* ifindex to position in the link table, sorted by ifindex */
+typedef struct {
+	int32_t nIfindex;
+	int nPos;
+} IfcSnapshotOrder_t;
+
+static int scapi_ifcSnapshotCmpOrder(const void *pvA, const void *pvB)
+{
+	int32_t nA = ((const IfcSnapshotOrder_t *)pvA)->nIfindex;
+	int32_t nB = ((const IfcSnapshotOrder_t *)pvB)->nIfindex;
+
+	return (nA > nB) - (nA < nB);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcSnapshotFindLink
+ **
+ **   Description      :Binary search of an ifindex in the link order table
+ **
+ **   Return Value     :position in the link table or -1
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcSnapshotFindLink(IfcSnapshotOrder_t *pxOrder, int nCount, int32_t nIfindex)
+{
+	int nLow = 0, nHigh = nCount - 1, nMid = 0;
+
+	while(nLow <= nHigh)
+	{
+		nMid = nLow + (nHigh - nLow) / 2;
+		if(pxOrder[nMid].nIfindex == nIfindex)
+			return pxOrder[nMid].nPos;
+		if(pxOrder[nMid].nIfindex < nIfindex)
+			nLow = nMid + 1;
+		else
+			nHigh = nMid - 1;
+	}
+	return -1;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_ifcSnapshotBuild
+ **
+ **   Description      :Packs links and addresses into one allocation with the
+ **			addresses of each link stored contiguously, in dump order
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -ENOMEM
+ **
+ ** ============================================================================
+ */
+static int scapi_ifcSnapshotBuild(IfcSnapshotCtx_t *pxCtx, IfcSnapshot_t **ppxSnapshot)
+{
+	IfcSnapshot_t *pxOut = NULL;
+	IfcSnapshotAddr_t *pxOutAddrs = NULL;
+	IfcSnapshotOrder_t *pxOrder = NULL;
+	int *pnAddrLink = NULL, *pnFill = NULL;
+	int i = 0, nPos = 0, nRet = -ENOMEM;
+
+	pxOrder = calloc(pxCtx->nLinkCnt + 1, sizeof(*pxOrder));
+	pnAddrLink = calloc(pxCtx->nAddrCnt + 1, sizeof(int));
+	pnFill = calloc(pxCtx->nLinkCnt + 1, sizeof(int));
+	if(pxOrder == NULL || pnAddrLink == NULL || pnFill == NULL)
+		goto returnHandler;
+
+	for(i = 0; i < pxCtx->nLinkCnt; i++)
+	{
+		pxOrder[i].nIfindex = pxCtx->pxLinks[i].nIfindex;
+		pxOrder[i].nPos = i;
+	}
+	qsort(pxOrder, pxCtx->nLinkCnt, sizeof(*pxOrder), scapi_ifcSnapshotCmpOrder);
+
+	/* Count addresses per link, addresses of links that appeared
+	 * between the two dumps are dropped */
+	for(i = 0; i < pxCtx->nAddrCnt; i++)
+	{
+		pnAddrLink[i] = scapi_ifcSnapshotFindLink(pxOrder, pxCtx->nLinkCnt, pxCtx->pnAddrIfindex[i]);
+		if(pnAddrLink[i] >= 0)
+			pxCtx->pxLinks[pnAddrLink[i]].unAddrCount++;
+	}
+
+	pxOut = malloc(pxCtx->nLinkCnt * sizeof(IfcSnapshot_t) + pxCtx->nAddrCnt * sizeof(IfcSnapshotAddr_t) + 1);
+	if(pxOut == NULL)
+		goto returnHandler;
+	pxOutAddrs = (IfcSnapshotAddr_t *)(pxOut + pxCtx->nLinkCnt);
+
+	for(i = 0; i < pxCtx->nLinkCnt; i++)
+	{
+		pxOut[i] = pxCtx->pxLinks[i];
+		pxOut[i].pxAddrs = pxOutAddrs + nPos;
+		nPos += pxOut[i].unAddrCount;
+	}
+	for(i = 0; i < pxCtx->nAddrCnt; i++)
+	{
+		if(pnAddrLink[i] < 0)
+			continue;
+		pxOut[pnAddrLink[i]].pxAddrs[pnFill[pnAddrLink[i]]++] = pxCtx->pxAddrs[i];
+	}
+	*ppxSnapshot = pxOut;
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	free(pxOrder);
+	free(pnAddrLink);
+	free(pnFill);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_getIfcSnapshot
+ **
+ **   Description      :Gets name, index, flags, mtu, tx queue length, mac and
+ **			all ipv4/ipv6 addresses of every interface at once
+ **
+ **   Parameters       :ppxSnapshot(OUT) -> array of interfaces
+ **			pnCount(OUT) -> number of interfaces in the array
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> Different -ve values
+ **
+ **   Notes            :Array and addresses are one allocation, caller frees
+ **			*ppxSnapshot with free(). Links are returned in dump order
+ **
+ ** ============================================================================
+ */
+int scapi_getIfcSnapshot(IfcSnapshot_t **ppxSnapshot, int *pnCount)
+{
+	IfcSnapshotCtx_t xCtx;
+	int nFd = -1, nTry = 0, nRet = -EXIT_FAILURE;
+
+	memset(&xCtx, 0, sizeof(xCtx));
+	if(ppxSnapshot == NULL || pnCount == NULL)
+	{
+		nRet = -EINVAL;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	*ppxSnapshot = NULL;
+	*pnCount = 0;
+
+	nFd = scapi_nlOpen(0);
+	if(nFd < 0)
+	{
+		nRet = nFd;
+		goto returnHandler;
+	}
+
+	for(nTry = 0; nTry < IFC_SNAPSHOT_MAX_RETRY; nTry++)
+	{
+		xCtx.nLinkCnt = 0;
+		xCtx.nAddrCnt = 0;
+		nRet = scapi_nlDump(nFd, RTM_GETLINK, AF_UNSPEC, 2 * nTry + 1, scapi_ifcSnapshotLinkCb, &xCtx);
+		if(nRet == EXIT_SUCCESS)
+			nRet = scapi_nlDump(nFd, RTM_GETADDR, AF_UNSPEC, 2 * nTry + 2, scapi_ifcSnapshotAddrCb, &xCtx);
+		if(nRet != -EAGAIN)
+			break;
+	}
+	if(nRet < 0)
+	{
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+
+	nRet = scapi_ifcSnapshotBuild(&xCtx, ppxSnapshot);
+	if(nRet < 0)
+		goto returnHandler;
+	*pnCount = xCtx.nLinkCnt;
+returnHandler:
+	if(nFd >= 0)
+		close(nFd);
+	free(xCtx.pxLinks);
+	free(xCtx.pxAddrs);
+	free(xCtx.pnAddrIfindex);
+	return nRet;
+}
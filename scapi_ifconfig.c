@@ -29,10 +29,10 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <errno.h>
-#include <fcntl.h>
 #include <net/if_arp.h>
 #include <ulogging.h>
 #include <ltq_api_include.h>
+#include <scapi_netlink.h>
 
 #ifndef LOG_LEVEL
 uint16_t LOGLEVEL = SYS_LOG_DEBUG + 1;
@@ -73,18 +73,9 @@ uint16_t LOGTYPE = LOG_TYPE;
 
 int scapi_getIfcIpaddr(char* pcIfname, char* pcIp)
 {
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
+	int nRet = -EXIT_FAILURE;
 	struct ifreq xIfr ={.ifr_ifru={0}};  //gcc bug w.r.t structs when '-Werror=missing-field-initializers' is enabled
-
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0); 
-	if(nSkfd < 0) 
-	{ 
-		nRet = -errno; 
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
-		goto returnHandler; 
-	} 
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);	
-
+	IfcSnapshotAddr_t xAddr;
 
 	if(pcIfname == NULL || pcIp == NULL)
 	{
@@ -92,14 +83,23 @@ int scapi_getIfcIpaddr(char* pcIfname, char* pcIp)
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet)); 
 		goto returnHandler;
 	}
+	/* Served from the interface cache when it is enabled */
+	if((nRet = scapi_ifcCacheGetIpv4(pcIfname, &xAddr)) != -ENOENT)
+	{
+		if(nRet < 0)
+		{
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		SNPRINTF_IF_CFG(pcIp, INET_ADDRSTRLEN, "%s", xAddr.sAddr);
+		nRet = EXIT_SUCCESS;
+		goto returnHandler;
+	}
 	/* Preparing ioctl to get ipv4 address */
 	xIfr.ifr_addr.sa_family = AF_INET;
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
-	if(ioctl(nSkfd, SIOCGIFADDR, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFADDR, &xIfr)) < 0)
 	{
-		/*  might create problem in multithreaded environmet. What's the
-		 *  solution ??*/
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
@@ -107,7 +107,6 @@ int scapi_getIfcIpaddr(char* pcIfname, char* pcIp)
 	SNPRINTF_IF_CFG(pcIp, INET_ADDRSTRLEN, "%s" , inet_ntoa(((struct sockaddr_in *)&xIfr.ifr_addr)->sin_addr));
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -133,16 +132,7 @@ int scapi_setIfcIpaddr(char* pcIfname, char* pcIp)
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
+	int nRet = -EXIT_FAILURE;
 	if(pcIfname == NULL || pcIp == NULL)
 	{
 		nRet = -EINVAL;
@@ -154,15 +144,14 @@ int scapi_setIfcIpaddr(char* pcIfname, char* pcIp)
 
 	inet_pton(AF_INET, pcIp, &(((struct sockaddr_in *)&xIfr.ifr_addr)->sin_addr));
 
-	if(ioctl(nSkfd, SIOCSIFADDR, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFADDR, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -187,28 +176,33 @@ int scapi_getIfcNetmask(char* pcIfname, char* pcNetmask)
 {
 
 	struct ifreq xIfr ={.ifr_ifru={0}};
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
+	IfcSnapshotAddr_t xAddr;
+	struct in_addr xMask;
+	int nRet = -EXIT_FAILURE;
+	if(pcIfname == NULL || pcNetmask == NULL)
 	{
-		nRet = -errno;
+		nRet = -EINVAL;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
-	if(pcIfname == NULL || pcNetmask == NULL)
+	/* Served from the interface cache when it is enabled */
+	if((nRet = scapi_ifcCacheGetIpv4(pcIfname, &xAddr)) != -ENOENT)
 	{
-		nRet = -EINVAL;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		if(nRet < 0)
+		{
+			LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		xMask.s_addr = xAddr.ucPrefixLen ? htonl(~0U << (32 - xAddr.ucPrefixLen)) : 0;
+		SNPRINTF_IF_CFG(pcNetmask, INET_ADDRSTRLEN, "%s", inet_ntoa(xMask));
+		nRet = EXIT_SUCCESS;
 		goto returnHandler;
 	}
 	/* Preparing ioctl to get ipv4 address */
 	xIfr.ifr_addr.sa_family = AF_INET;
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
-	if(ioctl(nSkfd, SIOCGIFNETMASK, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFNETMASK, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
@@ -216,7 +210,6 @@ int scapi_getIfcNetmask(char* pcIfname, char* pcNetmask)
 	SNPRINTF_IF_CFG(pcNetmask, INET_ADDRSTRLEN, "%s", inet_ntoa(((struct sockaddr_in *)&xIfr.ifr_addr)->sin_addr));
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -243,16 +236,7 @@ int scapi_setIfcNetmask(char* pcIfname, char* pcNetmask)
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
+	int nRet = -EXIT_FAILURE;
 	if(pcIfname == NULL || pcNetmask == NULL)
 	{
 		nRet = -EINVAL;
@@ -264,15 +248,14 @@ int scapi_setIfcNetmask(char* pcIfname, char* pcNetmask)
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
 	inet_pton(AF_INET, pcNetmask, &(((struct sockaddr_in *)&xIfr.ifr_addr)->sin_addr));
 
-	if(ioctl(nSkfd, SIOCSIFNETMASK, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFNETMASK, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -297,30 +280,27 @@ int scapi_getIfcMacaddr(char* pcIfname, char* pcMac)
 {
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
+	IfcSnapshot_t xLink;
 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
+	int nRet = -EXIT_FAILURE;
+	if(pcIfname == NULL || pcMac == NULL)
 	{
-		nRet = -errno;
+		nRet = -EINVAL;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
 
-	if(pcIfname == NULL || pcMac == NULL)
+	if(scapi_ifcCacheGetLink(pcIfname, &xLink) == EXIT_SUCCESS)
 	{
-		nRet = -EINVAL;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		SNPRINTF_IF_CFG(pcMac, SCAPI_MAC_LEN, "%s", xLink.sMac);
+		nRet = EXIT_SUCCESS;
 		goto returnHandler;
 	}
-
 	//xIfr.ifr_addr.sa_family = AF_INET;
 	xIfr.ifr_hwaddr.sa_family = ARPHRD_ETHER;
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
-	if(ioctl(nSkfd, SIOCGIFHWADDR, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFHWADDR, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
@@ -335,7 +315,6 @@ int scapi_getIfcMacaddr(char* pcIfname, char* pcMac)
 			(unsigned char)xIfr.ifr_hwaddr.sa_data[5]);
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -362,15 +341,7 @@ int scapi_setIfcMacaddr(char* pcIfname, char* pcMac, int nOctetInc)
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
+	int nRet = -EXIT_FAILURE;
 	if(pcIfname == NULL || pcMac == NULL)
 	{
 		nRet = -EINVAL;
@@ -418,15 +389,14 @@ int scapi_setIfcMacaddr(char* pcIfname, char* pcMac, int nOctetInc)
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
-	if(ioctl(nSkfd, SIOCSIFHWADDR, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFHWADDR, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -451,28 +421,26 @@ int scapi_getIfcTxQueuelen(char *pcIfname, int* pnTxqueuelen)
 {
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
+	IfcSnapshot_t xLink;
 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
+	int nRet = -EXIT_FAILURE;
+	if(pcIfname == NULL)
 	{
-		nRet = -errno;
+		nRet = -EINVAL;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-	if(pcIfname == NULL)
+	if(scapi_ifcCacheGetLink(pcIfname, &xLink) == EXIT_SUCCESS)
 	{
-		nRet = -EINVAL;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		*pnTxqueuelen = (int)xLink.unTxQueuelen;
+		nRet = EXIT_SUCCESS;
 		goto returnHandler;
 	}
 	xIfr.ifr_addr.sa_family = AF_INET;
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
 
-	if(ioctl(nSkfd, SIOCGIFTXQLEN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFTXQLEN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
@@ -480,7 +448,6 @@ int scapi_getIfcTxQueuelen(char *pcIfname, int* pnTxqueuelen)
 	*pnTxqueuelen = xIfr.ifr_qlen;
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -506,15 +473,7 @@ int scapi_setIfcTxQueuelen(char* pcIfname, int nTxqueuelen)
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
+	int nRet = -EXIT_FAILURE;
 	if(pcIfname == NULL)
 	{
 		nRet = -EINVAL;
@@ -525,15 +484,14 @@ int scapi_setIfcTxQueuelen(char* pcIfname, int nTxqueuelen)
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
 	xIfr.ifr_qlen = nTxqueuelen;
 
-	if(ioctl(nSkfd, SIOCSIFTXQLEN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFTXQLEN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }	
 
@@ -558,26 +516,24 @@ int scapi_getIfcUpdown(char *pcIfname, bool* status)
 {
 
 	struct ifreq xIfr = {.ifr_ifru={0}};
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
+	IfcSnapshot_t xLink;
+	int nRet = -EXIT_FAILURE;
+	if(pcIfname == NULL)
 	{
-		nRet = -errno;
+		nRet = -EINVAL;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-	if(pcIfname == NULL)
+	if(scapi_ifcCacheGetLink(pcIfname, &xLink) == EXIT_SUCCESS)
 	{
-		nRet = -EINVAL;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		*status = (xLink.unFlags & IFF_UP) ? true : false;
+		nRet = EXIT_SUCCESS;
 		goto returnHandler;
 	}
 	xIfr.ifr_addr.sa_family = AF_INET;
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
-	if(ioctl(nSkfd, SIOCGIFFLAGS, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFFLAGS, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}	
@@ -586,7 +542,6 @@ int scapi_getIfcUpdown(char *pcIfname, bool* status)
 	xIfr.ifr_flags & IFF_UP ? (*status = true):(*status = false);
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -610,15 +565,7 @@ int scapi_setIfcUpdown(char* pcIfname, bool updown)
 {
 
 	struct ifreq xIfr = {.ifr_ifru={0}}; 
-	int nSkfd = -1, nRet = -EXIT_FAILURE;
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
+	int nRet = -EXIT_FAILURE;
 	if(pcIfname == NULL)
 	{
 		nRet = -EINVAL;
@@ -629,9 +576,8 @@ int scapi_setIfcUpdown(char* pcIfname, bool updown)
 	SNPRINTF_IF_CFG(xIfr.ifr_name,IFNAMSIZ, "%s", pcIfname);
 
 	/* Makin sure that setting interface updown flags doesn't reset other flags */
-	if(ioctl(nSkfd, SIOCGIFFLAGS, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCGIFFLAGS, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
@@ -641,14 +587,13 @@ int scapi_setIfcUpdown(char* pcIfname, bool updown)
 	else if(0 == updown)
 		xIfr.ifr_flags &= (~IFF_UP);
 
-	if(ioctl(nSkfd, SIOCSIFFLAGS, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFFLAGS, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
@@ -0,0 +1,208 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ipc_blob.c                                     *
+ *         Description  :  Large IPC payloads in memfds, passed over the unix   *
+ *                         socket with SCM_RIGHTS instead of copied through it  *
+ *  *****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <scapi_ipc.h>
+#include <scapi_ipc_blob.h>
+#include "ulogging.h"
+
+/*
+** =============================================================================
+**   Function Name    : ipc_send_fd
+**   Description      : Sends bytes with a descriptor attached
+**   Return Value     : Success -> bytes sent
+**                      Failure -> -1
+** ===========================================================================*/
+
+ssize_t
+ipc_send_fd(int32_t ifd, const void *pvbuf, size_t ilen, int32_t ipassfd, int32_t iflags)
+{
+	union {
+		char acbuf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr xalign;
+	} xctl;
+	struct iovec xiov;
+	struct msghdr xmsg;
+	struct cmsghdr *pxcmsg;
+
+	memset(&xmsg, 0, sizeof(xmsg));
+	xiov.iov_base = (void *)(uintptr_t)pvbuf;
+	xiov.iov_len = ilen;
+	xmsg.msg_iov = &xiov;
+	xmsg.msg_iovlen = 1;
+	if (ipassfd >= 0) {
+		memset(&xctl, 0, sizeof(xctl));
+		xmsg.msg_control = xctl.acbuf;
+		xmsg.msg_controllen = sizeof(xctl.acbuf);
+		pxcmsg = CMSG_FIRSTHDR(&xmsg);
+		pxcmsg->cmsg_level = SOL_SOCKET;
+		pxcmsg->cmsg_type = SCM_RIGHTS;
+		pxcmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(pxcmsg), &ipassfd, sizeof(int));
+	}
+	return sendmsg(ifd, &xmsg, MSG_NOSIGNAL | iflags);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_recv_fd
+**   Description      : Reads bytes and the descriptor that came with them
+**   Return Value     : Success -> bytes read, 0 at end of stream
+**                      Failure -> -1
+** ===========================================================================*/
+
+ssize_t
+ipc_recv_fd(int32_t ifd, void *pvbuf, size_t ilen, int32_t *pipassfd)
+{
+	union {
+		char acbuf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr xalign;
+	} xctl;
+	struct iovec xiov;
+	struct msghdr xmsg;
+	struct cmsghdr *pxcmsg;
+	ssize_t nbytes;
+
+	*pipassfd = -1;
+	memset(&xmsg, 0, sizeof(xmsg));
+	xiov.iov_base = pvbuf;
+	xiov.iov_len = ilen;
+	xmsg.msg_iov = &xiov;
+	xmsg.msg_iovlen = 1;
+	xmsg.msg_control = xctl.acbuf;
+	xmsg.msg_controllen = sizeof(xctl.acbuf);
+
+	/* Descriptors beyond the first do not fit and are closed by the kernel */
+	nbytes = recvmsg(ifd, &xmsg, MSG_CMSG_CLOEXEC);
+	if (nbytes < 0)
+		return nbytes;
+	for (pxcmsg = CMSG_FIRSTHDR(&xmsg); pxcmsg != NULL; pxcmsg = CMSG_NXTHDR(&xmsg, pxcmsg)) {
+		if (pxcmsg->cmsg_level == SOL_SOCKET && pxcmsg->cmsg_type == SCM_RIGHTS &&
+				pxcmsg->cmsg_len >= CMSG_LEN(sizeof(int))) {
+			memcpy(pipassfd, CMSG_DATA(pxcmsg), sizeof(int));
+			break;
+		}
+	}
+	return nbytes;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_blob_map
+**   Description      : Maps a received blob read only
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_blob_map(x_ipc_blob *pxblob, int32_t ipassfd)
+{
+	struct stat xst;
+	int32_t iseals;
+
+	pxblob->ifd = ipassfd;
+	pxblob->isize = 0;
+	pxblob->pvdata = NULL;
+	/* An unsealed file could be truncated under the mapping by the
+	   sender, and reading it would then raise SIGBUS */
+	iseals = fcntl(ipassfd, F_GET_SEALS);
+	if (iseals < 0 || (iseals & F_SEAL_SHRINK) == 0 || fstat(ipassfd, &xst) < 0) {
+		LOGF_LOG_DEBUG("IPC blob is not a sealed memfd\n");
+		goto returnHandler;
+	}
+	pxblob->isize = xst.st_size;
+	if (pxblob->isize == 0)
+		return IPC_SUCCESS;
+	pxblob->pvdata = mmap(NULL, pxblob->isize, PROT_READ, MAP_SHARED, ipassfd, 0);
+	if (pxblob->pvdata == MAP_FAILED) {
+		pxblob->pvdata = NULL;
+		LOGF_LOG_DEBUG("IPC blob mmap failed %d\n", errno);
+		goto returnHandler;
+	}
+	return IPC_SUCCESS;
+
+returnHandler:
+	ipc_blob_free(pxblob);
+	return IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_blob_alloc
+**   Description      : API to create a blob to fill and pass
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_blob_alloc(x_ipc_blob *pxblob, size_t isize)
+{
+	pxblob->isize = isize;
+	pxblob->pvdata = NULL;
+	pxblob->ifd = memfd_create("scapi_ipc_blob", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (pxblob->ifd < 0) {
+		LOGF_LOG_DEBUG("memfd_create failed %d\n", errno);
+		return IPC_FAIL;
+	}
+	if (ftruncate(pxblob->ifd, isize) < 0 ||
+			fcntl(pxblob->ifd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+		LOGF_LOG_DEBUG("IPC blob setup failed %d\n", errno);
+		goto returnHandler;
+	}
+	if (isize == 0)
+		return IPC_SUCCESS;
+	pxblob->pvdata = mmap(NULL, isize, PROT_READ | PROT_WRITE, MAP_SHARED, pxblob->ifd, 0);
+	if (pxblob->pvdata == MAP_FAILED) {
+		pxblob->pvdata = NULL;
+		LOGF_LOG_DEBUG("IPC blob mmap failed %d\n", errno);
+		goto returnHandler;
+	}
+	return IPC_SUCCESS;
+
+returnHandler:
+	ipc_blob_free(pxblob);
+	return IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_blob_free
+**   Description      : API to release a blob
+**   Return Value     : None
+** ===========================================================================*/
+
+void
+ipc_blob_free(x_ipc_blob *pxblob)
+{
+	if (pxblob == NULL)
+		return;
+	if (pxblob->pvdata != NULL)
+		munmap(pxblob->pvdata, pxblob->isize);
+	if (pxblob->ifd >= 0)
+		close(pxblob->ifd);
+	pxblob->ifd = -1;
+	pxblob->isize = 0;
+	pxblob->pvdata = NULL;
+}
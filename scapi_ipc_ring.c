@@ -0,0 +1,364 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ipc_ring.c                                     *
+ *         Description  :  Shared memory single producer / single consumer      *
+ *                         ring carrying UGW IPC messages                       *
+ *  *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "scapi_basic_types.h"
+#include "scapi_fifo.h"
+#include "scapi_ipc_ring.h"
+#include "ulogging.h"
+
+#define UGW_IPC_RING_MAGIC	0x52494E47	/* "RING" */
+#define UGW_IPC_RING_ALIGN	8
+#define UGW_IPC_RING_REC_LEN(unMsgSize) \
+	((UGW_IPC_HDR_SIZE + (unMsgSize) + UGW_IPC_RING_ALIGN - 1) & ~(UGW_IPC_RING_ALIGN - 1))
+
+/* Each index has a cache line of its own so that the two ends do not
+   keep stealing the line from each other */
+struct x_UGW_IPC_RingShm {
+	uint32 uiMagic;		/* Set last by the creator */
+	uint32 uiSize;		/* Data size, a power of two */
+	uint32 auiPad1[14];
+	uint32 uiHead;		/* Written by the sender only, free running */
+	uint32 auiPad2[15];
+	uint32 uiTail;		/* Written by the receiver only, free running */
+	uint32 uiSleeping;	/* Futex word, 1 while the receiver waits */
+	uint32 auiPad3[14];
+	char8 acData[];		/* Records: header then payload, 8 byte aligned */
+};
+
+/*
+** =============================================================================
+**   Function Name    : ugw_ipc_ring_futex
+**   Description      : Waits on or wakes the receiver
+**   Return Value     : futex() result
+** ===========================================================================*/
+
+static int32
+ugw_ipc_ring_futex(uint32 * puiAddr, int32 iOp, uint32 uiVal, struct timespec *pxTs)
+{
+	/* Not FUTEX_PRIVATE_FLAG, the word is shared between processes */
+	return syscall(SYS_futex, puiAddr, iOp, uiVal, pxTs, NULL, 0);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ugw_ipc_ring_map
+**   Description      : Maps the ring file and fills the handle
+**   Return Value     : Success -> UGW_IPC_SUCCESS
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+static char8
+ugw_ipc_ring_map(x_UGW_IPC_Ring * pxRing, int32 iFd, uint32 uiMapSize)
+{
+	void *pvMap;
+
+	pvMap = mmap(NULL, uiMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+	if (pvMap == MAP_FAILED) {
+		LOGF_LOG_DEBUG("IPC ring mmap failed %d\n", errno);
+		return UGW_IPC_FAIL;
+	}
+	pxRing->pxShm = pvMap;
+	pxRing->uiMapSize = uiMapSize;
+	return UGW_IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : UGW_IPC_RingCreate
+**   Description      : To create a ring, on the receiving side
+**   Return Value     : Success -> UGW_IPC_SUCCESS
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+char8 UGW_IPC_RingCreate(OUT x_UGW_IPC_Ring * pxRing, IN char8 * pcPath, IN uint32 uiSize)
+{
+	uint32 uiDataSize = UGW_IPC_RING_ALIGN;
+	int32 iFd;
+
+	memset(pxRing, 0, sizeof(x_UGW_IPC_Ring));
+	/* The largest message must fit, and indexes wrap at 2^32 so the
+	   size must divide it */
+	if (uiSize < UGW_IPC_RING_REC_LEN(UGW_IPC_MAX_MSG_SIZE))
+		uiSize = UGW_IPC_RING_REC_LEN(UGW_IPC_MAX_MSG_SIZE);
+	if (uiSize > (1U << 30))
+		return UGW_IPC_FAIL;
+	while (uiDataSize < uiSize)
+		uiDataSize <<= 1;
+
+	/* A sender of an earlier run may still map the old file, it keeps
+	   it alive but never sees this ring */
+	unlink(pcPath);
+	iFd = open(pcPath, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, UGW_IPC_FIFO_PERM);
+	if (iFd < 0) {
+		LOGF_LOG_DEBUG("IPC ring %s create failed %d\n", pcPath, errno);
+		return UGW_IPC_FAIL;
+	}
+	if (ftruncate(iFd, sizeof(struct x_UGW_IPC_RingShm) + uiDataSize) < 0 ||
+	    ugw_ipc_ring_map(pxRing, iFd, sizeof(struct x_UGW_IPC_RingShm) + uiDataSize) != UGW_IPC_SUCCESS) {
+		LOGF_LOG_DEBUG("IPC ring %s setup failed %d\n", pcPath, errno);
+		close(iFd);
+		unlink(pcPath);
+		return UGW_IPC_FAIL;
+	}
+	close(iFd);
+
+	pxRing->uiMask = uiDataSize - 1;
+	pxRing->pxShm->uiSize = uiDataSize;
+	/* Senders check the magic before anything else */
+	__atomic_store_n(&pxRing->pxShm->uiMagic, UGW_IPC_RING_MAGIC, __ATOMIC_RELEASE);
+	return UGW_IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : UGW_IPC_RingOpen
+**   Description      : To open a ring, on the sending side
+**   Return Value     : Success -> UGW_IPC_SUCCESS
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+char8 UGW_IPC_RingOpen(OUT x_UGW_IPC_Ring * pxRing, IN char8 * pcPath)
+{
+	struct x_UGW_IPC_RingShm *pxShm;
+	struct stat xSt;
+	int32 iFd;
+
+	memset(pxRing, 0, sizeof(x_UGW_IPC_Ring));
+	iFd = open(pcPath, O_RDWR | O_CLOEXEC);
+	if (iFd < 0) {
+		LOGF_LOG_DEBUG("IPC ring %s open failed %d\n", pcPath, errno);
+		return UGW_IPC_FAIL;
+	}
+	if (fstat(iFd, &xSt) < 0 || xSt.st_size <= (off_t) sizeof(struct x_UGW_IPC_RingShm) ||
+	    ugw_ipc_ring_map(pxRing, iFd, xSt.st_size) != UGW_IPC_SUCCESS) {
+		close(iFd);
+		return UGW_IPC_FAIL;
+	}
+	close(iFd);
+
+	pxShm = pxRing->pxShm;
+	if (__atomic_load_n(&pxShm->uiMagic, __ATOMIC_ACQUIRE) != UGW_IPC_RING_MAGIC ||
+	    sizeof(struct x_UGW_IPC_RingShm) + pxShm->uiSize != pxRing->uiMapSize) {
+		/* Not a ring, or the receiver is still setting it up */
+		LOGF_LOG_DEBUG("IPC ring %s not ready\n", pcPath);
+		UGW_IPC_RingClose(pxRing);
+		return UGW_IPC_FAIL;
+	}
+	pxRing->uiMask = pxShm->uiSize - 1;
+	pxRing->uiPeerIdx = __atomic_load_n(&pxShm->uiTail, __ATOMIC_ACQUIRE);
+	return UGW_IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : UGW_IPC_RingClose
+**   Description      : To unmap a ring
+**   Return Value     : None
+** ===========================================================================*/
+
+void UGW_IPC_RingClose(IN x_UGW_IPC_Ring * pxRing)
+{
+	if (pxRing->pxShm != NULL)
+		munmap(pxRing->pxShm, pxRing->uiMapSize);
+	memset(pxRing, 0, sizeof(x_UGW_IPC_Ring));
+}
+
+/*
+** =============================================================================
+**   Function Name    : UGW_IPC_RingSendMsg
+**   Description      : To send message on a ring
+**   Return Value     : Success -> UGW_IPC_SUCCESS
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+char8 UGW_IPC_RingSendMsg(IN x_UGW_IPC_Ring * pxRing,
+			  IN uchar8 ucFrom,
+			  IN uchar8 ucTo,
+			  IN uint16 unMsgSize,
+			  IN uint32 uiReserved, IN char8 * pcMsg, OUT char8 * pErr)
+{
+	struct x_UGW_IPC_RingShm *pxShm = pxRing->pxShm;
+	x_UGW_IPC_MsgHdr xHdr;
+	uint32 uiHead, uiOff, uiLen, uiFirst;
+
+	*pErr = UGW_IPC_NO_ERR;
+	if (unMsgSize > UGW_IPC_MAX_MSG_SIZE) {
+		*pErr = UGW_IPC_MSG_ERR;
+		return UGW_IPC_FAIL;
+	}
+	uiLen = UGW_IPC_RING_REC_LEN(unMsgSize);
+	uiHead = pxShm->uiHead;
+	/* The receiver's index is only fetched when the cached one says full */
+	if (uiHead - pxRing->uiPeerIdx + uiLen > pxRing->uiMask + 1) {
+		pxRing->uiPeerIdx = __atomic_load_n(&pxShm->uiTail, __ATOMIC_ACQUIRE);
+		if (uiHead - pxRing->uiPeerIdx + uiLen > pxRing->uiMask + 1) {
+			*pErr = UGW_IPC_RING_FULL;
+			return UGW_IPC_FAIL;
+		}
+	}
+
+	/* Records are aligned and the size is a power of two, the header
+	   never wraps; the payload may */
+	xHdr.ucFrom = ucFrom;
+	xHdr.ucTo = ucTo;
+	xHdr.unMsgSize = unMsgSize;
+	xHdr.uiReserved = uiReserved;
+	uiOff = uiHead & pxRing->uiMask;
+	memcpy(pxShm->acData + uiOff, &xHdr, UGW_IPC_HDR_SIZE);
+	uiOff = (uiOff + UGW_IPC_HDR_SIZE) & pxRing->uiMask;
+	uiFirst = pxRing->uiMask + 1 - uiOff;
+	if (uiFirst > unMsgSize)
+		uiFirst = unMsgSize;
+	memcpy(pxShm->acData + uiOff, pcMsg, uiFirst);
+	memcpy(pxShm->acData, pcMsg + uiFirst, unMsgSize - uiFirst);
+
+	/* Publishing the record and reading the sleep flag are ordered
+	   against the receiver setting the flag and rereading uiHead, so
+	   one of the two sides always sees the other */
+	__atomic_store_n(&pxShm->uiHead, uiHead + uiLen, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&pxShm->uiSleeping, __ATOMIC_SEQ_CST) &&
+	    __atomic_exchange_n(&pxShm->uiSleeping, 0, __ATOMIC_SEQ_CST)) {
+		/* The receiver sleeps on an empty ring, only then a syscall */
+		ugw_ipc_ring_futex(&pxShm->uiSleeping, FUTEX_WAKE, 1, NULL);
+	}
+	return UGW_IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ugw_ipc_ring_wait
+**   Description      : Waits for the sender to publish a record
+**   Return Value     : Success -> UGW_IPC_SUCCESS
+**                      Failure -> UGW_IPC_FAIL on timeout
+** ===========================================================================*/
+
+static char8
+ugw_ipc_ring_wait(x_UGW_IPC_Ring * pxRing, int32 iTimeoutMs)
+{
+	struct x_UGW_IPC_RingShm *pxShm = pxRing->pxShm;
+	struct timespec xNow, xEnd, xLeft;
+	uint32 uiTail = pxShm->uiTail;
+
+	if (iTimeoutMs > 0) {
+		clock_gettime(CLOCK_MONOTONIC, &xEnd);
+		xEnd.tv_sec += iTimeoutMs / 1000;
+		xEnd.tv_nsec += (iTimeoutMs % 1000) * 1000000L;
+		if (xEnd.tv_nsec >= 1000000000L) {
+			xEnd.tv_sec++;
+			xEnd.tv_nsec -= 1000000000L;
+		}
+	}
+
+	for (;;) {
+		pxRing->uiPeerIdx = __atomic_load_n(&pxShm->uiHead, __ATOMIC_ACQUIRE);
+		if (pxRing->uiPeerIdx != uiTail)
+			return UGW_IPC_SUCCESS;
+		if (iTimeoutMs == 0)
+			return UGW_IPC_FAIL;
+
+		__atomic_store_n(&pxShm->uiSleeping, 1, __ATOMIC_SEQ_CST);
+		pxRing->uiPeerIdx = __atomic_load_n(&pxShm->uiHead, __ATOMIC_SEQ_CST);
+		if (pxRing->uiPeerIdx != uiTail) {
+			__atomic_store_n(&pxShm->uiSleeping, 0, __ATOMIC_RELAXED);
+			return UGW_IPC_SUCCESS;
+		}
+
+		if (iTimeoutMs < 0) {
+			ugw_ipc_ring_futex(&pxShm->uiSleeping, FUTEX_WAIT, 1, NULL);
+		} else {
+			clock_gettime(CLOCK_MONOTONIC, &xNow);
+			xLeft.tv_sec = xEnd.tv_sec - xNow.tv_sec;
+			xLeft.tv_nsec = xEnd.tv_nsec - xNow.tv_nsec;
+			if (xLeft.tv_nsec < 0) {
+				xLeft.tv_sec--;
+				xLeft.tv_nsec += 1000000000L;
+			}
+			if (xLeft.tv_sec < 0) {
+				__atomic_store_n(&pxShm->uiSleeping, 0, __ATOMIC_RELAXED);
+				iTimeoutMs = 0;
+				continue;	/* last look at the ring */
+			}
+			/* EINTR and a wake racing with the flag both come back here */
+			ugw_ipc_ring_futex(&pxShm->uiSleeping, FUTEX_WAIT, 1, &xLeft);
+		}
+		__atomic_store_n(&pxShm->uiSleeping, 0, __ATOMIC_RELAXED);
+	}
+}
+
+/*
+** =============================================================================
+**   Function Name    : UGW_IPC_RingRecvMsg
+**   Description      : To receive message from a ring
+**   Return Value     : Success -> UGW_IPC_SUCCESS
+**                      Failure -> UGW_IPC_FAIL
+** ===========================================================================*/
+
+char8 UGW_IPC_RingRecvMsg(IN x_UGW_IPC_Ring * pxRing,
+			  IN int32 iTimeoutMs,
+			  OUT uchar8 * pucFrom,
+			  OUT uchar8 * pucTo,
+			  OUT uint16 * punMsgSize,
+			  OUT uint32 * puiReserved, OUT char8 * pcMsg, OUT char8 * pErr)
+{
+	struct x_UGW_IPC_RingShm *pxShm = pxRing->pxShm;
+	x_UGW_IPC_MsgHdr xHdr;
+	uint32 uiTail, uiOff, uiLen, uiFirst;
+
+	*pErr = UGW_IPC_NO_ERR;
+	uiTail = pxShm->uiTail;
+	/* The sender's index is only fetched when the cached one says empty */
+	if (pxRing->uiPeerIdx == uiTail &&
+	    ugw_ipc_ring_wait(pxRing, iTimeoutMs) != UGW_IPC_SUCCESS) {
+		*pErr = UGW_IPC_RING_TIMEOUT;
+		return UGW_IPC_FAIL;
+	}
+
+	uiOff = uiTail & pxRing->uiMask;
+	memcpy(&xHdr, pxShm->acData + uiOff, UGW_IPC_HDR_SIZE);
+	uiLen = UGW_IPC_RING_REC_LEN(xHdr.unMsgSize);
+	if (xHdr.unMsgSize > UGW_IPC_MAX_MSG_SIZE || uiLen > pxRing->uiPeerIdx - uiTail) {
+		/* Framing is lost, drop everything published */
+		__atomic_store_n(&pxShm->uiTail, pxRing->uiPeerIdx, __ATOMIC_RELEASE);
+		*pErr = UGW_IPC_HDR_ERR;
+		return UGW_IPC_FAIL;
+	}
+
+	uiOff = (uiOff + UGW_IPC_HDR_SIZE) & pxRing->uiMask;
+	uiFirst = pxRing->uiMask + 1 - uiOff;
+	if (uiFirst > xHdr.unMsgSize)
+		uiFirst = xHdr.unMsgSize;
+	memcpy(pcMsg, pxShm->acData + uiOff, uiFirst);
+	memcpy(pcMsg + uiFirst, pxShm->acData, xHdr.unMsgSize - uiFirst);
+	pcMsg[xHdr.unMsgSize] = '\0';
+
+	/* Hands the space back once the copy is done */
+	__atomic_store_n(&pxShm->uiTail, uiTail + uiLen, __ATOMIC_RELEASE);
+
+	*pucFrom = xHdr.ucFrom;
+	*pucTo = xHdr.ucTo;
+	*punMsgSize = xHdr.unMsgSize;
+	*puiReserved = xHdr.uiReserved;
+	return UGW_IPC_SUCCESS;
+}
@@ -0,0 +1,538 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+********************************************************************************/
+
+/*  *****************************************************************************
+ *         File Name    :  scapi_ipc_server.c                                   *
+ *         Description  :  Non-blocking IPC listener serving many clients from  *
+ *                         one epoll loop, requests handed to a callback        *
+ *  *****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <scapi_ipc.h>
+#include <scapi_ipc_blob.h>
+#include <ltq_api_include.h>
+#include "ugw_error.h"
+#include "ulogging.h"
+
+/* Requests pipelined by a client are read in one go, up to this size */
+#define IPC_SERVER_RXBUF (4 * sizeof(x_ipc_msg_t))
+#define IPC_SERVER_EVENTS 64
+/* Blob descriptors received ahead of their message, or queued with
+   replies; one read takes at most one */
+#define IPC_SERVER_FDS 4
+
+typedef struct
+{
+	size_t ioff;	/* offset of the message in the output */
+	int32_t ifd;
+} x_ipc_txfd;
+
+typedef struct x_ipc_conn
+{
+	struct x_ipc_conn *pxnext;
+	struct x_ipc_conn *pxprev;
+	int32_t ifd;
+	/* Bytes received and not yet handled, whole messages and the start
+	   of the next one */
+	char acrx[IPC_SERVER_RXBUF];
+	size_t irxlen;
+	/* Descriptors received, each with the offset in acrx of the byte it
+	   came with, the first byte of the message carrying it */
+	int32_t airxfd[IPC_SERVER_FDS];
+	size_t airxoff[IPC_SERVER_FDS];
+	int32_t inrxfd;
+	/* Replies the socket did not take yet, the connection is not read
+	   until they are sent */
+	char *pctx;
+	size_t itxlen;
+	size_t itxsize;
+	x_ipc_txfd axtxfd[IPC_SERVER_FDS];
+	int32_t intxfd;
+	uint32_t uievents;
+} x_ipc_conn;
+
+typedef struct
+{
+	x_ipc_handle *pxlistener;
+	int32_t iepfd;
+	pfn_ipc_handler pfnhandler;
+	void *pvarg;
+	x_ipc_conn *pxconns;
+	int32_t inconns;
+	/* Copy of the request being handled, aligned for the handler */
+	x_ipc_msg_t xmsg;
+} x_ipc_server;
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_watch
+**   Description      : Sets the epoll events of a connection
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+static int32_t
+ipc_server_watch(x_ipc_server *pxserver, x_ipc_conn *pxconn, uint32_t uievents)
+{
+	struct epoll_event xev;
+
+	if (pxconn->uievents == uievents)
+		return IPC_SUCCESS;
+	memset(&xev, 0, sizeof(xev));
+	xev.events = uievents;
+	xev.data.ptr = pxconn;
+	if (epoll_ctl(pxserver->iepfd, EPOLL_CTL_MOD, pxconn->ifd, &xev) < 0)
+		return IPC_FAIL;
+	pxconn->uievents = uievents;
+	return IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_drop
+**   Description      : Closes a connection and frees its state
+**   Return Value     : None
+** ===========================================================================*/
+
+static void
+ipc_server_drop(x_ipc_server *pxserver, x_ipc_conn *pxconn)
+{
+	int32_t i;
+
+	epoll_ctl(pxserver->iepfd, EPOLL_CTL_DEL, pxconn->ifd, NULL);
+	close(pxconn->ifd);
+	for (i = 0; i < pxconn->inrxfd; i++)
+		close(pxconn->airxfd[i]);
+	for (i = 0; i < pxconn->intxfd; i++)
+		close(pxconn->axtxfd[i].ifd);
+	if (pxconn->pxprev != NULL)
+		pxconn->pxprev->pxnext = pxconn->pxnext;
+	else
+		pxserver->pxconns = pxconn->pxnext;
+	if (pxconn->pxnext != NULL)
+		pxconn->pxnext->pxprev = pxconn->pxprev;
+	free(pxconn->pctx);
+	free(pxconn);
+	pxserver->inconns--;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_queue
+**   Description      : Appends a reply to the connection's output, with the
+**                      blob descriptor ipassfd (-1 if none) which the
+**                      connection owns from then on
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+static int32_t
+ipc_server_queue(x_ipc_conn *pxconn, const x_ipc_msg_t *pxmsg, int32_t ipassfd)
+{
+	size_t ilen = IPC_HDR_SIZE + pxmsg->xhdr.unmsgsize;
+	char *pcbuf;
+
+	if (pxconn->itxlen + ilen > pxconn->itxsize) {
+		pcbuf = realloc(pxconn->pctx, pxconn->itxlen + ilen);
+		if (pcbuf == NULL)
+			goto returnHandler;
+		pxconn->pctx = pcbuf;
+		pxconn->itxsize = pxconn->itxlen + ilen;
+	}
+	if (ipassfd >= 0) {
+		if (pxconn->intxfd == IPC_SERVER_FDS)
+			goto returnHandler;
+		pxconn->axtxfd[pxconn->intxfd].ioff = pxconn->itxlen;
+		pxconn->axtxfd[pxconn->intxfd].ifd = ipassfd;
+		pxconn->intxfd++;
+	}
+	memcpy(pxconn->pctx + pxconn->itxlen, pxmsg, ilen);
+	pxconn->itxlen += ilen;
+	return IPC_SUCCESS;
+
+returnHandler:
+	if (ipassfd >= 0)
+		close(ipassfd);
+	return IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_flush
+**   Description      : Sends the queued replies as far as the socket takes
+**                      them, each blob with the first byte of its message,
+**                      and reads the connection again once all are out
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL, the connection is to be dropped
+** ===========================================================================*/
+
+static int32_t
+ipc_server_flush(x_ipc_server *pxserver, x_ipc_conn *pxconn)
+{
+	ssize_t nbytes;
+	size_t idone = 0, iend;
+	int32_t i, ipassfd;
+
+	while (idone < pxconn->itxlen) {
+		/* Up to the next message with a blob, or from it to the one after;
+		   a record per message on SOCK_SEQPACKET */
+		ipassfd = -1;
+		iend = pxconn->itxlen;
+		if (pxconn->intxfd > 0 && pxconn->axtxfd[0].ioff == idone) {
+			ipassfd = pxconn->axtxfd[0].ifd;
+			if (pxconn->intxfd > 1)
+				iend = pxconn->axtxfd[1].ioff;
+		} else if (pxconn->intxfd > 0) {
+			iend = pxconn->axtxfd[0].ioff;
+		}
+		if (pxserver->pxlistener->itransport == IPC_TRANSPORT_SEQPACKET)
+			iend = idone + IPC_HDR_SIZE +
+				((const x_ipc_msghdr_t *)(pxconn->pctx + idone))->unmsgsize;
+		nbytes = ipc_send_fd(pxconn->ifd, pxconn->pctx + idone, iend - idone,
+				ipassfd, MSG_DONTWAIT);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			return IPC_FAIL;
+		}
+		if (ipassfd >= 0) {
+			close(ipassfd);
+			pxconn->intxfd--;
+			memmove(&pxconn->axtxfd[0], &pxconn->axtxfd[1],
+					pxconn->intxfd * sizeof(pxconn->axtxfd[0]));
+		}
+		idone += nbytes;
+	}
+	pxconn->itxlen -= idone;
+	if (pxconn->itxlen > 0 && idone > 0) {
+		memmove(pxconn->pctx, pxconn->pctx + idone, pxconn->itxlen);
+		for (i = 0; i < pxconn->intxfd; i++)
+			pxconn->axtxfd[i].ioff -= idone;
+	}
+	return ipc_server_watch(pxserver, pxconn, pxconn->itxlen > 0 ? EPOLLOUT : EPOLLIN);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_input
+**   Description      : Reads from a connection and hands each complete
+**                      request to the handler, replies are sent together
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL, the connection is to be dropped
+** ===========================================================================*/
+
+static int32_t
+ipc_server_input(x_ipc_server *pxserver, x_ipc_conn *pxconn)
+{
+	const x_ipc_msghdr_t *pxhdr;
+	x_ipc_msg_t *pxmsg = &pxserver->xmsg;
+	x_ipc_blob xreqblob, xreplyblob;
+	size_t ioff = 0, ilen;
+	ssize_t nbytes;
+	uint32_t uireq;
+	int32_t i, iret, ipassfd, irxfd;
+
+	do {
+		nbytes = ipc_recv_fd(pxconn->ifd, pxconn->acrx + pxconn->irxlen,
+				sizeof(pxconn->acrx) - pxconn->irxlen, &ipassfd);
+	} while (nbytes < 0 && errno == EINTR);
+	if (nbytes < 0)
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? IPC_SUCCESS : IPC_FAIL;
+	if (nbytes == 0)
+		return IPC_FAIL;
+	/* Came with the first byte of its message, which is not parsed yet */
+	if (ipassfd >= 0) {
+		if (pxconn->inrxfd == IPC_SERVER_FDS) {
+			close(ipassfd);
+			return IPC_FAIL;
+		}
+		pxconn->airxoff[pxconn->inrxfd] = pxconn->irxlen;
+		pxconn->airxfd[pxconn->inrxfd++] = ipassfd;
+	}
+	pxconn->irxlen += nbytes;
+
+	while (pxconn->irxlen - ioff >= IPC_HDR_SIZE) {
+		pxhdr = (const x_ipc_msghdr_t *)(pxconn->acrx + ioff);
+		if (pxhdr->unmsgsize > IPC_MAX_MSG_SIZE || pxhdr->unmsgsize < 1) {
+			LOGF_LOG_DEBUG("bad message size %u\n", pxhdr->unmsgsize);
+			return IPC_FAIL;
+		}
+		ilen = IPC_HDR_SIZE + pxhdr->unmsgsize;
+		if (pxconn->irxlen - ioff < ilen)
+			break;
+		memcpy(pxmsg, pxconn->acrx + ioff, ilen);
+		ioff += ilen;
+
+		uireq = pxmsg->xhdr.uireserved;
+		xreqblob.ifd = -1;
+		xreqblob.isize = 0;
+		xreqblob.pvdata = NULL;
+		xreplyblob = xreqblob;
+		/* Take the descriptors that came within this message. Only a
+		   blob message keeps the one sent with its first byte, others
+		   are closed so that they never reach a later message. Flags
+		   without a descriptor are stale bits from a client that does
+		   not set uireserved */
+		ipassfd = -1;
+		for (irxfd = 0; irxfd < pxconn->inrxfd &&
+				pxconn->airxoff[irxfd] < ioff; irxfd++) {
+			if (ipassfd < 0 && pxconn->airxoff[irxfd] == ioff - ilen &&
+					(uireq & (IPC_CHANNEL_FLAG | IPC_BLOB_FLAG)) ==
+					(IPC_CHANNEL_FLAG | IPC_BLOB_FLAG))
+				ipassfd = pxconn->airxfd[irxfd];
+			else
+				close(pxconn->airxfd[irxfd]);
+		}
+		if (irxfd > 0) {
+			pxconn->inrxfd -= irxfd;
+			memmove(&pxconn->airxfd[0], &pxconn->airxfd[irxfd], pxconn->inrxfd * sizeof(pxconn->airxfd[0]));
+			memmove(&pxconn->airxoff[0], &pxconn->airxoff[irxfd], pxconn->inrxfd * sizeof(pxconn->airxoff[0]));
+		}
+		if (ipassfd >= 0 && ipc_blob_map(&xreqblob, ipassfd) != IPC_SUCCESS)
+			return IPC_FAIL;
+		iret = pxserver->pfnhandler(pxmsg, &xreqblob, &xreplyblob, pxserver->pvarg);
+		ipc_blob_free(&xreqblob);
+		/* Only the descriptor is sent, the mapping goes now */
+		if (xreplyblob.pvdata != NULL) {
+			munmap(xreplyblob.pvdata, xreplyblob.isize);
+			xreplyblob.pvdata = NULL;
+		}
+		if (iret != IPC_SUCCESS || (uireq & IPC_CHANNEL_FLAG) == 0)
+			ipc_blob_free(&xreplyblob);
+		if (iret == IPC_FAIL)
+			return IPC_FAIL;
+		if (iret == IPC_NO_REPLY)
+			continue;
+		/* The connection is kept for the next request */
+		if (uireq & IPC_CHANNEL_FLAG) {
+			pxmsg->xhdr.uireserved = uireq & ~IPC_BLOB_FLAG;
+			if (xreplyblob.ifd >= 0)
+				pxmsg->xhdr.uireserved |= IPC_BLOB_FLAG;
+		}
+		if (pxmsg->xhdr.unmsgsize > IPC_MAX_MSG_SIZE) {
+			ipc_blob_free(&xreplyblob);
+			return IPC_FAIL;
+		}
+		if (ipc_server_queue(pxconn, pxmsg, xreplyblob.ifd) != IPC_SUCCESS)
+			return IPC_FAIL;
+	}
+	pxconn->irxlen -= ioff;
+	/* A record holds whole messages */
+	if (pxconn->irxlen > 0 && pxserver->pxlistener->itransport == IPC_TRANSPORT_SEQPACKET)
+		return IPC_FAIL;
+	if (pxconn->irxlen > 0 && ioff > 0)
+		memmove(pxconn->acrx, pxconn->acrx + ioff, pxconn->irxlen);
+	for (i = 0; i < pxconn->inrxfd; i++)
+		pxconn->airxoff[i] -= ioff;
+
+	return ipc_server_flush(pxserver, pxconn);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_accept
+**   Description      : Accepts the pending clients
+**   Return Value     : None
+** ===========================================================================*/
+
+static void
+ipc_server_accept(x_ipc_server *pxserver)
+{
+	struct epoll_event xev;
+	x_ipc_conn *pxconn;
+	int32_t ifd;
+
+	while ((ifd = accept4(pxserver->pxlistener->ifd, NULL, NULL,
+					SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+		pxconn = calloc(1, sizeof(x_ipc_conn));
+		if (pxconn == NULL) {
+			LOGF_LOG_DEBUG("memory allocation failed for connection\n");
+			close(ifd);
+			continue;
+		}
+		pxconn->ifd = ifd;
+		pxconn->uievents = EPOLLIN;
+		memset(&xev, 0, sizeof(xev));
+		xev.events = EPOLLIN;
+		xev.data.ptr = pxconn;
+		if (epoll_ctl(pxserver->iepfd, EPOLL_CTL_ADD, ifd, &xev) < 0) {
+			close(ifd);
+			free(pxconn);
+			continue;
+		}
+		pxconn->pxnext = pxserver->pxconns;
+		if (pxconn->pxnext != NULL)
+			pxconn->pxnext->pxprev = pxconn;
+		pxserver->pxconns = pxconn;
+		pxserver->inconns++;
+	}
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_create
+**   Description      : API to create a listener pucto whose requests are
+**                      handed to pfnhandler by ipc_server_dispatch
+**   Return Value     : Success -> server
+**                      Failure -> NULL
+** ===========================================================================*/
+
+void*
+ipc_server_create(char *pucto, pfn_ipc_handler pfnhandler, void *pvarg)
+{
+	return ipc_server_create_ex(pucto, IPC_TRANSPORT_STREAM, pfnhandler, pvarg);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_create_ex
+**   Description      : API to create a server on transport itransport
+**   Return Value     : Success -> server
+**                      Failure -> NULL
+** ===========================================================================*/
+
+void*
+ipc_server_create_ex(char *pucto, int32_t itransport, pfn_ipc_handler pfnhandler,
+		void *pvarg)
+{
+	struct epoll_event xev;
+	x_ipc_server *pxserver;
+
+	if (pfnhandler == NULL)
+		return NULL;
+	pxserver = calloc(1, sizeof(x_ipc_server));
+	if (pxserver == NULL) {
+		LOGF_LOG_DEBUG("memory allocation failed for server\n");
+		return NULL;
+	}
+	pxserver->pfnhandler = pfnhandler;
+	pxserver->pvarg = pvarg;
+	pxserver->iepfd = -1;
+
+	pxserver->pxlistener = ipc_create_listener_ex(pucto, itransport);
+	if (pxserver->pxlistener == NULL)
+		goto returnHandler;
+	/* Clients connecting at once wait in the backlog, not refused */
+	if (listen(pxserver->pxlistener->ifd, SOMAXCONN) < 0 ||
+			fcntl(pxserver->pxlistener->ifd, F_SETFL, O_NONBLOCK) < 0) {
+		LOGF_LOG_DEBUG("ipc server listener setup failed\n");
+		goto returnHandler;
+	}
+	pxserver->iepfd = epoll_create1(EPOLL_CLOEXEC);
+	if (pxserver->iepfd < 0) {
+		LOGF_LOG_DEBUG("ipc server epoll failed\n");
+		goto returnHandler;
+	}
+	/* The listener is the only entry without a connection */
+	memset(&xev, 0, sizeof(xev));
+	xev.events = EPOLLIN;
+	xev.data.ptr = NULL;
+	if (epoll_ctl(pxserver->iepfd, EPOLL_CTL_ADD, pxserver->pxlistener->ifd, &xev) < 0)
+		goto returnHandler;
+	return pxserver;
+
+returnHandler:
+	ipc_server_destroy(pxserver);
+	return NULL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_fd
+**   Description      : API to get the fd that polls readable when
+**                      ipc_server_dispatch has work
+**   Return Value     : Success -> fd
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_server_fd(void *pvserver)
+{
+	x_ipc_server *pxserver = pvserver;
+
+	return (pxserver != NULL) ? pxserver->iepfd : IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_dispatch
+**   Description      : API to wait up to itimeoutms (-1 forever) for
+**                      clients and handle what arrived
+**   Return Value     : Success -> number of events handled, 0 on timeout
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_server_dispatch(void *pvserver, int32_t itimeoutms)
+{
+	struct epoll_event axev[IPC_SERVER_EVENTS];
+	x_ipc_server *pxserver = pvserver;
+	x_ipc_conn *pxconn;
+	int32_t i, iret, nevents;
+
+	if (pxserver == NULL)
+		return IPC_FAIL;
+	nevents = epoll_wait(pxserver->iepfd, axev, IPC_SERVER_EVENTS, itimeoutms);
+	if (nevents < 0)
+		return (errno == EINTR) ? 0 : IPC_FAIL;
+
+	for (i = 0; i < nevents; i++) {
+		pxconn = axev[i].data.ptr;
+		if (pxconn == NULL) {
+			ipc_server_accept(pxserver);
+			continue;
+		}
+		if (pxconn->itxlen > 0)
+			iret = ipc_server_flush(pxserver, pxconn);
+		else if (axev[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			iret = ipc_server_input(pxserver, pxconn);
+		else
+			iret = IPC_SUCCESS;
+		if (iret != IPC_SUCCESS)
+			ipc_server_drop(pxserver, pxconn);
+	}
+	return nevents;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_server_destroy
+**   Description      : API to close the listener and all its clients
+**   Return Value     : None
+** ===========================================================================*/
+
+void
+ipc_server_destroy(void *pvserver)
+{
+	x_ipc_server *pxserver = pvserver;
+
+	if (pxserver == NULL)
+		return;
+	while (pxserver->pxconns != NULL)
+		ipc_server_drop(pxserver, pxserver->pxconns);
+	if (pxserver->iepfd >= 0)
+		close(pxserver->iepfd);
+	if (pxserver->pxlistener != NULL) {
+		close(pxserver->pxlistener->ifd);
+		free(pxserver->pxlistener);
+	}
+	free(pxserver);
+}
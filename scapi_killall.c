@@ -21,19 +21,45 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <dirent.h>
+#include <stdbool.h>
 #include <string.h>
 #include <signal.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/types.h>
+#include <sys/syscall.h>
 #include <errno.h>
 #include <unistd.h>
 
 #include <ulogging.h>
 #include <ltq_api_include.h>
+#include <scapi_procscan.h>
 
-static char* extractNameFrmStat(pid_t);
-static pid_t nameMatch(pid_t, const char*);
-static pid_t* findPidByName(const char*);
+static int findPidByName(const char*, ScapiPidVec_t*);
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
+/* without pidfds, exits are checked this often while waiting */
+#define KILL_WAIT_POLL_MS 10
+
+/* A process to signal, pinned by a pidfd when the kernel has them */
+typedef struct {
+	pid_t nPid;
+	int nPidFd;
+	int nNameIdx;
+} KillTarget_t;
+
+typedef struct {
+	KillTarget_t *pxTargets;
+	int nCnt;
+	int nCap;
+	bool bNoPidFd;
+} KillTargets_t;
 
 
 /*====================Implementation==========================*/ 
@@ -68,7 +94,7 @@ int scapi_killAll(char *pcProcessName, int nSignal)
 	int nKilledCount = 0;
 	int nkillReturn = 0;
 	int nKillError = 0;
-	pid_t *pidList = NULL;
+	ScapiPidVec_t xPids = {0};
 	int nSigno = 0;
 	//if signal is -ve , then SIGTERM(15) is the default signal
 	if(nSignal < 0)
@@ -78,8 +104,7 @@ int scapi_killAll(char *pcProcessName, int nSignal)
 		nSigno = nSignal;
 	}
 
-	pidList = findPidByName(pcProcessName);
-	if(pidList == NULL)
+	if(findPidByName(pcProcessName, &xPids) != EXIT_SUCCESS)
 	{
 		nRet = -EXIT_FAILURE;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
@@ -87,17 +112,17 @@ int scapi_killAll(char *pcProcessName, int nSignal)
 	}
 
 	//If there is no related process
-	if(pidList[0] == 0)
+	if(xPids.nCnt == 0)
 	{
 		nRet = -ESRCH;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto errorHandler;
 	}
-	//iterating through 'related_processes[]' array till '0' is encountered and killing each process individually
-	for(nNum = 0; pidList[nNum] != 0;++nNum )
+	//killing each related process individually
+	for(nNum = 0; nNum < xPids.nCnt; ++nNum)
 	{
 		//kill returns a 0 if it successfully killed/signal_sent to process
-		nkillReturn = kill(pidList[nNum], nSigno);
+		nkillReturn = kill(xPids.pnPids[nNum], nSigno);
 		//as soon as kill() is executed, errors if any are saved to 'errno' variable
 		nKillError = errno;
 		nkillReturn ? perror("error:"): ++nKilledCount;
@@ -131,12 +156,18 @@ errorHandler:
 		}
 		remove(sBuf);
 	}
-	if(pidList != NULL)
-		free(pidList);
+	scapi_pidVecFree(&xPids);
 	return nRet;
 }
 
 
+static int collectPid(pid_t nPid, int nNameIdx, uint64_t ullStartTime, void *pvArg)
+{
+	(void)nNameIdx;
+	(void)ullStartTime;
+	return scapi_pidVecPush((ScapiPidVec_t *)pvArg, nPid);
+}
+
 /* 
  ** =============================================================================
  **   Function Name    :findPidByName
@@ -144,174 +175,293 @@ errorHandler:
  **   Description      :Gives the list of process numbers related to a name
  **
  **   Parameters       :pcProcName -> process name
+ **						pxPids -> related processes, no limit on their number
  **
- **   Return Value     :On failure -> returns NULL
- **						On success -> returns list related processes
+ **   Return Value     :On failure -> -ve value
+ **						On success -> EXIT_SUCCESS
  ** 
- **   Notes            :It is the duty of the caller to free this list 
+ **   Notes            :It is the duty of the caller to free the list with scapi_pidVecFree()
  **
  ** ============================================================================
  */
-static pid_t* findPidByName(const char *pcProcName)
+static int findPidByName(const char *pcProcName, ScapiPidVec_t *pxPids)
 {
-	pid_t *pidList = NULL;
-	pid_t *pnRet = NULL;
-	DIR *pdir = NULL;
-	struct dirent *entry = NULL;
-	pid_t pid;
-	int nCount = 0;
-
-	pidList = (pid_t*)calloc(1, sizeof(pid_t)*64);
-
-	if(pidList == NULL){
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", -errno, strerror(errno));
-		pnRet = NULL;
-		goto returnHandler;
-	}
-
-	pdir = opendir("/proc");
+	int nRet = scapi_procScan(&pcProcName, 1, collectPid, pxPids);
 
-	if(pdir == NULL)
+	if(nRet != EXIT_SUCCESS)
 	{
-		pnRet = NULL;
-		free(pidList);
-		goto returnHandler;
+		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+		scapi_pidVecFree(pxPids);
 	}
+	return nRet;
+}
 
-	//iterating through every entry in 'proc' folder
-	while((entry = readdir(pdir)))
+/* 
+ ** =============================================================================
+ **   Function Name    :collectTarget
+ **
+ **   Description      :Scan callback of scapi_killAllMulti: opens a pidfd for
+ **			the process and checks it is still the one the scan saw
+ **			(same start time), the pid may have been reused since
+ **
+ ** ============================================================================
+ */
+static int collectTarget(pid_t nPid, int nNameIdx, uint64_t ullStartTime, void *pvArg)
+{
+	KillTargets_t *pxTargets = (KillTargets_t *)pvArg;
+	KillTarget_t *pxNew = NULL;
+	char sStat[SCAPI_PROC_STAT_LEN];
+	char *pcComm = NULL;
+	uint64_t ullStartNow = 0;
+	int nPidFd = -1;
+
+	if(!pxTargets->bNoPidFd)
 	{
-		pid = (pid_t)strtoul(entry->d_name, NULL, 10);
-		//continue if not a pid
-		if(pid == 0)
-			continue;
-		pid_t name_match_value = nameMatch(pid, pcProcName);
-
-		//collecting all the processes whose name matches.Will be able to collect a maximum of 63 processes
-		if((name_match_value) && (nCount<63))
+		if((nPidFd = syscall(SYS_pidfd_open, nPid, 0)) < 0)
 		{
-			pidList[nCount] = name_match_value;
-			++nCount;
+			if(errno != ENOSYS)
+				return EXIT_SUCCESS; // process already gone
+			pxTargets->bNoPidFd = true;
 		}
-		//if number of related processes crosses the limit
-		if(nCount >= 63)
+		else if(scapi_procReadStat(scapi_procDirFd(), nPid, sStat, sizeof(sStat), &pcComm, &ullStartNow) != EXIT_SUCCESS ||
+				ullStartNow != ullStartTime)
 		{
-			LOGF_LOG_DEBUG("Process limit exceeded\n");
-			pidList[nCount] = 0;
-			pnRet = pidList;
-			goto returnHandler;
+			close(nPidFd);
+			return EXIT_SUCCESS;
 		}
 	}
-	//delimiting the list with 0 since no process can have a 0 pid value
-	pidList[nCount] = 0;
-	//it is the duty of the caller to free the pid list
-	pnRet = pidList;
 
-returnHandler:
-	//no need to close if dir is not open. i.e pdir = NULL
-	if(pdir)
-		closedir(pdir);
-	return pnRet;
+	if(pxTargets->nCnt == pxTargets->nCap)
+	{
+		pxNew = realloc(pxTargets->pxTargets, (pxTargets->nCap ? pxTargets->nCap * 2 : 16) * sizeof(KillTarget_t));
+		if(pxNew == NULL)
+		{
+			if(nPidFd >= 0)
+				close(nPidFd);
+			return -ENOMEM;
+		}
+		pxTargets->pxTargets = pxNew;
+		pxTargets->nCap = pxTargets->nCap ? pxTargets->nCap * 2 : 16;
+	}
+	pxTargets->pxTargets[pxTargets->nCnt].nPid = nPid;
+	pxTargets->pxTargets[pxTargets->nCnt].nPidFd = nPidFd;
+	pxTargets->pxTargets[pxTargets->nCnt].nNameIdx = nNameIdx;
+	pxTargets->nCnt++;
+	return EXIT_SUCCESS;
 }
 
+static int64_t monotonicMs(void)
+{
+	struct timespec xNow;
 
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	return (int64_t)xNow.tv_sec * 1000 + xNow.tv_nsec / 1000000;
+}
 
 /* 
  ** =============================================================================
- **   Function Name    :extractNameFrmStat
+ **   Function Name    :isExited
  **
- **   Description      :extracts the process name related to a process number
+ **   Description      :Tells whether a process found without a pidfd has
+ **			exited: gone, or a zombie its parent has not reaped yet,
+ **			which kill(pid, 0) still reports as running
  **
- **   Parameters       :PID Number  
+ ** ============================================================================
+ */
+static bool isExited(pid_t nPid)
+{
+	char sStat[SCAPI_PROC_STAT_LEN];
+	char *pcComm = NULL;
+
+	if(kill(nPid, 0) != 0 && errno == ESRCH)
+		return true;
+	if(scapi_procReadStat(scapi_procDirFd(), nPid, sStat, sizeof(sStat), &pcComm, NULL) != EXIT_SUCCESS)
+		return false;
+	/* the name ends at the last ')', the state follows ") " */
+	pcComm += strlen(pcComm) + 2;
+	return (pcComm < sStat + sizeof(sStat) && (*pcComm == 'Z' || *pcComm == 'X'));
+}
+
+/* 
+ ** =============================================================================
+ **   Function Name    :waitTargets
  **
- **   Return Value     :On failure returns respective error strings
- **						On success returns process name stored in the stat file of that pid.  /proc/PID/stat 
- ** 
- **   Notes            :  
+ **   Description      :Waits until the signalled processes have exited: poll()
+ **			on their pidfds, or a check every KILL_WAIT_POLL_MS
+ **			without pidfds. nTimeoutMs <= 0 waits forever
+ **
+ **   Return Value     :EXIT_SUCCESS, -ETIMEDOUT or -ENOMEM
  **
  ** ============================================================================
  */
-static char* extractNameFrmStat(pid_t processNumber)
+static int waitTargets(KillTargets_t *pxTargets, const bool *pbSignalled, int nTimeoutMs)
 {
-	char sFileName[32] = {0};
-	char sBuffer[256] = {0};
-	FILE *pfFile = NULL;
-	char *pcName = NULL;
-	char *pcStart = NULL;
-	char *pcEnd = NULL;
-	char *pcRet = NULL;
-
-	if (sprintf_s(sFileName, 32, "/proc/%lu/stat", (unsigned long)processNumber) <= 0) {
-		LOGF_LOG_ERROR("ERROR = sprintf_s failed\n");
-		return NULL;
-	}
-
-	pfFile = scapi_getFilePtr(sFileName, "r");
-
-	if(pfFile == NULL)
+	struct pollfd *pxPfds = NULL;
+	int64_t llDeadline = monotonicMs() + nTimeoutMs;
+	int64_t llLeft = -1;
+	int i = 0, nAlive = 0, nRet = -EXIT_FAILURE;
+
+	if((pxPfds = calloc(pxTargets->nCnt, sizeof(struct pollfd))) == NULL)
+		return -ENOMEM;
+	for(i = 0; i < pxTargets->nCnt; i++)
 	{
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", -errno, strerror(errno));
-		// process probably exited
-		pcRet = NULL;
-		goto returnHandler;
+		pxPfds[i].fd = pbSignalled[i] ? pxTargets->pxTargets[i].nPidFd : -1;
+		pxPfds[i].events = POLLIN;
 	}
 
-	//fgets reads min(line,256 chars). First line is sufficient for our use. Now buffer contains name of the procss enclosed in (). eg. (firefox)
-	if (!fgets(sBuffer, 256, pfFile)) {
-		LOGF_LOG_ERROR("ERROR occurred when read from file. %d %s \n", errno, strerror(errno));
-		pcRet = NULL;
-		goto returnHandler;
-	}
-	//iterating through the sBuffer till ')' is encountered and replacing it with \0
-	pcEnd = strrchr(sBuffer, ')');
-	if(pcEnd == NULL)
-	{
-		LOGF_LOG_ERROR("ERROR = ')' Not found to extract process name\n");
-		pcRet = NULL;
-		goto returnHandler;
-	}
-	pcEnd[0] = '\0';
-	//forming a C string by pointing 'name' to first character after '(' 
-	pcStart = strchr(sBuffer, '(');
-	if(pcStart == NULL)
+	for(;;)
 	{
-		LOGF_LOG_ERROR("ERROR = '(' Not found to extract process name\n");
-		pcRet = NULL;
-		goto returnHandler;
+		nAlive = 0;
+		for(i = 0; i < pxTargets->nCnt; i++)
+		{
+			if(!pbSignalled[i])
+				continue;
+			if(pxPfds[i].fd >= 0)
+			{
+				/* a pidfd becomes readable once the process has exited */
+				if(pxPfds[i].revents & (POLLIN | POLLHUP | POLLERR))
+					pxPfds[i].fd = -1;
+				else
+					nAlive++;
+			}
+			else if(pxTargets->pxTargets[i].nPidFd < 0 && pxTargets->pxTargets[i].nPid != 0)
+			{
+				if(isExited(pxTargets->pxTargets[i].nPid))
+					pxTargets->pxTargets[i].nPid = 0;
+				else
+					nAlive++;
+			}
+		}
+		if(nAlive == 0)
+		{
+			nRet = EXIT_SUCCESS;
+			break;
+		}
+		if(nTimeoutMs > 0 && (llLeft = llDeadline - monotonicMs()) <= 0)
+		{
+			nRet = -ETIMEDOUT;
+			LOGF_LOG_DEBUG("%d processes still running after %d ms\n", nAlive, nTimeoutMs);
+			break;
+		}
+		if(pxTargets->bNoPidFd && (llLeft < 0 || llLeft > KILL_WAIT_POLL_MS))
+			llLeft = KILL_WAIT_POLL_MS;
+		if(poll(pxPfds, pxTargets->nCnt, (int)llLeft) < 0 && errno != EINTR)
+		{
+			nRet = -errno;
+			break;
+		}
 	}
-	pcName = pcStart + 1;
-	pcRet = strdup(pcName);
-returnHandler:
-	//no point in closing when the file in not opened
-	if( pfFile != NULL)
-		fclose(pfFile);
-	return pcRet;
+	free(pxPfds);
+	return nRet;
 }
 
 /* 
  ** =============================================================================
- **   Function Name    :nameMatch
+ **   Function Name    :scapi_killAllMulti
  **
- **   Description      :Checks if process name matches with the name in /proc/PID/stat file
+ **   Description      :Sends given signal to all the processes of several app
+ **			names, found with a single walk of /proc. Signals go
+ **			through pidfds so a reused pid is never hit, kill() is
+ **			used on kernels without them
  **
- **   Parameters       :processId -> process id
- **						pcName -> equivalent process name
+ **   Parameters       :ppcNames -> process names
+ **						nCount -> number of names
+ **						nSignal -> signal number, -ve for SIGTERM
+ **						unFlags -> SCAPI_KILL_WAIT, SCAPI_KILL_KEEP_PIDFILE
+ **						nTimeoutMs -> how long SCAPI_KILL_WAIT waits, 0 or
+ **						-ve to wait until all have exited
  **
- **   Return Value     :returns process id if name matches or else returns zero
- ** 
- **   Notes            :  
+ **   Return Value     :On Failure -> -EINVAL for invalid input, -ESRCH if there are
+ **						no related processes, -EPERM if none could be signalled,
+ **						-ETIMEDOUT if SCAPI_KILL_WAIT is set and some are still
+ **						running at the deadline
+ **						On Success -> EXIT_SUCCESS
+ **
+ **   Notes            :Like scapi_killAll, /var/run/<name>.pid is removed after a
+ **						successful SIGTERM/SIGKILL
  **
  ** ============================================================================
  */
-static pid_t nameMatch(pid_t processId, const char* pcName) 
+int scapi_killAllMulti(char **ppcNames, int nCount, int nSignal, unsigned int unFlags, int nTimeoutMs)
 {
-	char* pcStatName = NULL;
-	int nRet = -1;
-	pcStatName = extractNameFrmStat(processId);
-	if(pcStatName != NULL){
-		nRet = strncasecmp(pcName, pcStatName, 15);
-		free(pcStatName);
+	KillTargets_t xTargets = {0};
+	bool *pbSignalled = NULL, *pbNameHit = NULL;
+	int nSigno = (nSignal < 0) ? SIGTERM : nSignal;
+	int i = 0, nKilledCount = 0, nKillError = -ESRCH, nSent = 0, nRet = -EXIT_FAILURE;
+	char sBuf[64] = {0};
+
+	if(ppcNames == NULL || nCount <= 0)
+	{
+		nRet = -EINVAL;
+		goto returnHandler;
 	}
-	return nRet==0?processId:0;
-}
 
+	if((nRet = scapi_procScan((const char * const *)ppcNames, nCount, collectTarget, &xTargets)) != EXIT_SUCCESS)
+	{
+		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	//If there is no related process
+	if(xTargets.nCnt == 0)
+	{
+		nRet = -ESRCH;
+		LOGF_LOG_DEBUG("DEBUG = No Process to kill\n");
+		goto returnHandler;
+	}
+
+	pbSignalled = calloc(xTargets.nCnt, sizeof(bool));
+	pbNameHit = calloc(nCount, sizeof(bool));
+	if(pbSignalled == NULL || pbNameHit == NULL)
+	{
+		nRet = -ENOMEM;
+		goto returnHandler;
+	}
+
+	for(i = 0; i < xTargets.nCnt; i++)
+	{
+		if(xTargets.pxTargets[i].nPidFd >= 0)
+			nSent = syscall(SYS_pidfd_send_signal, xTargets.pxTargets[i].nPidFd, nSigno, NULL, 0);
+		else
+			nSent = kill(xTargets.pxTargets[i].nPid, nSigno);
+		if(nSent == 0)
+		{
+			pbSignalled[i] = true;
+			pbNameHit[xTargets.pxTargets[i].nNameIdx] = true;
+			nKilledCount++;
+		}
+		else if(errno == EPERM)
+		{
+			nKillError = -EPERM;
+		}
+	}
+	if(nKilledCount == 0)
+	{
+		nRet = nKillError;
+		goto returnHandler;
+	}
+
+	nRet = EXIT_SUCCESS;
+	if(unFlags & SCAPI_KILL_WAIT)
+		nRet = waitTargets(&xTargets, pbSignalled, nTimeoutMs);
+
+	/*cleaning*/
+	if((nSigno == SIGKILL || nSigno == SIGTERM) && !(unFlags & SCAPI_KILL_KEEP_PIDFILE))
+	{
+		for(i = 0; i < nCount; i++)
+		{
+			if(!pbNameHit[i])
+				continue;
+			if(sprintf_s(sBuf, sizeof(sBuf), "/var/run/%s.pid", ppcNames[i]) <= 0)
+				continue;
+			remove(sBuf);
+		}
+	}
+returnHandler:
+	for(i = 0; i < xTargets.nCnt; i++)
+		if(xTargets.pxTargets[i].nPidFd >= 0)
+			close(xTargets.pxTargets[i].nPidFd);
+	free(xTargets.pxTargets);
+	free(pbSignalled);
+	free(pbNameHit);
+	return nRet;
+}
@@ -0,0 +1,448 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_netlink.c                                            *
+ *     Project    : UGW                                                        *
+ *     Description: rtnetlink socket, dump and message parsing helpers         *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+#include <scapi_netlink.h>
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlWalk
+ **
+ **   Description      :Walks the messages of one netlink datagram
+ **
+ **   Parameters       :pcBuf(IN), nLen(IN) -> received datagram
+ **			unSeq(IN) -> sequence to accept, 0 accepts every message
+ **			bDump(IN) -> consume NLMSG_DONE/NLMSG_ERROR instead of
+ **			passing them to the callback
+ **			pfnCb(IN), pvArg(IN) -> per message callback
+ **			pbDone(OUT) -> set on NLMSG_DONE
+ **			pbIntr(OUT) -> set when the kernel flagged the dump as
+ **			inconsistent
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -ve value returned by the callback or the kernel
+ **
+ ** ============================================================================
+ */
+static int scapi_nlWalk(char *pcBuf, int nLen, uint32_t unSeq, bool bDump,
+		pfnScapiNlCb pfnCb, void *pvArg, bool *pbDone, bool *pbIntr)
+{
+	struct nlmsghdr *pxNlh = NULL;
+	struct nlmsgerr *pxErr = NULL;
+	int nRet = EXIT_SUCCESS;
+
+	for(pxNlh = (struct nlmsghdr *)pcBuf; NLMSG_OK(pxNlh, (unsigned int)nLen); pxNlh = NLMSG_NEXT(pxNlh, nLen))
+	{
+		if(unSeq != 0 && pxNlh->nlmsg_seq != unSeq)
+			continue;
+		if(pxNlh->nlmsg_flags & NLM_F_DUMP_INTR)
+			*pbIntr = true;
+		if(bDump)
+		{
+			if(pxNlh->nlmsg_type == NLMSG_DONE)
+			{
+				*pbDone = true;
+				break;
+			}
+			if(pxNlh->nlmsg_type == NLMSG_ERROR)
+			{
+				pxErr = NLMSG_DATA(pxNlh);
+				*pbDone = true;
+				if(pxNlh->nlmsg_len >= NLMSG_LENGTH(sizeof(*pxErr)) && pxErr->error < 0)
+					nRet = pxErr->error;
+				break;
+			}
+		}
+		if((nRet = pfnCb(pxNlh, pvArg)) < 0)
+			break;
+		nRet = EXIT_SUCCESS;
+	}
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlRecvOne
+ **
+ **   Description      :One recvmsg() on a netlink socket
+ **
+ **   Parameters       :nFd(IN) -> netlink socket
+ **			pcBuf(OUT) -> SCAPI_NL_BUF_SIZE buffer
+ **			nFlags(IN) -> recvmsg flags, e.g MSG_DONTWAIT
+ **
+ **   Return Value     :Success -> received length, 0 when nothing is queued
+ **			Failure -> -errno, -EMSGSIZE on truncation
+ **
+ ** ============================================================================
+ */
+static int scapi_nlRecvOne(int nFd, char *pcBuf, int nFlags)
+{
+	struct sockaddr_nl xAddr = {0};
+	struct iovec xIov = { pcBuf, SCAPI_NL_BUF_SIZE };
+	struct msghdr xMsg = {0};
+	int nRet = -EXIT_FAILURE;
+
+	xMsg.msg_name = &xAddr;
+	xMsg.msg_namelen = sizeof(xAddr);
+	xMsg.msg_iov = &xIov;
+	xMsg.msg_iovlen = 1;
+
+	do {
+		nRet = recvmsg(nFd, &xMsg, nFlags);
+	} while(nRet < 0 && errno == EINTR);
+
+	if(nRet < 0)
+	{
+		nRet = (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -errno;
+		goto returnHandler;
+	}
+	if(xMsg.msg_flags & MSG_TRUNC)
+	{
+		nRet = -EMSGSIZE;
+		LOGF_LOG_ERROR("ERROR = netlink message truncated\n");
+		goto returnHandler;
+	}
+	/* Only the kernel is allowed to talk to us */
+	if(xAddr.nl_pid != 0)
+		nRet = 0;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlOpen
+ **
+ **   Description      :Opens a NETLINK_ROUTE socket
+ **
+ **   Parameters       :unGroups(IN) -> RTMGRP_* multicast groups, 0 for none
+ **
+ **   Return Value     :Success -> socket descriptor
+ **			Failure -> -errno
+ **
+ ** ============================================================================
+ */
+int scapi_nlOpen(uint32_t unGroups)
+{
+	struct sockaddr_nl xAddr = {0};
+	int nFd = -1, nRet = -EXIT_FAILURE;
+
+	nFd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if(nFd < 0)
+	{
+		nRet = -errno;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	xAddr.nl_family = AF_NETLINK;
+	xAddr.nl_groups = unGroups;
+	if(bind(nFd, (struct sockaddr *)&xAddr, sizeof(xAddr)) < 0)
+	{
+		nRet = -errno;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		close(nFd);
+		goto returnHandler;
+	}
+	nRet = nFd;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlDump
+ **
+ **   Description      :Sends a dump request and walks all the replies
+ **
+ **   Parameters       :nFd(IN) -> netlink socket
+ **			unType(IN) -> RTM_GETLINK, RTM_GETADDR...
+ **			ucFamily(IN) -> AF_UNSPEC, AF_INET...
+ **			unSeq(IN) -> non zero request sequence
+ **			pfnCb(IN), pvArg(IN) -> per message callback
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -EAGAIN when the dump was interrupted by a
+ **			concurrent change and has to be redone, other -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_nlDump(int nFd, uint16_t unType, uint8_t ucFamily, uint32_t unSeq, pfnScapiNlCb pfnCb, void *pvArg)
+{
+	struct {
+		struct nlmsghdr xNlh;
+		struct ifinfomsg xIfi;
+	} xReq;
+	struct sockaddr_nl xKernel = {0};
+	char *pcBuf = NULL;
+	bool bDone = false, bIntr = false;
+	int nLen = 0, nRet = -EXIT_FAILURE;
+
+	memset(&xReq, 0, sizeof(xReq));
+	/* ifaddrmsg and ifinfomsg both start with the family byte */
+	xReq.xNlh.nlmsg_len = NLMSG_LENGTH((unType == RTM_GETADDR) ? sizeof(struct ifaddrmsg) : sizeof(struct ifinfomsg));
+	xReq.xNlh.nlmsg_type = unType;
+	xReq.xNlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	xReq.xNlh.nlmsg_seq = unSeq;
+	xReq.xIfi.ifi_family = ucFamily;
+	xKernel.nl_family = AF_NETLINK;
+
+	pcBuf = malloc(SCAPI_NL_BUF_SIZE);
+	if(pcBuf == NULL)
+	{
+		nRet = -ENOMEM;
+		goto returnHandler;
+	}
+	if(sendto(nFd, &xReq, xReq.xNlh.nlmsg_len, 0, (struct sockaddr *)&xKernel, sizeof(xKernel)) < 0)
+	{
+		nRet = -errno;
+		LOGF_LOG_ERROR("ERROR = %d -> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	while(!bDone)
+	{
+		nLen = scapi_nlRecvOne(nFd, pcBuf, 0);
+		if(nLen < 0)
+		{
+			nRet = nLen;
+			goto returnHandler;
+		}
+		if((nRet = scapi_nlWalk(pcBuf, nLen, unSeq, true, pfnCb, pvArg, &bDone, &bIntr)) < 0)
+		{
+			/* Drain the rest of the dump so that the socket stays usable.
+			   The walk stopped early, the end of the dump may already be
+			   in this datagram; a socket with nothing queued ends it too */
+			while(!bDone)
+			{
+				struct nlmsghdr *pxNlh = NULL;
+				int nLeft = nLen;
+
+				for(pxNlh = (struct nlmsghdr *)pcBuf; NLMSG_OK(pxNlh, (unsigned int)nLeft); pxNlh = NLMSG_NEXT(pxNlh, nLeft))
+					if(pxNlh->nlmsg_seq == unSeq && (pxNlh->nlmsg_type == NLMSG_DONE || pxNlh->nlmsg_type == NLMSG_ERROR))
+						bDone = true;
+				if(!bDone && (nLen = scapi_nlRecvOne(nFd, pcBuf, 0)) <= 0)
+					break;
+			}
+			goto returnHandler;
+		}
+	}
+	nRet = bIntr ? -EAGAIN : EXIT_SUCCESS;
+returnHandler:
+	free(pcBuf);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlRecv
+ **
+ **   Description      :Reads one datagram and walks every message in it,
+ **			acks and errors included
+ **
+ **   Parameters       :nFd(IN) -> netlink socket
+ **			nFlags(IN) -> recvmsg flags, MSG_DONTWAIT to poll
+ **			pfnCb(IN), pvArg(IN) -> per message callback
+ **
+ **   Return Value     :Success -> bytes processed, 0 if nothing was queued
+ **			Failure -> -ENOBUFS when the kernel dropped notifications,
+ **			other -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_nlRecv(int nFd, int nFlags, pfnScapiNlCb pfnCb, void *pvArg)
+{
+	char *pcBuf = NULL;
+	bool bDone = false, bIntr = false;
+	int nLen = 0, nRet = -EXIT_FAILURE;
+
+	pcBuf = malloc(SCAPI_NL_BUF_SIZE);
+	if(pcBuf == NULL)
+	{
+		nRet = -ENOMEM;
+		goto returnHandler;
+	}
+	nLen = scapi_nlRecvOne(nFd, pcBuf, nFlags);
+	if(nLen <= 0)
+	{
+		nRet = nLen;
+		goto returnHandler;
+	}
+	if((nRet = scapi_nlWalk(pcBuf, nLen, 0, false, pfnCb, pvArg, &bDone, &bIntr)) < 0)
+		goto returnHandler;
+	nRet = nLen;
+returnHandler:
+	free(pcBuf);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlParseLink
+ **
+ **   Description      :Decodes a RTM_NEWLINK/RTM_DELLINK message
+ **
+ **   Parameters       :pxNlh(IN) -> netlink message
+ **			pxIfc(OUT) -> decoded interface, address fields cleared
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -EINVAL
+ **
+ **   Notes            :Hardware address is formatted the same way as
+ **			scapi_getIfcMacaddr() does it, i.e always six octets
+ **
+ ** ============================================================================
+ */
+int scapi_nlParseLink(struct nlmsghdr *pxNlh, IfcSnapshot_t *pxIfc)
+{
+	struct ifinfomsg *pxIfi = NLMSG_DATA(pxNlh);
+	struct rtattr *pxRta = NULL;
+	unsigned char aucMac[6] = {0};
+	int nLen = (int)pxNlh->nlmsg_len - (int)NLMSG_LENGTH(sizeof(*pxIfi));
+	int nRet = -EINVAL;
+
+	if(nLen < 0)
+		goto returnHandler;
+
+	memset(pxIfc, 0, sizeof(*pxIfc));
+	pxIfc->nIfindex = pxIfi->ifi_index;
+	pxIfc->unFlags = pxIfi->ifi_flags;
+
+	for(pxRta = IFLA_RTA(pxIfi); RTA_OK(pxRta, nLen); pxRta = RTA_NEXT(pxRta, nLen))
+	{
+		switch(pxRta->rta_type)
+		{
+			case IFLA_IFNAME:
+				if(strncpy_s(pxIfc->sIfname, IFNAMSIZ, RTA_DATA(pxRta), RTA_PAYLOAD(pxRta)) != EOK)
+					goto returnHandler;
+				break;
+			case IFLA_MTU:
+				if(RTA_PAYLOAD(pxRta) >= sizeof(uint32_t))
+					pxIfc->unMtu = *(uint32_t *)RTA_DATA(pxRta);
+				break;
+			case IFLA_TXQLEN:
+				if(RTA_PAYLOAD(pxRta) >= sizeof(uint32_t))
+					pxIfc->unTxQueuelen = *(uint32_t *)RTA_DATA(pxRta);
+				break;
+			case IFLA_ADDRESS:
+				memcpy(aucMac, RTA_DATA(pxRta), (RTA_PAYLOAD(pxRta) < sizeof(aucMac)) ? RTA_PAYLOAD(pxRta) : sizeof(aucMac));
+				break;
+			default:
+				break;
+		}
+	}
+	if(pxIfc->sIfname[0] == '\0')
+		goto returnHandler;
+
+	if(sprintf_s(pxIfc->sMac, SCAPI_MAC_LEN, "%.2x:%.2x:%.2x:%.2x:%.2x:%.2x",
+			aucMac[0], aucMac[1], aucMac[2], aucMac[3], aucMac[4], aucMac[5]) <= 0)
+		goto returnHandler;
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nlParseAddr
+ **
+ **   Description      :Decodes a RTM_NEWADDR/RTM_DELADDR message
+ **
+ **   Parameters       :pxNlh(IN) -> netlink message
+ **			pnIfindex(OUT) -> interface the address belongs to
+ **			pxAddr(OUT) -> decoded address
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **			Failure -> -EAFNOSUPPORT for non ip families, -EINVAL
+ **
+ **   Notes            :For ipv4 IFA_LOCAL is the address of the interface,
+ **			IFA_ADDRESS is the peer on point to point links
+ **
+ ** ============================================================================
+ */
+int scapi_nlParseAddr(struct nlmsghdr *pxNlh, int32_t *pnIfindex, IfcSnapshotAddr_t *pxAddr)
+{
+	struct ifaddrmsg *pxIfa = NLMSG_DATA(pxNlh);
+	struct rtattr *pxRta = NULL;
+	void *pvAddress = NULL, *pvLocal = NULL;
+	size_t nAddrLen = 0;
+	int nLen = (int)pxNlh->nlmsg_len - (int)NLMSG_LENGTH(sizeof(*pxIfa));
+	int nRet = -EINVAL;
+
+	if(nLen < 0)
+		goto returnHandler;
+	if(pxIfa->ifa_family == AF_INET)
+		nAddrLen = sizeof(struct in_addr);
+	else if(pxIfa->ifa_family == AF_INET6)
+		nAddrLen = sizeof(struct in6_addr);
+	else
+	{
+		nRet = -EAFNOSUPPORT;
+		goto returnHandler;
+	}
+
+	memset(pxAddr, 0, sizeof(*pxAddr));
+	*pnIfindex = (int32_t)pxIfa->ifa_index;
+	pxAddr->ucFamily = pxIfa->ifa_family;
+	pxAddr->ucPrefixLen = pxIfa->ifa_prefixlen;
+	pxAddr->ucScope = pxIfa->ifa_scope;
+	pxAddr->unFlags = pxIfa->ifa_flags;
+
+	for(pxRta = IFA_RTA(pxIfa); RTA_OK(pxRta, nLen); pxRta = RTA_NEXT(pxRta, nLen))
+	{
+		switch(pxRta->rta_type)
+		{
+			case IFA_ADDRESS:
+				if(RTA_PAYLOAD(pxRta) >= nAddrLen)
+					pvAddress = RTA_DATA(pxRta);
+				break;
+			case IFA_LOCAL:
+				if(RTA_PAYLOAD(pxRta) >= nAddrLen)
+					pvLocal = RTA_DATA(pxRta);
+				break;
+			case IFA_LABEL:
+				if(strncpy_s(pxAddr->sLabel, IFNAMSIZ, RTA_DATA(pxRta), RTA_PAYLOAD(pxRta)) != EOK)
+					pxAddr->sLabel[0] = '\0';
+				break;
+#ifdef IFA_FLAGS
+			case IFA_FLAGS:
+				/* 32 bit flags, supersede ifa_flags when present */
+				if(RTA_PAYLOAD(pxRta) >= sizeof(uint32_t))
+					pxAddr->unFlags = *(uint32_t *)RTA_DATA(pxRta);
+				break;
+#endif
+			default:
+				break;
+		}
+	}
+	if(pvLocal == NULL)
+		pvLocal = pvAddress;
+	if(pvLocal == NULL)
+		goto returnHandler;
+	if(inet_ntop(pxIfa->ifa_family, pvLocal, pxAddr->sAddr, sizeof(pxAddr->sAddr)) == NULL)
+		goto returnHandler;
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	return nRet;
+}
@@ -0,0 +1,461 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_nextmac_store.c                                      *
+ *     Project    : UGW                                                        *
+ *     Description: Lock protected, append only record log behind the next    *
+ *                  mac config files, compacted once enough records are dead   *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+#include <scapi_nextmac_store.h>
+
+/* "!" + ifname + "> " + mac + "\n" */
+#define NEXT_MAC_REC_LEN (IFNAMSIZ + SCAPI_MAC_LEN + 4)
+
+static NextMacRec_t *scapi_nmStoreLookup(const NextMacStore_t *pxStore, const char *pcIfname)
+{
+	int i = 0;
+
+	for(i = 0; i < pxStore->nCnt; i++)
+		if(strcmp(pxStore->pxRecs[i].sIfname, pcIfname) == 0)
+			return &pxStore->pxRecs[i];
+	return NULL;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nmStorePut
+ **
+ **   Description      :Updates the in memory view with one record
+ **
+ **   Parameters       :pcMac(IN) -> NULL drops the interface
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> -ENOMEM
+ **
+ ** ============================================================================
+ */
+static int scapi_nmStorePut(NextMacStore_t *pxStore, const char *pcIfname, const char *pcMac)
+{
+	NextMacRec_t *pxRec = scapi_nmStoreLookup(pxStore, pcIfname), *pxNew = NULL;
+
+	if(pcMac == NULL)
+	{
+		/* the tombstone and what it drops are both dead */
+		pxStore->nDead++;
+		if(pxRec != NULL)
+		{
+			pxStore->nDead++;
+			*pxRec = pxStore->pxRecs[--pxStore->nCnt];
+		}
+		return EXIT_SUCCESS;
+	}
+	if(pxRec != NULL)
+	{
+		pxStore->nDead++;
+	}
+	else
+	{
+		if(pxStore->nCnt == pxStore->nCap)
+		{
+			pxNew = realloc(pxStore->pxRecs, (pxStore->nCap ? pxStore->nCap * 2 : 32) * sizeof(NextMacRec_t));
+			if(pxNew == NULL)
+				return -ENOMEM;
+			pxStore->pxRecs = pxNew;
+			pxStore->nCap = pxStore->nCap ? pxStore->nCap * 2 : 32;
+		}
+		pxRec = &pxStore->pxRecs[pxStore->nCnt++];
+		strncpy_s(pxRec->sIfname, sizeof(pxRec->sIfname), pcIfname, sizeof(pxRec->sIfname) - 1);
+	}
+	strncpy_s(pxRec->sMac, sizeof(pxRec->sMac), pcMac, sizeof(pxRec->sMac) - 1);
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nmStoreReplay
+ **
+ **   Description      :Replays the complete lines of the log. Lines written by
+ **			older releases ("ifname> mac" or "ifname>mac") are plain
+ **			records
+ **
+ **   Return Value     :length of the complete lines, -ENOMEM
+ **
+ ** ============================================================================
+ */
+static ssize_t scapi_nmStoreReplay(NextMacStore_t *pxStore, char *pcBuf, size_t unLen)
+{
+	char *pcLine = pcBuf, *pcEol = NULL, *pcGt = NULL, *pcMac = NULL, *pcEnd = NULL;
+	bool bDrop = false;
+
+	while(pcLine < pcBuf + unLen && (pcEol = memchr(pcLine, '\n', pcBuf + unLen - pcLine)) != NULL)
+	{
+		*pcEol = '\0';
+		bDrop = (*pcLine == '!');
+		if(bDrop)
+			pcLine++;
+		if((pcGt = strchr(pcLine, '>')) == NULL || pcGt == pcLine || pcGt - pcLine >= IFNAMSIZ)
+			goto skip;
+		*pcGt = '\0';
+		if(bDrop)
+		{
+			if(scapi_nmStorePut(pxStore, pcLine, NULL) != EXIT_SUCCESS)
+				return -ENOMEM;
+			goto next;
+		}
+		for(pcMac = pcGt + 1; *pcMac == ' '; pcMac++)
+			;
+		for(pcEnd = pcMac; *pcEnd != '\0' && *pcEnd != ' ' && *pcEnd != '\r'; pcEnd++)
+			;
+		*pcEnd = '\0';
+		if(pcMac == pcEnd || pcEnd - pcMac >= SCAPI_MAC_LEN)
+			goto skip;
+		if(scapi_nmStorePut(pxStore, pcLine, pcMac) != EXIT_SUCCESS)
+			return -ENOMEM;
+		goto next;
+skip:
+		pxStore->nDead++;
+next:
+		pcLine = pcEol + 1;
+	}
+	return pcLine - pcBuf;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nmStoreOpen
+ **
+ **   Description      :Takes the lock of a next mac conf file and replays it.
+ **			A record cut short by a crash is dropped, and cut off
+ **			the file when opening for write
+ **
+ **   Parameters       :pxStore(OUT) -> store
+ **			pcConf(IN) -> conf file
+ **			pcLock(IN) -> lock file
+ **			bWrite(IN) -> exclusive lock, shared otherwise
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> Different -ve values
+ **
+ ** ============================================================================
+ */
+int scapi_nmStoreOpen(NextMacStore_t *pxStore, const char *pcConf, const char *pcLock, bool bWrite)
+{
+	struct stat st;
+	char *pcBuf = NULL;
+	ssize_t nRead = 0, nValid = 0;
+	size_t unOff = 0;
+	int nFd = -1, nRet = -EXIT_FAILURE;
+
+	memset(pxStore, 0, sizeof(*pxStore));
+	pxStore->pcConf = pcConf;
+	pxStore->nLockFd = -1;
+
+	if((pxStore->nLockFd = open(pcLock, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600)) < 0)
+	{
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		LOGF_LOG_ERROR("Couldn't open lock file %s (%s)\n", pcLock, strerror(errno));
+		goto returnHandler;
+	}
+	while(flock(pxStore->nLockFd, bWrite ? LOCK_EX : LOCK_SH) != 0)
+	{
+		if(errno != EINTR)
+		{
+			nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+			LOGF_LOG_ERROR("Couldn't lock %s (%s)\n", pcLock, strerror(errno));
+			goto returnHandler;
+		}
+	}
+
+	if((nFd = open(pcConf, (bWrite ? O_RDWR : O_RDONLY) | O_CLOEXEC)) < 0)
+	{
+		/* No file yet, empty log */
+		nRet = (errno == ENOENT) ? EXIT_SUCCESS : ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		goto returnHandler;
+	}
+	if(fstat(nFd, &st) != 0)
+	{
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		goto returnHandler;
+	}
+	if((pcBuf = malloc(st.st_size + 1)) == NULL)
+	{
+		nRet = -ENOMEM;
+		goto returnHandler;
+	}
+	while(unOff < (size_t)st.st_size && (nRead = read(nFd, pcBuf + unOff, st.st_size - unOff)) != 0)
+	{
+		if(nRead < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+			goto returnHandler;
+		}
+		unOff += nRead;
+	}
+	if((nValid = scapi_nmStoreReplay(pxStore, pcBuf, unOff)) < 0)
+	{
+		nRet = (int)nValid;
+		goto returnHandler;
+	}
+	if(bWrite && (size_t)nValid != unOff)
+	{
+		LOGF_LOG_INFO("Dropping %zu bytes of a partial record from %s\n", unOff - nValid, pcConf);
+		if(ftruncate(nFd, nValid) != 0)
+		{
+			nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+			goto returnHandler;
+		}
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	free(pcBuf);
+	if(nFd >= 0)
+		close(nFd);
+	if(nRet != EXIT_SUCCESS)
+		scapi_nmStoreClose(pxStore);
+	return nRet;
+}
+
+const NextMacRec_t *scapi_nmStoreFind(const NextMacStore_t *pxStore, const char *pcIfname)
+{
+	return scapi_nmStoreLookup(pxStore, pcIfname);
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nmStorePend
+ **
+ **   Description      :Queues one record for scapi_nmStoreCommit()
+ **
+ ** ============================================================================
+ */
+static int scapi_nmStorePend(NextMacStore_t *pxStore, const char *pcIfname, const char *pcMac)
+{
+	char *pcNew = NULL;
+	int nLen = 0;
+
+	if(pxStore->unPendCap - pxStore->unPendLen < NEXT_MAC_REC_LEN)
+	{
+		if((pcNew = realloc(pxStore->pcPending, pxStore->unPendCap + NEXT_MAC_REC_LEN * 16)) == NULL)
+			return -ENOMEM;
+		pxStore->pcPending = pcNew;
+		pxStore->unPendCap += NEXT_MAC_REC_LEN * 16;
+	}
+	if(pcMac != NULL)
+		nLen = sprintf_s(pxStore->pcPending + pxStore->unPendLen, NEXT_MAC_REC_LEN, "%s> %s\n", pcIfname, pcMac);
+	else
+		nLen = sprintf_s(pxStore->pcPending + pxStore->unPendLen, NEXT_MAC_REC_LEN, "!%s>\n", pcIfname);
+	if(nLen < 0)
+		return ERR_INPUT_VALIDATION_FAILED;
+	pxStore->unPendLen += nLen;
+	return EXIT_SUCCESS;
+}
+
+static bool scapi_nmStoreValidName(const char *pcIfname)
+{
+	size_t unLen = strnlen_s(pcIfname, IFNAMSIZ);
+
+	return unLen > 0 && unLen < IFNAMSIZ && pcIfname[0] != '!' && strpbrk(pcIfname, ">\n ") == NULL;
+}
+
+int scapi_nmStoreSet(NextMacStore_t *pxStore, const char *pcIfname, const char *pcMac)
+{
+	size_t unLen = strnlen_s(pcMac, SCAPI_MAC_LEN);
+	int nRet = -EXIT_FAILURE;
+
+	if(!scapi_nmStoreValidName(pcIfname) || unLen == 0 || unLen >= SCAPI_MAC_LEN || strpbrk(pcMac, "\n ") != NULL)
+		return ERR_INPUT_VALIDATION_FAILED;
+	if((nRet = scapi_nmStorePend(pxStore, pcIfname, pcMac)) != EXIT_SUCCESS)
+		return nRet;
+	return scapi_nmStorePut(pxStore, pcIfname, pcMac);
+}
+
+int scapi_nmStoreRemove(NextMacStore_t *pxStore, const char *pcIfname)
+{
+	int nRet = -EXIT_FAILURE;
+
+	if(scapi_nmStoreLookup(pxStore, pcIfname) == NULL)
+		return EXIT_SUCCESS;
+	if((nRet = scapi_nmStorePend(pxStore, pcIfname, NULL)) != EXIT_SUCCESS)
+		return nRet;
+	return scapi_nmStorePut(pxStore, pcIfname, NULL);
+}
+
+static int scapi_nmWriteAll(int nFd, const char *pcBuf, size_t unLen)
+{
+	ssize_t nWritten = 0;
+
+	while(unLen > 0)
+	{
+		if((nWritten = write(nFd, pcBuf, unLen)) < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return -errno;
+		}
+		pcBuf += nWritten;
+		unLen -= nWritten;
+	}
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nmStoreCompact
+ **
+ **   Description      :Rewrites the conf file with the live records only: temp
+ **			file, fsync, rename, fsync of the directory. The only
+ **			place the store syncs, plain appends are left to the fs
+ **
+ ** ============================================================================
+ */
+static int scapi_nmStoreCompact(NextMacStore_t *pxStore)
+{
+	char sTmp[PATH_MAX] = {0}, sDir[PATH_MAX] = {0};
+	char *pcSlash = NULL, *pcBuf = NULL;
+	size_t unLen = 0;
+	int nFd = -1, nDirFd = -1, i = 0, nLen = 0, nRet = -EXIT_FAILURE;
+
+	if(sprintf_s(sTmp, sizeof(sTmp), "%s.tmp", pxStore->pcConf) < 0 ||
+			strncpy_s(sDir, sizeof(sDir), pxStore->pcConf, sizeof(sDir) - 1) != EOK)
+		goto returnHandler;
+	if((pcBuf = malloc((size_t)pxStore->nCnt * NEXT_MAC_REC_LEN + 1)) == NULL)
+	{
+		nRet = -ENOMEM;
+		goto returnHandler;
+	}
+	for(i = 0; i < pxStore->nCnt; i++)
+	{
+		if((nLen = sprintf_s(pcBuf + unLen, NEXT_MAC_REC_LEN, "%s> %s\n", pxStore->pxRecs[i].sIfname, pxStore->pxRecs[i].sMac)) < 0)
+			goto returnHandler;
+		unLen += nLen;
+	}
+	if((nFd = open(sTmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0 ||
+			scapi_nmWriteAll(nFd, pcBuf, unLen) != EXIT_SUCCESS || fsync(nFd) != 0)
+	{
+		LOGF_LOG_ERROR("Couldn't write %s (%s)\n", sTmp, strerror(errno));
+		unlink(sTmp);
+		goto returnHandler;
+	}
+	close(nFd);
+	nFd = -1;
+	if(rename(sTmp, pxStore->pcConf) != 0)
+	{
+		LOGF_LOG_ERROR("Couldn't rename %s (%s)\n", sTmp, strerror(errno));
+		unlink(sTmp);
+		goto returnHandler;
+	}
+	/* make the rename itself durable */
+	if((pcSlash = strrchr(sDir, '/')) != NULL)
+	{
+		*pcSlash = '\0';
+		if((nDirFd = open(sDir[0] ? sDir : "/", O_RDONLY | O_DIRECTORY | O_CLOEXEC)) >= 0)
+		{
+			fsync(nDirFd);
+			close(nDirFd);
+		}
+	}
+	pxStore->nDead = 0;
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	if(nFd >= 0)
+		close(nFd);
+	free(pcBuf);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_nmStoreCommit
+ **
+ **   Description      :Writes the pending records: one O_APPEND write, or a
+ **			compaction once more than NEXT_MAC_COMPACT_DEAD records
+ **			are dead. A failed append is cut off again
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED
+ **
+ ** ============================================================================
+ */
+int scapi_nmStoreCommit(NextMacStore_t *pxStore)
+{
+	struct stat st;
+	int nFd = -1, nRet = -EXIT_FAILURE;
+
+	if(pxStore->unPendLen == 0)
+		return EXIT_SUCCESS;
+
+	if(pxStore->nDead > NEXT_MAC_COMPACT_DEAD && scapi_nmStoreCompact(pxStore) == EXIT_SUCCESS)
+	{
+		nRet = EXIT_SUCCESS;
+		goto returnHandler;
+	}
+
+	if((nFd = open(pxStore->pcConf, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)) < 0 || fstat(nFd, &st) != 0)
+	{
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		LOGF_LOG_ERROR("Couldn't open %s (%s)\n", pxStore->pcConf, strerror(errno));
+		goto returnHandler;
+	}
+	if(scapi_nmWriteAll(nFd, pxStore->pcPending, pxStore->unPendLen) != EXIT_SUCCESS)
+	{
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		LOGF_LOG_ERROR("Couldn't append to %s (%s)\n", pxStore->pcConf, strerror(errno));
+		if(ftruncate(nFd, st.st_size) != 0)
+			LOGF_LOG_ERROR("Couldn't truncate %s\n", pxStore->pcConf);
+		goto returnHandler;
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	if(nFd >= 0)
+		close(nFd);
+	if(nRet == EXIT_SUCCESS)
+		pxStore->unPendLen = 0;
+	return nRet;
+}
+
+int scapi_nmStoreClear(NextMacStore_t *pxStore)
+{
+	if(unlink(pxStore->pcConf) != 0 && errno != ENOENT)
+	{
+		LOGF_LOG_ERROR("Couldn't remove %s (%s)\n", pxStore->pcConf, strerror(errno));
+		return ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+	}
+	pxStore->nCnt = 0;
+	pxStore->nDead = 0;
+	pxStore->unPendLen = 0;
+	return EXIT_SUCCESS;
+}
+
+void scapi_nmStoreClose(NextMacStore_t *pxStore)
+{
+	if(pxStore->nLockFd >= 0)
+		close(pxStore->nLockFd);
+	free(pxStore->pxRecs);
+	free(pxStore->pcPending);
+	memset(pxStore, 0, sizeof(*pxStore));
+	pxStore->nLockFd = -1;
+}
@@ -0,0 +1,352 @@
+/*****************************************************************************
+
+  Copyright (C) 2026 MaxLinear, Inc.
+
+  For licensing information, see the file 'LICENSE' in the root folder of
+  this software module.
+
+ ******************************************************************************/
+
+/***************************************************************************** *
+ *     File Name  : scapi_procscan.c                                           *
+ *     Project    : UGW                                                        *
+ *     Description: /proc walk with getdents64 and openat/pread of the stat    *
+ *                  files, matching any number of process names in one pass   *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <ulogging.h>
+#include <ltq_api_include.h>
+#include <scapi_procscan.h>
+
+#define PROC_DIRENT_BUF_SIZE 4096
+/* field of /proc/PID/stat holding the start time, see proc(5) */
+#define PROC_STAT_STARTTIME_FIELD 22
+
+struct scapi_dirent64 {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+static pthread_mutex_t xProcFdLock = PTHREAD_MUTEX_INITIALIZER;
+static int nProcFd = -1;
+static pid_t nProcFdOwner = 0;
+static dev_t xProcFdDev;
+static ino_t xProcFdIno;
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_procFdIsOurs
+ **
+ **   Description      :Tells whether nProcFd still is the /proc directory
+ **			opened here. The application may have closed it, e.g.
+ **			closing all descriptors after a fork, and reused the
+ **			number for something else
+ **
+ ** ============================================================================
+ */
+static bool scapi_procFdIsOurs(void)
+{
+	struct stat xSt;
+
+	if(fstat(nProcFd, &xSt) != 0)
+		return false;
+	return S_ISDIR(xSt.st_mode) && xSt.st_dev == xProcFdDev && xSt.st_ino == xProcFdIno;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_procDirFd
+ **
+ **   Description      :Returns the /proc descriptor of this process, opened on
+ **			first use. A child inherits the parent's descriptor, it
+ **			gets its own one on first use after the fork. A
+ **			descriptor that is no longer ours is dropped, never
+ **			closed, and /proc is opened again
+ **
+ **   Return Value     :Success -> descriptor
+ **                      Failure -> -errno
+ **
+ ** ============================================================================
+ */
+int scapi_procDirFd(void)
+{
+	struct stat xSt;
+	pid_t nSelf = getpid();
+	int nRet = -EXIT_FAILURE;
+
+	pthread_mutex_lock(&xProcFdLock);
+	if(nProcFd >= 0 && !scapi_procFdIsOurs())
+	{
+		nProcFd = -1;
+	}
+	else if(nProcFd >= 0 && nProcFdOwner != nSelf)
+	{
+		close(nProcFd);
+		nProcFd = -1;
+	}
+	if(nProcFd < 0)
+	{
+		if((nProcFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+		{
+			nRet = -errno;
+			LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+			goto returnHandler;
+		}
+		if(fstat(nProcFd, &xSt) != 0)
+		{
+			nRet = -errno;
+			LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+			close(nProcFd);
+			nProcFd = -1;
+			goto returnHandler;
+		}
+		xProcFdDev = xSt.st_dev;
+		xProcFdIno = xSt.st_ino;
+		nProcFdOwner = nSelf;
+	}
+	nRet = nProcFd;
+returnHandler:
+	pthread_mutex_unlock(&xProcFdLock);
+	return nRet;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_procReadStatFd
+ **
+ **   Description      :Reads an open /proc/PID/stat and splits out the process
+ **			name (between the first '(' and the last ')', it may hold
+ **			spaces and parentheses) and the start time
+ **
+ **   Parameters       :nFd(IN) -> descriptor of /proc/PID/stat
+ **			pcBuf(IN) -> scratch buffer, SCAPI_PROC_STAT_LEN is enough
+ **			unLen(IN) -> size of pcBuf
+ **			ppcComm(OUT) -> process name, inside pcBuf
+ **			pullStartTime(OUT) -> start time in clock ticks, optional
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> -ENOENT / -EINVAL
+ **
+ **   Notes            :The read fails once the process is reaped, a kept
+ **			descriptor never reports a later process with the same pid
+ **
+ ** ============================================================================
+ */
+int scapi_procReadStatFd(int nFd, char *pcBuf, size_t unLen, char **ppcComm, uint64_t *pullStartTime)
+{
+	char *pcStart = NULL, *pcEnd = NULL, *pcField = NULL;
+	ssize_t nLen = 0;
+	int nField = 0;
+
+	if((nLen = pread(nFd, pcBuf, unLen - 1, 0)) <= 0)
+		return -ENOENT;
+	pcBuf[nLen] = '\0';
+
+	if((pcStart = strchr(pcBuf, '(')) == NULL || (pcEnd = strrchr(pcBuf, ')')) == NULL || pcEnd < pcStart)
+		return -EINVAL;
+	*pcEnd = '\0';
+	*ppcComm = pcStart + 1;
+
+	if(pullStartTime != NULL)
+	{
+		/* ") " is followed by field 3 */
+		*pullStartTime = 0;
+		pcField = pcEnd + 2;
+		for(nField = 3; nField < PROC_STAT_STARTTIME_FIELD && pcField < pcBuf + nLen; nField++)
+		{
+			if((pcField = strchr(pcField, ' ')) == NULL)
+				break;
+			pcField++;
+		}
+		if(pcField != NULL && nField == PROC_STAT_STARTTIME_FIELD && pcField < pcBuf + nLen)
+			*pullStartTime = strtoull(pcField, NULL, 10);
+	}
+	return EXIT_SUCCESS;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_procOpenStat
+ **
+ **   Description      :Opens /proc/PID/stat relative to the /proc descriptor
+ **
+ **   Return Value     :Success -> descriptor
+ **                      Failure -> -ENOENT / -EINVAL
+ **
+ ** ============================================================================
+ */
+int scapi_procOpenStat(int nDirFd, pid_t nPid)
+{
+	char sPath[32] = {0};
+	int nFd = -1;
+
+	if(sprintf_s(sPath, sizeof(sPath), "%d/stat", (int)nPid) <= 0)
+		return -EINVAL;
+	if((nFd = openat(nDirFd, sPath, O_RDONLY | O_CLOEXEC)) < 0)
+		return -ENOENT; // process probably exited
+	return nFd;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_procReadStat
+ **
+ **   Description      :Reads /proc/PID/stat, see scapi_procReadStatFd()
+ **
+ **   Parameters       :nDirFd(IN) -> /proc descriptor
+ **			nPid(IN) -> process id
+ **			pcBuf(IN) -> scratch buffer, SCAPI_PROC_STAT_LEN is enough
+ **			unLen(IN) -> size of pcBuf
+ **			ppcComm(OUT) -> process name, inside pcBuf
+ **			pullStartTime(OUT) -> start time in clock ticks, optional
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> -ENOENT / -EINVAL
+ **
+ ** ============================================================================
+ */
+int scapi_procReadStat(int nDirFd, pid_t nPid, char *pcBuf, size_t unLen, char **ppcComm, uint64_t *pullStartTime)
+{
+	int nFd = -1, nRet = -EXIT_FAILURE;
+
+	if((nFd = scapi_procOpenStat(nDirFd, nPid)) < 0)
+		return nFd;
+	nRet = scapi_procReadStatFd(nFd, pcBuf, unLen, ppcComm, pullStartTime);
+	close(nFd);
+	return nRet;
+}
+
+static pid_t scapi_procDirentPid(const char *pcName)
+{
+	pid_t nPid = 0;
+
+	for(; *pcName != '\0'; pcName++)
+	{
+		if(*pcName < '0' || *pcName > '9')
+			return 0;
+		nPid = nPid * 10 + (*pcName - '0');
+	}
+	return nPid;
+}
+
+/*
+ ** =============================================================================
+ **   Function Name    :scapi_procScan
+ **
+ **   Description      :Walks /proc once, matching every process against all
+ **			the names: a process is reported once, for the first
+ **			name it matches
+ **
+ **   Parameters       :ppcNames(IN) -> process names
+ **			nNames(IN) -> number of names
+ **			pfnCb(IN) -> called for every match
+ **			pvArg(IN) -> passed to pfnCb
+ **
+ **   Return Value     :Success -> EXIT_SUCCESS
+ **                      Failure -> -ve value of pfnCb or -errno
+ **
+ **   Notes            :Everything lives on the stack, the callback may use
+ **			scapi_procDirFd() and scapi_procReadStat()
+ **
+ ** ============================================================================
+ */
+int scapi_procScan(const char * const *ppcNames, int nNames, pfnScapiProcCb pfnCb, void *pvArg)
+{
+	char acDents[PROC_DIRENT_BUF_SIZE] __attribute__((aligned(8)));
+	char sStat[SCAPI_PROC_STAT_LEN];
+	struct scapi_dirent64 *pxEnt = NULL;
+	char *pcComm = NULL;
+	uint64_t ullStart = 0;
+	pid_t nPid = 0;
+	long nLen = 0, nOff = 0;
+	int nProc = -1, nDir = -1, i = 0, nRet = -EXIT_FAILURE;
+
+	if(ppcNames == NULL || nNames <= 0 || pfnCb == NULL)
+	{
+		nRet = -EINVAL;
+		goto returnHandler;
+	}
+	if((nProc = scapi_procDirFd()) < 0)
+	{
+		nRet = nProc;
+		goto returnHandler;
+	}
+	/* Own open file, the directory offset is not shared with other scans */
+	if((nDir = openat(nProc, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0)
+	{
+		nRet = -errno;
+		goto returnHandler;
+	}
+
+	while((nLen = syscall(SYS_getdents64, nDir, acDents, sizeof(acDents))) > 0)
+	{
+		for(nOff = 0; nOff < nLen; nOff += pxEnt->d_reclen)
+		{
+			pxEnt = (struct scapi_dirent64 *)(acDents + nOff);
+			//continue if not a pid
+			if((pxEnt->d_type != DT_DIR && pxEnt->d_type != DT_UNKNOWN) ||
+					(nPid = scapi_procDirentPid(pxEnt->d_name)) == 0)
+				continue;
+			if(scapi_procReadStat(nProc, nPid, sStat, sizeof(sStat), &pcComm, &ullStart) != EXIT_SUCCESS)
+				continue;
+			for(i = 0; i < nNames; i++)
+			{
+				if(ppcNames[i] != NULL && strncasecmp(ppcNames[i], pcComm, SCAPI_PROC_COMM_LEN) == 0)
+					break;
+			}
+			if(i < nNames && (nRet = pfnCb(nPid, i, ullStart, pvArg)) < 0)
+				goto returnHandler;
+		}
+	}
+	if(nLen < 0)
+	{
+		nRet = -errno;
+		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+		goto returnHandler;
+	}
+	nRet = EXIT_SUCCESS;
+returnHandler:
+	if(nDir >= 0)
+		close(nDir);
+	return nRet;
+}
+
+int scapi_pidVecPush(ScapiPidVec_t *pxVec, pid_t nPid)
+{
+	pid_t *pnNew = NULL;
+
+	if(pxVec->nCnt == pxVec->nCap)
+	{
+		pnNew = realloc(pxVec->pnPids, (pxVec->nCap ? pxVec->nCap * 2 : 16) * sizeof(pid_t));
+		if(pnNew == NULL)
+			return -ENOMEM;
+		pxVec->pnPids = pnNew;
+		pxVec->nCap = pxVec->nCap ? pxVec->nCap * 2 : 16;
+	}
+	pxVec->pnPids[pxVec->nCnt++] = nPid;
+	return EXIT_SUCCESS;
+}
+
+void scapi_pidVecFree(ScapiPidVec_t *pxVec)
+{
+	free(pxVec->pnPids);
+	pxVec->pnPids = NULL;
+	pxVec->nCnt = pxVec->nCap = 0;
+}
@@ -37,10 +37,8 @@
 
 #include <libsafec/safe_str_lib.h>
 
-#define NEXT_MAC_CONF VENDOR_PATH      "/servd/etc/nextmac.conf"
-#define TEMP_NEXT_MAC_CONF VENDOR_PATH "/servd/etc/temp_nextmac.conf"
+#include <scapi_nextmac_store.h>
 
-#define MAX_LEN_PARAM_VALUE            64
 /* 
  ** =============================================================================
  **   Function Name    :scapi_removeNextMacaddr
@@ -48,51 +46,44 @@
  **   Description      :Removes next mac address entry from config file
  **
  **   Parameters       :pcIfname(IN) -> interface name
- **                      pcMac(IN) -> mac address to be removed
  **
  **   Return Value     :Success -> EXIT_SUCCESS
  **                      Failure -> Different -ve values 
  **
+ **   Notes            :Appends a removal record, the file is only rewritten
+ **			once enough records are dead
+ **
  ** ============================================================================
  */
 
 int scapi_removeNextMacaddr(char* pcIfname)
 {
-	FILE* inFile = scapi_getFilePtr(NEXT_MAC_CONF, "r");
-	FILE* outFile = scapi_getFilePtr(TEMP_NEXT_MAC_CONF, "a+");
-	char line [MAX_LEN_PARAM_VALUE]; // maybe you have to user better value here
-	int lineCount = 0;
+	NextMacStore_t xStore = {.nLockFd = -1};
 	int nRet = -EXIT_FAILURE;
 
-	if( inFile == NULL || outFile == NULL)
+	if(pcIfname == NULL || pcIfname[0] == '\0')
 	{
 		nRet = ERR_INPUT_VALIDATION_FAILED;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+		LOGF_LOG_ERROR("ERROR = %d --> invalid interface name\n", nRet);
 		goto returnHandler;
 	}
-
-	while( fgets(line, sizeof(line), inFile) != NULL )
+	if((nRet = scapi_nmStoreOpen(&xStore, NEXT_MAC_CONF, NEXT_MAC_LOCK, true)) != EXIT_SUCCESS)
 	{
-		char* pcFind = strstr(line, pcIfname);
-		/* Add only the lines that doesn't containt interface
-		 * name to new file */
-		if( pcFind == NULL){
-			fprintf(outFile, "%s", line);
-		}
-		lineCount++;
+		LOGF_LOG_ERROR("ERROR = %d --> couldn't open %s\n", nRet, NEXT_MAC_CONF);
+		goto returnHandler;
 	}
-	nRet = EXIT_SUCCESS;
-
-returnHandler:
-	if(inFile != NULL)
-		fclose(inFile);
-	if(outFile != NULL)
-		fclose(outFile);
-	if(rename(TEMP_NEXT_MAC_CONF, NEXT_MAC_CONF) != 0){
+	if((nRet = scapi_nmStoreRemove(&xStore, pcIfname)) != EXIT_SUCCESS)
+		goto returnHandler;
+	if((nRet = scapi_nmStoreCommit(&xStore)) != EXIT_SUCCESS)
+	{
 		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
-		fprintf(stderr, "%s:%d renaming file is failed after remove of mac\n", __func__,__LINE__);
+		fprintf(stderr, "%s:%d updating file is failed after remove of mac\n", __func__,__LINE__);
+		goto returnHandler;
 	}
+	nRet = EXIT_SUCCESS;
 
+returnHandler:
+	scapi_nmStoreClose(&xStore);
 	return nRet;	 
 }
 
@@ -109,94 +100,62 @@ returnHandler:
  **   Return Value     :Success -> EXIT_SUCCESS
  **                      Failure -> Different -ve values
  **
+ **   Notes            :Both records are appended with one write
+ **
  ** ============================================================================
  */
 
 int scapi_swapNextMacaddr(char* pcIfname_newDefWAN, char* pcIfname_oldDefWAN)
 {
-	FILE* inFile = scapi_getFilePtr(NEXT_MAC_CONF, "r");
-	FILE* outFile = scapi_getFilePtr(TEMP_NEXT_MAC_CONF, "w");
-	char line [MAX_LEN_PARAM_VALUE];
-	char MAC_newDefWAN [MAX_LEN_PARAM_VALUE];
-	char MAC_oldDefWAN [MAX_LEN_PARAM_VALUE];
-	char ChangedMAC_newDefWAN [MAX_LEN_PARAM_VALUE];
-	char ChangedMAC_oldDefWAN [MAX_LEN_PARAM_VALUE];
-	int lineCount = 0;
+	NextMacStore_t xStore = {.nLockFd = -1};
+	const NextMacRec_t *pxRec = NULL;
+	char MAC_newDefWAN [SCAPI_MAC_LEN] = {0};
+	char MAC_oldDefWAN [SCAPI_MAC_LEN] = {0};
 	int nRet = -EXIT_FAILURE;
-	size_t len=0;
 
-	if( inFile == NULL || outFile == NULL)
+	if(pcIfname_newDefWAN == NULL || pcIfname_oldDefWAN == NULL)
 	{
 		nRet = ERR_INPUT_VALIDATION_FAILED;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
+		LOGF_LOG_ERROR("ERROR = %d --> invalid interface name\n", nRet);
 		goto returnHandler;
 	}
-
-	while( fgets(line, sizeof(line), inFile) != NULL )
+	if((nRet = scapi_nmStoreOpen(&xStore, NEXT_MAC_CONF, NEXT_MAC_LOCK, true)) != EXIT_SUCCESS)
 	{
-		char* pcFind_newDefWAN = NULL;
-		char* pcFind_oldDefWAN = NULL;
-		char* pcFind_EthMacVlanIf = strstr(line, "eth1_wan");
-		char* pcFind_PtmMacVlanIf = strstr(line, "ptm0_wan");
-
-		if(pcFind_EthMacVlanIf == NULL && pcFind_PtmMacVlanIf == NULL) {
-			pcFind_newDefWAN = strstr(line, pcIfname_newDefWAN);
-			pcFind_oldDefWAN = strstr(line, pcIfname_oldDefWAN);
-		}
-
-		// Add only the lines that doesn't contain interface name to new file
-		if(pcFind_newDefWAN == NULL && pcFind_oldDefWAN == NULL){
-			fprintf(outFile, "%s", line);
-		}
-		// Get MAC address of both WAN interfaces that needs to be swapped
-		else if( pcFind_newDefWAN != NULL) {
-			if((len=strnlen_s(line, MAX_LEN_PARAM_VALUE)) <=0){
-				nRet = UGW_FAILURE;
-				LOGF_LOG_ERROR("Length of line containing %s is invalid.......\n", pcFind_newDefWAN);
-				goto returnHandler;
-			}
-			char *token;
-			char *next_token = NULL;
-
-			token = strtok_s(line, &len, "> ", &next_token);
-			token = strtok_s(NULL, &len, "\n", &next_token);
-			sprintf_s(MAC_newDefWAN, MAX_LEN_PARAM_VALUE, "%s", token);
-		}
-		else if( pcFind_oldDefWAN != NULL) {
-			if((len=strnlen_s(line, MAX_LEN_PARAM_VALUE)) <=0){
-				nRet = UGW_FAILURE;
-				LOGF_LOG_ERROR("Length of line containing %s is invalid.......\n", pcFind_oldDefWAN);
-				goto returnHandler;
-			}
-			char *token;
-			char *next_token = NULL;
-
-			token = strtok_s(line, &len, "> ", &next_token);
-			token = strtok_s(NULL, &len, "\n", &next_token);
-			sprintf_s(MAC_oldDefWAN, MAX_LEN_PARAM_VALUE, "%s", token);
-		}
-		lineCount++;
+		LOGF_LOG_ERROR("ERROR = %d --> couldn't open %s\n", nRet, NEXT_MAC_CONF);
+		goto returnHandler;
 	}
-	nRet = EXIT_SUCCESS;
 
-	// Swap the MAC addresses and add the lines to TEMP_NEXT_MAC_CONFIG file
-	sprintf_s(ChangedMAC_newDefWAN, sizeof(ChangedMAC_newDefWAN), "%s>%s\n", pcIfname_newDefWAN, MAC_oldDefWAN);
-	sprintf_s(ChangedMAC_oldDefWAN, sizeof(ChangedMAC_oldDefWAN), "%s>%s\n", pcIfname_oldDefWAN, MAC_newDefWAN);
-	fprintf(outFile, "%s", ChangedMAC_newDefWAN);
-	fprintf(outFile, "%s", ChangedMAC_oldDefWAN);
-	LOGF_LOG_DEBUG("Swapped MAC Addresses : %s .... %s \n",ChangedMAC_newDefWAN,ChangedMAC_oldDefWAN);
+	// Get MAC address of both WAN interfaces that needs to be swapped
+	if((pxRec = scapi_nmStoreFind(&xStore, pcIfname_newDefWAN)) == NULL)
+	{
+		nRet = ERR_INPUT_VALIDATION_FAILED;
+		LOGF_LOG_ERROR("No mac assigned to %s\n", pcIfname_newDefWAN);
+		goto returnHandler;
+	}
+	strncpy_s(MAC_newDefWAN, sizeof(MAC_newDefWAN), pxRec->sMac, sizeof(MAC_newDefWAN) - 1);
+	if((pxRec = scapi_nmStoreFind(&xStore, pcIfname_oldDefWAN)) == NULL)
+	{
+		nRet = ERR_INPUT_VALIDATION_FAILED;
+		LOGF_LOG_ERROR("No mac assigned to %s\n", pcIfname_oldDefWAN);
+		goto returnHandler;
+	}
+	strncpy_s(MAC_oldDefWAN, sizeof(MAC_oldDefWAN), pxRec->sMac, sizeof(MAC_oldDefWAN) - 1);
 
-returnHandler:
-	if(inFile != NULL)
-		fclose(inFile);
-	if(outFile != NULL)
-		fclose(outFile);
-	if(nRet == EXIT_SUCCESS) {
-		if(rename(TEMP_NEXT_MAC_CONF, NEXT_MAC_CONF) != 0){
-			nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
-			fprintf(stderr, "%s:%d renaming file is failed after swapping of mac\n", __func__,__LINE__);
-		}
+	// Swap the MAC addresses
+	if((nRet = scapi_nmStoreSet(&xStore, pcIfname_newDefWAN, MAC_oldDefWAN)) != EXIT_SUCCESS ||
+			(nRet = scapi_nmStoreSet(&xStore, pcIfname_oldDefWAN, MAC_newDefWAN)) != EXIT_SUCCESS)
+		goto returnHandler;
+	if((nRet = scapi_nmStoreCommit(&xStore)) != EXIT_SUCCESS)
+	{
+		nRet = ERR_MACADDRESS_DEFAULT_FILE_OPER_FAILED;
+		fprintf(stderr, "%s:%d updating file is failed after swapping of mac\n", __func__,__LINE__);
+		goto returnHandler;
 	}
+	LOGF_LOG_DEBUG("Swapped MAC Addresses : %s>%s .... %s>%s \n", pcIfname_newDefWAN, MAC_oldDefWAN,
+			pcIfname_oldDefWAN, MAC_newDefWAN);
+	nRet = EXIT_SUCCESS;
 
+returnHandler:
+	scapi_nmStoreClose(&xStore);
 	return nRet;
 }
@@ -54,18 +54,8 @@ int scapi_routeAdd(char *pcDest, char *pcGateway, char *pcGenmask, char *pcDev,
 	struct rtentry xRoute = {0};
 	struct sockaddr_in *pxAddr = NULL;
 
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	if(pcDest == NULL || pcGateway == NULL || pcGenmask == NULL)
 	{
 		nRet = -EINVAL;
@@ -98,16 +88,13 @@ int scapi_routeAdd(char *pcDest, char *pcGateway, char *pcGenmask, char *pcDev,
 	if(pcDev != NULL)
 		xRoute.rt_dev = pcDev;
 
-	if(ioctl(nSkfd, SIOCADDRT, &xRoute) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCADDRT, &xRoute)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	if(nSkfd != -1)
-		close(nSkfd);
 	return nRet;
 }
 
@@ -135,18 +122,8 @@ int scapi_routeDel(char* pcDest, char* pcGateway, char* pcGenmask, char* pcDev)
 	struct rtentry xRoute = {0};
 	struct sockaddr_in *pxAddr = NULL;
 
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	if(pcDest == NULL || pcGateway == NULL || pcGenmask == NULL)
 	{
 		nRet = -EINVAL;
@@ -176,16 +153,13 @@ int scapi_routeDel(char* pcDest, char* pcGateway, char* pcGenmask, char* pcDev)
 
 	if(pcDev != NULL)
 		xRoute.rt_dev = pcDev;
-	if(ioctl(nSkfd, SIOCDELRT, &xRoute) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCDELRT, &xRoute)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
 
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	if(nSkfd != -1)
-		close(nSkfd);
 	return nRet;
 }
@@ -16,13 +16,17 @@
  *  *****************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/un.h>
 #include <unistd.h>
 #include <sys/ipc.h>
 #include <stdint.h>
 #include <sys/socket.h>
 #include <scapi_ipc.h>
+#include <scapi_ipc_blob.h>
 #include <errno.h>
 #include <ltq_api_include.h>
 #include "ugw_error.h" 
@@ -30,6 +34,237 @@
 
 #define IPC_FILE_PATH "/tmp/MsgTo"
 
+/* Transport the last listener connected to had, tried first by the next
+   connection */
+static int32_t iipctransport = IPC_TRANSPORT_STREAM;
+
+/* Request of an ipc_async client waiting for its reply */
+typedef struct x_ipc_async_req
+{
+	struct x_ipc_async_req *pxnext;
+	uint32_t uiid;
+	pfn_ipc_completion pfncb;
+	void *pvarg;
+} x_ipc_async_req;
+
+typedef struct
+{
+	int32_t ifd;
+	int32_t itransport;
+	uint32_t uinextid;
+	char acto[MAX_MODID_LEN];
+	/* Requests in the order sent, replies come back in that order */
+	x_ipc_async_req *pxhead;
+	x_ipc_async_req *pxtail;
+	int32_t inpending;
+	/* Requests the socket did not take yet */
+	char *pctx;
+	size_t itxlen;
+	size_t itxsize;
+	/* Received bytes of the replies not complete yet */
+	char acrx[2 * sizeof(x_ipc_msg_t)];
+	size_t irxlen;
+	x_ipc_msg_t xreply;
+	/* Completions may be running, a close then waits for them */
+	int32_t ibusy;
+	int32_t iclosed;
+	/* Bumped when the connection is dropped */
+	uint32_t uigen;
+} x_ipc_async;
+
+/*
+** =============================================================================
+**   Function Name    : ipc_write_full
+**   Description      : Writes ilen bytes, resuming short writes. No SIGPIPE
+**                      when the peer has closed, errno is EPIPE instead
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL, errno set
+** ===========================================================================*/
+
+static int32_t
+ipc_write_full(int32_t ifd, const void *pvbuf, size_t ilen)
+{
+	const char *pcbuf = pvbuf;
+	ssize_t nbytes;
+
+	while (ilen > 0) {
+		nbytes = send(ifd, pcbuf, ilen, MSG_NOSIGNAL);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return IPC_FAIL;
+		}
+		pcbuf += nbytes;
+		ilen -= nbytes;
+	}
+	return IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_read_full
+**   Description      : Reads ilen bytes, resuming short reads
+**   Return Value     : Success -> bytes read, less than ilen at end of stream
+**                      Failure -> -1, errno set
+** ===========================================================================*/
+
+static ssize_t
+ipc_read_full(int32_t ifd, void *pvbuf, size_t ilen)
+{
+	char *pcbuf = pvbuf;
+	size_t idone = 0;
+	ssize_t nbytes;
+
+	while (idone < ilen) {
+		nbytes = read(ifd, pcbuf + idone, ilen - idone);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (nbytes == 0)
+			break;
+		idone += nbytes;
+	}
+	return idone;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_write_msg
+**   Description      : Writes one message, ipassfd (-1 if none) passed with
+**                      its first byte
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL, errno set
+** ===========================================================================*/
+
+static int32_t
+ipc_write_msg(int32_t ifd, const x_ipc_msg_t *pxmsg, int32_t ipassfd)
+{
+	size_t ilen = IPC_HDR_SIZE + pxmsg->xhdr.unmsgsize;
+	ssize_t nbytes;
+
+	if (ipassfd < 0)
+		return ipc_write_full(ifd, pxmsg, ilen);
+	do {
+		nbytes = ipc_send_fd(ifd, pxmsg, ilen, ipassfd, 0);
+	} while (nbytes < 0 && errno == EINTR);
+	if (nbytes < 0)
+		return IPC_FAIL;
+	return ipc_write_full(ifd, (const char *)pxmsg + nbytes, ilen - nbytes);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_read_msg
+**   Description      : Reads one message, one record on a SOCK_SEQPACKET
+**                      socket, header then payload on a stream. A descriptor
+**                      passed with it goes to *pipassfd, or is closed if
+**                      pipassfd is NULL
+**   Return Value     : Success -> 1
+**                      End of stream before the message -> 0
+**                      Failure -> -1, errno set (EPROTO for a cut or
+**                                 oversized message)
+** ===========================================================================*/
+
+static int32_t
+ipc_read_msg(int32_t ifd, int32_t itransport, x_ipc_msg_t *pxmsg, int32_t *pipassfd)
+{
+	ssize_t nbytes, nfirst;
+	int32_t ipassfd;
+
+	if (pipassfd != NULL)
+		*pipassfd = -1;
+	do {
+		nfirst = ipc_recv_fd(ifd, pxmsg, (itransport == IPC_TRANSPORT_SEQPACKET) ?
+				sizeof(x_ipc_msg_t) : IPC_HDR_SIZE, &ipassfd);
+	} while (nfirst < 0 && errno == EINTR);
+	if (nfirst <= 0)
+		return nfirst;
+
+	if (itransport == IPC_TRANSPORT_SEQPACKET) {
+		if (nfirst < (ssize_t)IPC_HDR_SIZE ||
+				(size_t)nfirst != IPC_HDR_SIZE + pxmsg->xhdr.unmsgsize) {
+			errno = EPROTO;
+			goto returnHandler;
+		}
+		goto returnSuccess;
+	}
+
+	nbytes = ipc_read_full(ifd, (char *)&pxmsg->xhdr + nfirst, IPC_HDR_SIZE - nfirst);
+	if (nbytes < 0)
+		goto returnHandler;
+	if (nfirst + nbytes != IPC_HDR_SIZE || pxmsg->xhdr.unmsgsize > IPC_MAX_MSG_SIZE) {
+		errno = EPROTO;
+		goto returnHandler;
+	}
+	nbytes = ipc_read_full(ifd, pxmsg->acmsg, pxmsg->xhdr.unmsgsize);
+	if (nbytes < 0)
+		goto returnHandler;
+	if (nbytes != pxmsg->xhdr.unmsgsize) {
+		errno = EPROTO;
+		goto returnHandler;
+	}
+returnSuccess:
+	if (pipassfd != NULL)
+		*pipassfd = ipassfd;
+	else if (ipassfd >= 0)
+		close(ipassfd);
+	return 1;
+
+returnHandler:
+	if (ipassfd >= 0)
+		close(ipassfd);
+	return -1;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_connect
+**   Description      : Connects to the listener pucto, with the transport
+**                      the last listener had first and the other one if the
+**                      listener's socket is of the other type (EPROTOTYPE)
+**   Return Value     : Success -> connected socket, transport in
+**                                 *pitransport
+**                      Failure -> -1
+** ===========================================================================*/
+
+static int32_t
+ipc_connect(const char *pucto, int32_t *pitransport)
+{
+	struct sockaddr_un xaddr;
+	int32_t ifd, itransport, itry;
+
+	memset(&xaddr, 0, sizeof(xaddr));
+	xaddr.sun_family = AF_UNIX;
+	if (sprintf_s(xaddr.sun_path, sizeof(xaddr.sun_path), IPC_FILE_PATH"%s", pucto) <= 0) {
+		LOGF_LOG_DEBUG("sprintf_s failed\n");
+		return -1;
+	}
+	/* Only a hint shared by all threads, the retry below corrects it */
+	itransport = __atomic_load_n(&iipctransport, __ATOMIC_RELAXED);
+	for (itry = 0; itry < 2; itry++) {
+		ifd = socket(AF_UNIX, (itransport == IPC_TRANSPORT_SEQPACKET) ?
+				SOCK_SEQPACKET : SOCK_STREAM, 0);
+		if (ifd < 0) {
+			LOGF_LOG_DEBUG("IPC create failed\n");
+			return -1;
+		}
+		if (connect(ifd, (struct sockaddr*)&xaddr, sizeof(xaddr)) == 0) {
+			__atomic_store_n(&iipctransport, itransport, __ATOMIC_RELAXED);
+			*pitransport = itransport;
+			return ifd;
+		}
+		close(ifd);
+		if (errno != EPROTOTYPE)
+			break;
+		itransport = (itransport == IPC_TRANSPORT_SEQPACKET) ?
+			IPC_TRANSPORT_STREAM : IPC_TRANSPORT_SEQPACKET;
+	}
+	LOGF_LOG_DEBUG("IPC listener %s missing\n", pucto);
+	return -1;
+}
+
 
 /* 
 ** =============================================================================
@@ -41,6 +276,20 @@
 
 void*
 ipc_create_listener(char *pucto)
+{
+	return ipc_create_listener_ex(pucto, IPC_TRANSPORT_STREAM);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_create_listener_ex
+**   Description      : API to create a socket of transport itransport
+**   Return Value     : Success -> Socket Id in structure pxhandle
+**                      Failure -> NULL
+** ===========================================================================*/
+
+void*
+ipc_create_listener_ex(char *pucto, int32_t itransport)
 {
 	int32_t iret;
 	char acbuf[MAX_NAME_LEN];
@@ -63,7 +312,9 @@ ipc_create_listener(char *pucto)
 		return NULL;
 	}
 	/* Create a unix domain socket */
-	pxhandle->ifd = socket(AF_UNIX, SOCK_STREAM, 0);
+	pxhandle->itransport = itransport;
+	pxhandle->ifd = socket(AF_UNIX, (itransport == IPC_TRANSPORT_SEQPACKET) ?
+			SOCK_SEQPACKET : SOCK_STREAM, 0);
 	if(pxhandle->ifd<0){
 		LOGF_LOG_DEBUG("ipc creation failed - sock\n");
 		free(pxhandle);
@@ -111,86 +362,29 @@ ipc_create_listener(char *pucto)
 int32_t
 ipc_send_request(x_ipc_msg_t *pxmsg)
 {
-	int16_t nbytes = 0;
-	int32_t ifd,iret;
-	char acbuf[MAX_NAME_LEN];
-	struct sockaddr_un xaddr;
+	int32_t ifd,iret,itransport;
 
-	iret=sprintf_s(acbuf,MAX_NAME_LEN, IPC_FILE_PATH"%s",pxmsg->xhdr.aucto);
-	if(iret <= 0){
-		LOGF_LOG_DEBUG("sprintf_s failed\n");
+	if (pxmsg->xhdr.unmsgsize > IPC_MAX_MSG_SIZE)
 		return IPC_FAIL;
-	}
-	/* Create a socket */
-	if((ifd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0){
-		LOGF_LOG_DEBUG("IPC create failed\n");
-		return IPC_FAIL;
-	}
-	/* Construct name to connect the socket to */
-	memset(&xaddr, 0, sizeof(xaddr));
-	xaddr.sun_family = AF_UNIX;
-	iret = sprintf_s(xaddr.sun_path, sizeof(xaddr.sun_path), "%s", acbuf);
-	if(iret <= 0){
-		LOGF_LOG_DEBUG("sprintf_s failed\n");
-		if(ifd >= 0)
-			close(ifd);
-		return IPC_FAIL;
-	}
 	/* connect the socket */
-	if(connect(ifd, (struct sockaddr*)&xaddr, sizeof(xaddr)) == -1) {
-		LOGF_LOG_DEBUG("IPC listener missing\n");
-		if(ifd >= 0)
-			close(ifd);
+	if ((ifd = ipc_connect((char *)pxmsg->xhdr.aucto, &itransport)) < 0)
 		return UGW_FAILURE;
-	}
 	/* Write the message */
-	if (write(ifd, (char *)pxmsg, pxmsg->xhdr.unmsgsize + IPC_HDR_SIZE) < 0)
+	if (ipc_write_full(ifd, pxmsg, pxmsg->xhdr.unmsgsize + IPC_HDR_SIZE) != IPC_SUCCESS)
 	{
 		/* Error Writing Message to the FIFO */
-		/* Add Debugs if required */
-		if(ifd >= 0)
-			close(ifd);
+		close(ifd);
 		return IPC_FAIL;
 	}
 	/* block for reply */
-	LOGF_LOG_DEBUG("Blocked to read the header\n");
-	if((nbytes = read(ifd, (char *) &pxmsg->xhdr,
-				sizeof(x_ipc_msghdr_t))) < 0)
+	LOGF_LOG_DEBUG("Blocked to read the reply\n");
+	iret = ipc_read_msg(ifd, itransport, pxmsg, NULL);
+	close(ifd);
+	if (iret <= 0)
 	{
-		/* Error Reading Header */
 		LOGF_LOG_DEBUG("Error reading response\n");
-		if(ifd >= 0)
-			close(ifd);
-		return IPC_FAIL;
-	}
-	if (nbytes != sizeof(x_ipc_msghdr_t))
-	{
-		if(ifd >= 0)
-			close(ifd);
-		return IPC_FAIL;
-	}
-	else
-	{
-		iret = pxmsg->xhdr.unmsgsize;
-		if(iret > (int32_t)IPC_MAX_MSG_SIZE)
-		{
-			if(ifd >= 0)
-				close(ifd);
-			return IPC_FAIL;
-		}
-	}
-	LOGF_LOG_DEBUG("Blocked to read the msg\n");
-	if ((nbytes = read(ifd, pxmsg->acmsg, iret)) < 0)
-	{
-		/* Error Reading Header */
-		/* Add Debugs if required */
-		if(ifd >= 0)
-			close(ifd);
 		return IPC_FAIL;
 	}
-
-	if(ifd >= 0)
-		close(ifd);
 	return IPC_SUCCESS;
 }
 
@@ -207,37 +401,67 @@ int32_t
 ipc_recv(void *pvhandle,
 				 x_ipc_msg_t *pxmsg)
 {
-	int16_t nbytes = 0;
 	x_ipc_handle *pxhandle=pvhandle;
+	struct pollfd axpfd[IPC_MAX_CHANNELS + 1];
+	int32_t i;
 
 	if(pvhandle==NULL){
 		LOGF_LOG_DEBUG("Create a Event listener first\n");
 		return UGW_FAILURE;
 	}
 
+	pxhandle->uichannelreq = 0;
+	/* Wait for a request on a kept channel connection or a new client */
+	while (pxhandle->inchannels > 0) {
+		axpfd[0].fd = pxhandle->ifd;
+		axpfd[0].events = POLLIN;
+		for (i = 0; i < pxhandle->inchannels; i++) {
+			axpfd[i + 1].fd = pxhandle->aichannelfd[i];
+			axpfd[i + 1].events = POLLIN;
+		}
+		if (poll(axpfd, pxhandle->inchannels + 1, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			return UGW_FAILURE;
+		}
+		for (i = 0; i < pxhandle->inchannels; i++) {
+			if (axpfd[i + 1].revents != 0)
+				break;
+		}
+		if (i == pxhandle->inchannels)
+			break;
+		/* Off the kept list until the reply puts it back at the end, so
+		   the channels are served in turn */
+		pxhandle->iconnfd = pxhandle->aichannelfd[i];
+		pxhandle->inchannels--;
+		memmove(&pxhandle->aichannelfd[i], &pxhandle->aichannelfd[i + 1],
+				(pxhandle->inchannels - i) * sizeof(pxhandle->aichannelfd[0]));
+		if (ipc_read_msg(pxhandle->iconnfd, pxhandle->itransport, pxmsg, NULL) > 0 &&
+				pxmsg->xhdr.unmsgsize >= 1) {
+			pxhandle->uichannelreq = pxmsg->xhdr.uireserved | IPC_CHANNEL_FLAG;
+			return UGW_SUCCESS;
+		}
+		/* Client closed the channel */
+		close(pxhandle->iconnfd);
+		pxhandle->iconnfd = -1;
+	}
+
 	if ( ( pxhandle->iconnfd = accept(pxhandle->ifd, NULL, NULL)) == -1) {
 		perror("accept error");
 		return UGW_FAILURE;
 	}
 
-	if ((nbytes = read(pxhandle->iconnfd, (char *) &pxmsg->xhdr,
-			sizeof(x_ipc_msghdr_t))) < 0)
-	{
-		/* Error Reading Header */
-		/* Add Debugs if required */
-		return IPC_FAIL;
-	}
-	if (nbytes != sizeof(x_ipc_msghdr_t) || pxmsg->xhdr.unmsgsize > IPC_MAX_MSG_SIZE || pxmsg->xhdr.unmsgsize < 1)
-	{
-		return IPC_FAIL;
-	}
 	LOGF_LOG_DEBUG("Reading the message\n");
-	if ((nbytes = read(pxhandle->iconnfd, pxmsg->acmsg, pxmsg->xhdr.unmsgsize)) < 0)
+	if (ipc_read_msg(pxhandle->iconnfd, pxhandle->itransport, pxmsg, NULL) <= 0 ||
+			pxmsg->xhdr.unmsgsize < 1)
 	{
-		/* Error Reading Header */
-		/* Add Debugs if required */
+		/* Error Reading the message */
+		close(pxhandle->iconnfd);
+		pxhandle->iconnfd = -1;
 		return IPC_FAIL;
 	}
+	if (pxmsg->xhdr.uireserved & IPC_CHANNEL_FLAG)
+		pxhandle->uichannelreq = pxmsg->xhdr.uireserved;
 	return UGW_SUCCESS;
 }
 
@@ -259,13 +483,574 @@ ipc_send_reply(void *pvhandle,
 		LOGF_LOG_DEBUG("Create a Event listener first\n");
 		return UGW_FAILURE;
 	}
-	if (write(pxhandle->iconnfd, (char *)pxmsg, pxmsg->xhdr.unmsgsize + IPC_HDR_SIZE) < 0)
+	if (pxhandle->uichannelreq != 0) {
+		/* Echo the request id, with IPC_CHANNEL_FLAG only if the
+		   connection stays open for the next request */
+		pxmsg->xhdr.uireserved = pxhandle->uichannelreq & ~IPC_BLOB_FLAG;
+		if (pxhandle->inchannels >= IPC_MAX_CHANNELS)
+			pxmsg->xhdr.uireserved &= ~IPC_CHANNEL_FLAG;
+		pxhandle->uichannelreq = 0;
+		if (ipc_write_full(pxhandle->iconnfd, pxmsg, pxmsg->xhdr.unmsgsize + IPC_HDR_SIZE) != IPC_SUCCESS) {
+			LOGF_LOG_DEBUG("write failed %d\n",pxhandle->iconnfd);
+			close(pxhandle->iconnfd);
+			return IPC_FAIL;
+		}
+		if (pxmsg->xhdr.uireserved & IPC_CHANNEL_FLAG)
+			pxhandle->aichannelfd[pxhandle->inchannels++] = pxhandle->iconnfd;
+		else
+			close(pxhandle->iconnfd);
+		return IPC_SUCCESS;
+	}
+	if (ipc_write_full(pxhandle->iconnfd, pxmsg, pxmsg->xhdr.unmsgsize + IPC_HDR_SIZE) != IPC_SUCCESS)
 	{
 		/* Error Writing Message to the FIFO */
-		/* Add Debugs if required */
 		LOGF_LOG_DEBUG("write failed %d\n",pxhandle->iconnfd);
+		close(pxhandle->iconnfd);
 		return IPC_FAIL;
 	}
 	close(pxhandle->iconnfd);
 	return IPC_SUCCESS;
 }
+
+/*
+** =============================================================================
+**   Function Name    : ipc_channel_open
+**   Description      : API to create a channel to a listener, connected on
+**                      the first request and then kept for the next ones
+**   Return Value     : Success -> channel
+**                      Failure -> NULL
+** ===========================================================================*/
+
+void*
+ipc_channel_open(char *pucto)
+{
+	x_ipc_channel *pxchannel;
+
+	pxchannel = calloc(1, sizeof(x_ipc_channel));
+	if (pxchannel == NULL) {
+		LOGF_LOG_DEBUG("memory allocation failed for channel\n");
+		return NULL;
+	}
+	if (strncpy_s(pxchannel->acto, MAX_MODID_LEN, pucto, MAX_MODID_LEN - 1) != EOK) {
+		LOGF_LOG_DEBUG("listener name too long\n");
+		free(pxchannel);
+		return NULL;
+	}
+	pxchannel->ifd = -1;
+	pxchannel->uinextid = 1;
+	return pxchannel;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_channel_request
+**   Description      : API to send a request on a channel and read its reply
+**                      into pxmsg. xhdr.uireserved carries the request id
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_channel_request(void *pvchannel, x_ipc_msg_t *pxmsg)
+{
+	return ipc_channel_request_blob(pvchannel, pxmsg, NULL, NULL);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_channel_request_blob
+**   Description      : API to send a request with a blob on a channel and
+**                      read its reply and the reply's blob
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_channel_request_blob(void *pvchannel, x_ipc_msg_t *pxmsg,
+		x_ipc_blob *pxblob, x_ipc_blob *pxreplyblob)
+{
+	x_ipc_channel *pxchannel = pvchannel;
+	int32_t iret, ireused, ipassfd = -1, ireplyfd;
+	struct pollfd xpfd;
+	uint32_t uireq;
+
+	if (pxreplyblob != NULL) {
+		pxreplyblob->ifd = -1;
+		pxreplyblob->isize = 0;
+		pxreplyblob->pvdata = NULL;
+	}
+	if (pxchannel == NULL || pxmsg->xhdr.unmsgsize > IPC_MAX_MSG_SIZE)
+		return IPC_FAIL;
+
+	uireq = IPC_CHANNEL_FLAG | (pxchannel->uinextid++ & IPC_CHANNEL_ID_MASK);
+	if (pxblob != NULL && pxblob->ifd >= 0) {
+		uireq |= IPC_BLOB_FLAG;
+		ipassfd = pxblob->ifd;
+	}
+	if (pxchannel->ifd >= 0) {
+		/* No reply is due on an idle connection, anything to read is
+		   the listener having closed it (restart, or an older listener
+		   closing after each reply) */
+		xpfd.fd = pxchannel->ifd;
+		xpfd.events = POLLIN;
+		xpfd.revents = 0;
+		if (poll(&xpfd, 1, 0) != 0) {
+			close(pxchannel->ifd);
+			pxchannel->ifd = -1;
+		}
+	}
+	while (1) {
+		ireused = (pxchannel->ifd >= 0);
+		if (!ireused && (pxchannel->ifd = ipc_connect(pxchannel->acto, &pxchannel->itransport)) < 0)
+			return IPC_FAIL;
+		pxmsg->xhdr.uireserved = uireq;
+		if (ipc_write_msg(pxchannel->ifd, pxmsg, ipassfd) != IPC_SUCCESS) {
+			iret = errno;
+			close(pxchannel->ifd);
+			pxchannel->ifd = -1;
+			/* The whole request never reached the listener, it is safe to
+			   send it again when a kept connection was closed since */
+			if (ireused && (iret == EPIPE || iret == ECONNRESET))
+				continue;
+			LOGF_LOG_DEBUG("IPC request to %s failed\n", pxchannel->acto);
+			return IPC_FAIL;
+		}
+		/* Once sent, the request may have run: it is never sent twice */
+		if ((iret = ipc_read_msg(pxchannel->ifd, pxchannel->itransport, pxmsg, &ireplyfd)) > 0)
+			break;
+		close(pxchannel->ifd);
+		pxchannel->ifd = -1;
+		LOGF_LOG_DEBUG("IPC request to %s got no reply\n", pxchannel->acto);
+		return IPC_FAIL;
+	}
+
+	if ((pxmsg->xhdr.uireserved & IPC_CHANNEL_FLAG) == 0) {
+		/* The listener did not keep the connection */
+		close(pxchannel->ifd);
+		pxchannel->ifd = -1;
+	} else if ((pxmsg->xhdr.uireserved & IPC_CHANNEL_ID_MASK) != (uireq & IPC_CHANNEL_ID_MASK)) {
+		LOGF_LOG_ERROR("IPC reply %u to request %u from %s\n",
+				pxmsg->xhdr.uireserved & IPC_CHANNEL_ID_MASK,
+				uireq & IPC_CHANNEL_ID_MASK, pxchannel->acto);
+		close(pxchannel->ifd);
+		pxchannel->ifd = -1;
+		if (ireplyfd >= 0)
+			close(ireplyfd);
+		return IPC_FAIL;
+	}
+	if (ireplyfd < 0)
+		return IPC_SUCCESS;
+	if (pxreplyblob == NULL || (pxmsg->xhdr.uireserved & IPC_BLOB_FLAG) == 0) {
+		close(ireplyfd);
+		return IPC_SUCCESS;
+	}
+	return ipc_blob_map(pxreplyblob, ireplyfd);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_channel_close
+**   Description      : API to close a channel
+**   Return Value     : None
+** ===========================================================================*/
+
+void
+ipc_channel_close(void *pvchannel)
+{
+	x_ipc_channel *pxchannel = pvchannel;
+
+	if (pxchannel == NULL)
+		return;
+	if (pxchannel->ifd >= 0)
+		close(pxchannel->ifd);
+	free(pxchannel);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_unbusy
+**   Description      : Ends a section calling completions, frees the client
+**                      if one of them closed it
+**   Return Value     : IPC_SUCCESS, IPC_FAIL when the client was freed
+** ===========================================================================*/
+
+static int32_t
+ipc_async_unbusy(x_ipc_async *pxasync)
+{
+	if (--pxasync->ibusy > 0 || !pxasync->iclosed)
+		return IPC_SUCCESS;
+	free(pxasync->pctx);
+	free(pxasync);
+	return IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_fail
+**   Description      : Closes the connection of an async client and fails
+**                      its pending requests
+**   Return Value     : None
+** ===========================================================================*/
+
+static void
+ipc_async_fail(x_ipc_async *pxasync)
+{
+	x_ipc_async_req *pxreq, *pxlist;
+
+	if (pxasync->ifd >= 0)
+		close(pxasync->ifd);
+	pxasync->ifd = -1;
+	pxasync->itxlen = 0;
+	pxasync->irxlen = 0;
+	pxasync->uigen++;
+	/* Taken off first, a completion may submit again */
+	pxlist = pxasync->pxhead;
+	pxasync->pxhead = NULL;
+	pxasync->pxtail = NULL;
+	pxasync->inpending = 0;
+	pxasync->ibusy++;
+	while ((pxreq = pxlist) != NULL) {
+		pxlist = pxreq->pxnext;
+		if (pxreq->pfncb != NULL)
+			pxreq->pfncb(pxreq->uiid, IPC_FAIL, NULL, pxreq->pvarg);
+		free(pxreq);
+	}
+	ipc_async_unbusy(pxasync);
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_flush
+**   Description      : Sends the queued requests as far as the socket takes
+**                      them, one record per request on SOCK_SEQPACKET
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+static int32_t
+ipc_async_flush(x_ipc_async *pxasync)
+{
+	const x_ipc_msghdr_t *pxhdr;
+	ssize_t nbytes;
+	size_t idone = 0, ilen;
+
+	while (idone < pxasync->itxlen) {
+		ilen = pxasync->itxlen - idone;
+		/* A record per message on SOCK_SEQPACKET */
+		if (pxasync->itransport == IPC_TRANSPORT_SEQPACKET) {
+			pxhdr = (const x_ipc_msghdr_t *)(pxasync->pctx + idone);
+			ilen = IPC_HDR_SIZE + pxhdr->unmsgsize;
+		}
+		nbytes = send(pxasync->ifd, pxasync->pctx + idone, ilen,
+				MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			return IPC_FAIL;
+		}
+		idone += nbytes;
+	}
+	pxasync->itxlen -= idone;
+	if (pxasync->itxlen > 0 && idone > 0)
+		memmove(pxasync->pctx, pxasync->pctx + idone, pxasync->itxlen);
+	return IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_open
+**   Description      : API to create an async client of a listener
+**   Return Value     : Success -> client
+**                      Failure -> NULL
+** ===========================================================================*/
+
+void*
+ipc_async_open(char *pucto)
+{
+	x_ipc_async *pxasync;
+
+	pxasync = calloc(1, sizeof(x_ipc_async));
+	if (pxasync == NULL) {
+		LOGF_LOG_DEBUG("memory allocation failed for async client\n");
+		return NULL;
+	}
+	if (strncpy_s(pxasync->acto, MAX_MODID_LEN, pucto, MAX_MODID_LEN - 1) != EOK) {
+		LOGF_LOG_DEBUG("listener name too long\n");
+		free(pxasync);
+		return NULL;
+	}
+	pxasync->ifd = -1;
+	pxasync->uinextid = 1;
+	return pxasync;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_submit
+**   Description      : API to queue a request, sent at once if the socket
+**                      takes it
+**   Return Value     : Success -> IPC_SUCCESS, ticket in *puiticket
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_async_submit(void *pvasync, x_ipc_msg_t *pxmsg, pfn_ipc_completion pfncb,
+		void *pvarg, uint32_t *puiticket)
+{
+	x_ipc_async *pxasync = pvasync;
+	x_ipc_async_req *pxreq;
+	size_t ilen;
+	char *pcbuf;
+
+	if (pxasync == NULL || pxasync->iclosed || pxmsg->xhdr.unmsgsize > IPC_MAX_MSG_SIZE)
+		return IPC_FAIL;
+	if (pxasync->ifd < 0) {
+		pxasync->ifd = ipc_connect(pxasync->acto, &pxasync->itransport);
+		if (pxasync->ifd < 0)
+			return IPC_FAIL;
+		if (fcntl(pxasync->ifd, F_SETFL, O_NONBLOCK) < 0) {
+			ipc_async_fail(pxasync);
+			return IPC_FAIL;
+		}
+	}
+
+	ilen = IPC_HDR_SIZE + pxmsg->xhdr.unmsgsize;
+	if (pxasync->itxlen + ilen > pxasync->itxsize) {
+		pcbuf = realloc(pxasync->pctx, pxasync->itxlen + ilen);
+		if (pcbuf == NULL)
+			return IPC_FAIL;
+		pxasync->pctx = pcbuf;
+		pxasync->itxsize = pxasync->itxlen + ilen;
+	}
+	pxreq = calloc(1, sizeof(x_ipc_async_req));
+	if (pxreq == NULL)
+		return IPC_FAIL;
+	pxreq->uiid = pxasync->uinextid++ & IPC_CHANNEL_ID_MASK;
+	pxreq->pfncb = pfncb;
+	pxreq->pvarg = pvarg;
+
+	pxmsg->xhdr.uireserved = IPC_CHANNEL_FLAG | pxreq->uiid;
+	memcpy(pxasync->pctx + pxasync->itxlen, pxmsg, ilen);
+	pxasync->itxlen += ilen;
+	if (pxasync->pxtail != NULL)
+		pxasync->pxtail->pxnext = pxreq;
+	else
+		pxasync->pxhead = pxreq;
+	pxasync->pxtail = pxreq;
+	pxasync->inpending++;
+	if (puiticket != NULL)
+		*puiticket = pxreq->uiid;
+
+	/* Sent now unless requests are already waiting for the socket */
+	if (pxasync->itxlen == ilen && ipc_async_flush(pxasync) != IPC_SUCCESS) {
+		/* The pending requests, this one included, complete as failed
+		   in the next ipc_async_dispatch */
+		pxasync->itxlen = 0;
+		shutdown(pxasync->ifd, SHUT_WR);
+	}
+	return IPC_SUCCESS;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_cancel
+**   Description      : API to drop the completion of a request
+**   Return Value     : Success -> IPC_SUCCESS
+**                      Failure -> IPC_FAIL
+** ===========================================================================*/
+
+int32_t
+ipc_async_cancel(void *pvasync, uint32_t uiticket)
+{
+	x_ipc_async *pxasync = pvasync;
+	x_ipc_async_req *pxreq;
+
+	if (pxasync == NULL)
+		return IPC_FAIL;
+	for (pxreq = pxasync->pxhead; pxreq != NULL; pxreq = pxreq->pxnext) {
+		if (pxreq->uiid == uiticket && pxreq->pfncb != NULL) {
+			pxreq->pfncb = NULL;
+			return IPC_SUCCESS;
+		}
+	}
+	return IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_fd
+**   Description      : API to get the connection of an async client
+**   Return Value     : fd, -1 if not connected
+** ===========================================================================*/
+
+int32_t
+ipc_async_fd(void *pvasync)
+{
+	x_ipc_async *pxasync = pvasync;
+
+	return (pxasync != NULL) ? pxasync->ifd : -1;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_events
+**   Description      : API to get the poll events an async client waits for
+**   Return Value     : poll events, 0 if nothing is pending
+** ===========================================================================*/
+
+int16_t
+ipc_async_events(void *pvasync)
+{
+	x_ipc_async *pxasync = pvasync;
+	int16_t nevents = 0;
+
+	if (pxasync == NULL || pxasync->ifd < 0)
+		return 0;
+	if (pxasync->inpending > 0)
+		nevents |= POLLIN;
+	if (pxasync->itxlen > 0)
+		nevents |= POLLOUT;
+	return nevents;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_dispatch
+**   Description      : API to send queued requests and call the completions
+**                      of the replies received, does not block
+**   Return Value     : Success -> number of completions called
+**                      Failure -> IPC_FAIL, the pending requests failed
+** ===========================================================================*/
+
+int32_t
+ipc_async_dispatch(void *pvasync)
+{
+	x_ipc_async *pxasync = pvasync;
+	x_ipc_async_req *pxreq, *pxprev;
+	const x_ipc_msghdr_t *pxhdr;
+	size_t ioff, ilen;
+	ssize_t nbytes;
+	int32_t ndone = 0;
+	uint32_t uigen;
+
+	if (pxasync == NULL)
+		return IPC_FAIL;
+	/* Not from a completion, the outer call is walking the replies */
+	if (pxasync->ifd < 0 || pxasync->ibusy > 0)
+		return 0;
+	pxasync->ibusy++;
+	if (pxasync->itxlen > 0 && ipc_async_flush(pxasync) != IPC_SUCCESS)
+		goto returnHandler;
+
+	while (pxasync->inpending > 0) {
+		nbytes = read(pxasync->ifd, pxasync->acrx + pxasync->irxlen,
+				sizeof(pxasync->acrx) - pxasync->irxlen);
+		if (nbytes < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+			goto returnHandler;
+		}
+		if (nbytes == 0)
+			goto returnHandler;
+		pxasync->irxlen += nbytes;
+
+		ioff = 0;
+		while (pxasync->irxlen - ioff >= IPC_HDR_SIZE) {
+			pxhdr = (const x_ipc_msghdr_t *)(pxasync->acrx + ioff);
+			if (pxhdr->unmsgsize > IPC_MAX_MSG_SIZE)
+				goto returnHandler;
+			ilen = IPC_HDR_SIZE + pxhdr->unmsgsize;
+			if (pxasync->irxlen - ioff < ilen)
+				break;
+			memcpy(&pxasync->xreply, pxasync->acrx + ioff, ilen);
+			ioff += ilen;
+
+			/* Normally the oldest request */
+			for (pxprev = NULL, pxreq = pxasync->pxhead; pxreq != NULL;
+					pxprev = pxreq, pxreq = pxreq->pxnext) {
+				if (pxreq->uiid == (pxasync->xreply.xhdr.uireserved & IPC_CHANNEL_ID_MASK))
+					break;
+			}
+			if (pxreq == NULL) {
+				LOGF_LOG_DEBUG("IPC reply %u from %s matches no request\n",
+						pxasync->xreply.xhdr.uireserved & IPC_CHANNEL_ID_MASK, pxasync->acto);
+				continue;
+			}
+			if (pxprev != NULL)
+				pxprev->pxnext = pxreq->pxnext;
+			else
+				pxasync->pxhead = pxreq->pxnext;
+			if (pxasync->pxtail == pxreq)
+				pxasync->pxtail = pxprev;
+			pxasync->inpending--;
+			if (pxreq->pfncb != NULL) {
+				uigen = pxasync->uigen;
+				pxreq->pfncb(pxreq->uiid, IPC_SUCCESS, &pxasync->xreply, pxreq->pvarg);
+				ndone++;
+				if (pxasync->uigen != uigen) {
+					/* The completion closed the client or its
+					   connection, the buffered replies are gone */
+					free(pxreq);
+					ipc_async_unbusy(pxasync);
+					return ndone;
+				}
+			}
+			free(pxreq);
+		}
+		pxasync->irxlen -= ioff;
+		/* A record holds whole messages */
+		if (pxasync->irxlen > 0 && pxasync->itransport == IPC_TRANSPORT_SEQPACKET)
+			goto returnHandler;
+		if (pxasync->irxlen > 0 && ioff > 0)
+			memmove(pxasync->acrx, pxasync->acrx + ioff, pxasync->irxlen);
+	}
+	ipc_async_unbusy(pxasync);
+	return ndone;
+
+returnHandler:
+	LOGF_LOG_DEBUG("IPC connection to %s lost\n", pxasync->acto);
+	ipc_async_fail(pxasync);
+	ipc_async_unbusy(pxasync);
+	return IPC_FAIL;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_pending
+**   Description      : API to get the number of requests not completed
+**   Return Value     : number of requests
+** ===========================================================================*/
+
+int32_t
+ipc_async_pending(void *pvasync)
+{
+	x_ipc_async *pxasync = pvasync;
+
+	return (pxasync != NULL) ? pxasync->inpending : 0;
+}
+
+/*
+** =============================================================================
+**   Function Name    : ipc_async_close
+**   Description      : API to close an async client
+**   Return Value     : None
+** ===========================================================================*/
+
+void
+ipc_async_close(void *pvasync)
+{
+	x_ipc_async *pxasync = pvasync;
+
+	/* Again from a completion of the close below */
+	if (pxasync == NULL || pxasync->iclosed)
+		return;
+	/* From a completion the client is freed once the outer call is done */
+	pxasync->iclosed = 1;
+	pxasync->ibusy++;
+	ipc_async_fail(pxasync);
+	ipc_async_unbusy(pxasync);
+}
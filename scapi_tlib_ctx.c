@@ -0,0 +1,224 @@
+/******************************************************************************
+ **  SRC_FILE			: scapi_tlib_ctx.c
+ **   DESCRIPTION		: Timer contexts: independent timer sets, each with
+ **				  its own timing wheel and timerfd, owned by one
+ **				  thread and used without any lock
+ **   COPYRIGHT			:
+ Copyright (C) 2026 MaxLinear, Inc.
+ *****************************************************************************/
+#include <time.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "scapi_basic_types.h"
+#include "scapi_tlib_timlib.h"
+#include "scapi_tlib_wheel.h"
+
+struct x_UGW_TLIB_TimerCtx {
+	x_UGW_TLIB_Wheel xWheel;
+	int32 iTimerFd;
+	uint64 ullArmedTick;	/* tick the timerfd is set for, 0 if disarmed */
+};
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_CtxRearm
+ *  Function: This routine sets the timerfd to the next tick the wheel has
+ work at, as an absolute CLOCK_MONOTONIC time, unless it is already set as
+ early
+ *  Input: pxCtx
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_CtxRearm(x_UGW_TLIB_TimerCtx *pxCtx)
+{
+	struct itimerspec xVal = {{0, 0}, {0, 0}};
+	uint64 ullNext = UGW_TLIB_WheelNextTick(&pxCtx->xWheel);
+
+	if(ullNext == pxCtx->ullArmedTick ||
+			(ullNext != 0 && pxCtx->ullArmedTick != 0 && pxCtx->ullArmedTick < ullNext))
+	{
+		return;
+	}
+	if(ullNext != 0)
+	{
+		xVal.it_value.tv_sec = ullNext / 1000;
+		xVal.it_value.tv_nsec = (ullNext % 1000) * 1000000;
+	}
+	/* a due time in the past makes the descriptor readable at once */
+	timerfd_settime(pxCtx->iTimerFd, TFD_TIMER_ABSTIME, &xVal, NULL);
+	pxCtx->ullArmedTick = ullNext;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_CtxCreate
+ *  Function: This routine creates a timer context of unNumOfTimers timers
+ *  Input: unNumOfTimers
+ *  Output: None
+ *  Return Value: context, NULL on failure.
+ ******************************************************************************/
+x_UGW_TLIB_TimerCtx *UGW_TLIB_CtxCreate(uint32 unNumOfTimers)
+{
+	x_UGW_TLIB_TimerCtx *pxCtx;
+
+	if((pxCtx = calloc(1, sizeof(x_UGW_TLIB_TimerCtx))) == NULL)
+	{
+		return NULL;
+	}
+	if(UGW_TLIB_WheelInit(&pxCtx->xWheel, unNumOfTimers) != UGW_TLIB_SUCCESS)
+	{
+		free(pxCtx);
+		return NULL;
+	}
+	if((pxCtx->iTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0)
+	{
+		UGW_TLIB_WheelFree(&pxCtx->xWheel);
+		free(pxCtx);
+		return NULL;
+	}
+	return pxCtx;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_CtxDestroy
+ *  Function: This routine frees a context, its running timers are dropped
+ *  Input: pxCtx
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+void UGW_TLIB_CtxDestroy(x_UGW_TLIB_TimerCtx *pxCtx)
+{
+	if(pxCtx == NULL)
+	{
+		return;
+	}
+	close(pxCtx->iTimerFd);
+	UGW_TLIB_WheelFree(&pxCtx->xWheel);
+	free(pxCtx);
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_CtxStartTimer64
+ *  Function: This routine starts a timer of the context, which may expire up
+ to uiSlack us late to share a wakeup with other timers
+ *  Input: pxCtx, ullTimerValue(us), uiSlack(us), ucTimerType,
+ pfn_UGW_TLIB_CallBackfn, pCallBackFnParm
+ *  Output: punTimerId
+ *  Return Value: success or fail.
+ ******************************************************************************/
+int8 UGW_TLIB_CtxStartTimer64(x_UGW_TLIB_TimerCtx *pxCtx, uint32 *punTimerId,
+		uint64 ullTimerValue, uint32 uiSlack, uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm)
+{
+	uint32 unId;
+
+	if(pxCtx == NULL || punTimerId == NULL || ullTimerValue == 0 ||
+			ullTimerValue > UGW_TLIB_MAX_TIMER_VALUE)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	if((unId = UGW_TLIB_WheelStart(&pxCtx->xWheel, ullTimerValue, uiSlack, ucTimerType,
+					pfn_UGW_TLIB_CallBackfn, pCallBackFnParm)) == 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	UGW_TLIB_CtxRearm(pxCtx);
+	*punTimerId = unId;
+	return UGW_TLIB_SUCCESS;
+}
+
+int8 UGW_TLIB_CtxStartTimerSlack(x_UGW_TLIB_TimerCtx *pxCtx, uint32 *punTimerId,
+		uint32 uiTimerValue, uint32 uiSlack, uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm)
+{
+	return UGW_TLIB_CtxStartTimer64(pxCtx, punTimerId, uiTimerValue, uiSlack,
+			ucTimerType, pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+}
+
+int8 UGW_TLIB_CtxStartTimer(x_UGW_TLIB_TimerCtx *pxCtx, uint32 *punTimerId,
+		uint32 uiTimerValue, uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm)
+{
+	return UGW_TLIB_CtxStartTimerSlack(pxCtx, punTimerId, uiTimerValue, UGW_TLIB_SLACK_DEFAULT,
+			ucTimerType, pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+}
+
+/* Slack of the timers started without one, 0 by default */
+void UGW_TLIB_CtxSetSlack(x_UGW_TLIB_TimerCtx *pxCtx, uint32 uiSlack)
+{
+	if(pxCtx != NULL)
+	{
+		pxCtx->xWheel.uiDefaultSlack = uiSlack;
+	}
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_CtxStopTimer
+ *  Function: This routine stops a timer of the context. The timerfd is left
+ armed, the wakeup finds nothing to do
+ *  Input: pxCtx, unTimerId
+ *  Output: None
+ *  Return Value: as UGW_TLIB_StopTimer: time left in us, success if it was
+ due, fail if it is not running, invalid timer id.
+ ******************************************************************************/
+int32 UGW_TLIB_CtxStopTimer(x_UGW_TLIB_TimerCtx *pxCtx, uint32 unTimerId)
+{
+	int64 llTimeLeft;
+
+	if(pxCtx == NULL || unTimerId == 0 || unTimerId > pxCtx->xWheel.unMaxNodes)
+	{
+		return UGW_TLIB_INVALID_TIMER_ID;
+	}
+	if((llTimeLeft = UGW_TLIB_WheelStop(&pxCtx->xWheel, unTimerId)) < 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	if(llTimeLeft > 0x7FFFFFFF)
+	{
+		llTimeLeft = 0x7FFFFFFF;
+	}
+	return (llTimeLeft == 0) ? UGW_TLIB_SUCCESS : (int32)llTimeLeft;
+}
+
+int32 UGW_TLIB_CtxGetFd(const x_UGW_TLIB_TimerCtx *pxCtx)
+{
+	return (pxCtx != NULL) ? pxCtx->iTimerFd : -1;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_CtxDispatch
+ *  Function: This routine runs the callbacks of all the due timers of the
+ context and re-arms its timerfd. Callbacks may start and stop timers of the
+ same context
+ *  Input: pxCtx
+ *  Output: None
+ *  Return Value: number of callbacks run, -1 on failure.
+ ******************************************************************************/
+int32 UGW_TLIB_CtxDispatch(x_UGW_TLIB_TimerCtx *pxCtx)
+{
+	pfnVoidFunctPtr pfnCallBack;
+	void *pvCallBackParm;
+	uint64 ullExpirations;
+	int32 iFired = 0;
+
+	if(pxCtx == NULL)
+	{
+		return -1;
+	}
+	if(read(pxCtx->iTimerFd, &ullExpirations, sizeof(ullExpirations)) < 0 && errno != EAGAIN)
+	{
+		return -1;
+	}
+	pxCtx->ullArmedTick = 0;
+	UGW_TLIB_WheelAdvance(&pxCtx->xWheel, UGW_TLIB_WheelTime());
+	while(UGW_TLIB_WheelPopExpired(&pxCtx->xWheel, &pfnCallBack, &pvCallBackParm) == UGW_TLIB_SUCCESS)
+	{
+		if(pfnCallBack != NULL)
+		{
+			pfnCallBack(pvCallBackParm);
+		}
+		iFired++;
+	}
+	UGW_TLIB_CtxRearm(pxCtx);
+	return iFired;
+}
@@ -34,9 +34,12 @@ Author: EasyPort Team
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sys/ioctl.h>		/* ioctl */
+#include <sys/timerfd.h>
+#include <errno.h>
 #include <fcntl.h>
 #include "scapi_basic_types.h"
 #include "scapi_tlib_timlib.h"
+#include "scapi_tlib_wheel.h"
 #include "ltq_api_include.h"
 #ifdef DMALLOC
 #include<dmalloc.h>
@@ -48,8 +51,27 @@ Author: EasyPort Team
 pthread_mutex_t global_timer_mutex = PTHREAD_MUTEX_INITIALIZER;
 uchar8 vucTimerNotifyType;
 uint32 vuiTimerLibFd;  				
+static int32 viTimerFd = -1;
+x_UGW_TLIB_TimerInfo *pxTimerList;
+struct x_UGW_TLIB_TimMgtInfo vx_UGW_TLIB_TimMgtInfo;
+uchar8 vucTimerBackend = UGW_TLIB_BACKEND_LIST;
+static x_UGW_TLIB_Wheel vxTimerWheel;
+static uint32 vuiTimerSlack;
+static uint64 vullWheelArmedTick;
+
+/* 64 bit value and deadline of a list timer, kept out of the public
+   x_UGW_TLIB_TimerInfo so that its layout stays. Indexed like pxTimerList */
+typedef struct {
+	uint64 ullTimerValue;	/* timer value in us */
+	uint64 ullDeadline;	/* absolute expiry, UGW_TLIB_GetMonoTimeNs() */
+} x_UGW_TLIB_TimerTime;
+
+static x_UGW_TLIB_TimerTime *vpxTimerTime;
+#define UGW_TLIB_NODE_TIME(pxNode) \
+	(vpxTimerTime + ((pxNode) - vx_UGW_TLIB_TimMgtInfo.pxTimerList))
 uint32 UGW_TLIB_ConvertTicksToTime(uint32 uiTicks);
 uint32 UGW_TLIB_ConvertTimeToTicks(uint32 uiTime);
+static void UGW_TLIB_ListInsert(x_UGW_TLIB_TimerInfo *pxTempNode);
 
 static void UGW_TLIB_PrintTimerList(void)
 {
@@ -68,6 +90,140 @@ static void UGW_TLIB_PrintTimerList(void)
 	printf("----------------------------------------------------\n");
 
 }
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelLock
+ *  Function: This routine takes global_timer_mutex for the wheel backend. In
+ signal mode SIGALRM is blocked first, so the expiry handler cannot run on a
+ thread already holding the mutex
+ *  Input: None
+ *  Output: pxOldMask
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_WheelLock(sigset_t *pxOldMask)
+{
+	sigset_t xMask;
+
+	if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){
+		sigemptyset(&xMask);
+		sigaddset(&xMask, SIGALRM);
+		pthread_sigmask(SIG_BLOCK, &xMask, pxOldMask);
+	}
+	pthread_mutex_lock(&global_timer_mutex);
+}
+
+static void UGW_TLIB_WheelUnlock(const sigset_t *pxOldMask)
+{
+	pthread_mutex_unlock(&global_timer_mutex);
+	if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){
+		pthread_sigmask(SIG_SETMASK, pxOldMask, NULL);
+	}
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelRearm
+ *  Function: This routine arms the timer for the next tick the wheel has work
+ at, unless it is already armed as early. Called with the mutex held
+ *  Input: None
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_WheelRearm(void)
+{
+	uint64 ullNext = UGW_TLIB_WheelNextTick(&vxTimerWheel);
+	uint64 ullNow, ullUsec;
+
+	if(ullNext == 0 || (vullWheelArmedTick != 0 && vullWheelArmedTick <= ullNext))
+	{
+		return;
+	}
+	ullNow = UGW_TLIB_WheelTime();
+	ullUsec = (ullNext > ullNow) ? (ullNext - ullNow) * 1000 : 1000;
+	if(ullUsec > 0xFFFFFFFFULL)
+	{
+		ullUsec = 0xFFFFFFFFULL;
+	}
+	vullWheelArmedTick = ullNext;
+	UGW_TLIB_SetTimer((uint32)ullUsec);
+}
+
+static int8 UGW_TLIB_WheelStartTimer(uint16 *punTimerId, uint64 ullTimerValue,
+		uint32 uiSlack, uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
+		void *pCallBackFnParm)
+{
+	sigset_t xOldMask;
+	uint32 unId;
+
+	UGW_TLIB_WheelLock(&xOldMask);
+	unId = UGW_TLIB_WheelStart(&vxTimerWheel, ullTimerValue, uiSlack, ucTimerType,
+			pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+	if(unId != 0)
+	{
+		UGW_TLIB_WheelRearm();
+	}
+	UGW_TLIB_WheelUnlock(&xOldMask);
+	if(unId == 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	*punTimerId = (uint16)unId;
+	return UGW_TLIB_SUCCESS;
+}
+
+/* A stopped timer leaves the timer armed, the wakeup finds nothing to do */
+static int32 UGW_TLIB_WheelStopTimer(uint16 unTimerId)
+{
+	sigset_t xOldMask;
+	int64 llTimeLeft;
+
+	if((unTimerId == 0) || (unTimerId > vxTimerWheel.unMaxNodes))
+	{
+		return UGW_TLIB_INVALID_TIMER_ID;
+	}
+	UGW_TLIB_WheelLock(&xOldMask);
+	llTimeLeft = UGW_TLIB_WheelStop(&vxTimerWheel, unTimerId);
+	UGW_TLIB_WheelUnlock(&xOldMask);
+	if(llTimeLeft < 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	if(llTimeLeft > 0x7FFFFFFF)
+	{
+		llTimeLeft = 0x7FFFFFFF;
+	}
+	return (llTimeLeft == 0) ? UGW_TLIB_SUCCESS : (int32)llTimeLeft;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelExpiry
+ *  Function: This routine runs the callbacks of all the expired timers of the
+ wheel, without the mutex held so they may start and stop timers, and arms
+ the timer for the next one
+ *  Input: None
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_WheelExpiry(void)
+{
+	pfnVoidFunctPtr pfnCallBack;
+	void *pvCallBackParm;
+	sigset_t xOldMask;
+
+	UGW_TLIB_WheelLock(&xOldMask);
+	vullWheelArmedTick = 0;
+	UGW_TLIB_WheelAdvance(&vxTimerWheel, UGW_TLIB_WheelTime());
+	while(UGW_TLIB_WheelPopExpired(&vxTimerWheel, &pfnCallBack, &pvCallBackParm) == UGW_TLIB_SUCCESS)
+	{
+		UGW_TLIB_WheelUnlock(&xOldMask);
+		if(pfnCallBack != NULL)
+		{
+			pfnCallBack(pvCallBackParm);
+		}
+		UGW_TLIB_WheelLock(&xOldMask);
+	}
+	UGW_TLIB_WheelRearm();
+	UGW_TLIB_WheelUnlock(&xOldMask);
+}
+
 /*****************************************************************************
  *  Name: UGW_TLIB_TimerInit
  *  Function: This routine is initializes timer data structure
@@ -77,6 +233,30 @@ static void UGW_TLIB_PrintTimerList(void)
  ******************************************************************************/						
 int8 UGW_TLIB_TimersInit(uint16 unNumOfTimers, uchar8 ucTimerNotifyType)
 {
+	return UGW_TLIB_TimersInitEx(unNumOfTimers, ucTimerNotifyType, UGW_TLIB_BACKEND_LIST);
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_TimersInitEx
+ *  Function: This routine is initializes timer data structure of the
+ selected backend
+ *  Input: unNumOfTimers, ucTimerNotifyType, ucBackend
+ *  Output: None
+ *  Return Value: INT16 returns success or fail. Fails when the timers are
+ already initialised, UGW_TLIB_TimersDelete must be called first
+ ******************************************************************************/						
+int8 UGW_TLIB_TimersInitEx(uint16 unNumOfTimers, uchar8 ucTimerNotifyType, uchar8 ucBackend)
+{
+	if(ucBackend != UGW_TLIB_BACKEND_LIST && ucBackend != UGW_TLIB_BACKEND_WHEEL)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	/* A second init would drop the running timers and leak their nodes */
+	if(vxTimerWheel.pxNodes != NULL || vx_UGW_TLIB_TimMgtInfo.pxTimerList != NULL)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	vucTimerBackend = ucBackend;
 	vucTimerNotifyType = ucTimerNotifyType;
 	int32 iflag,nChildRet;
 	if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){
@@ -101,12 +281,33 @@ int8 UGW_TLIB_TimersInit(uint16 unNumOfTimers, uchar8 ucTimerNotifyType)
 		}
 		vuiTimerLibFd = iflag;
 	}
+	else if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_TIMERFD)
+	{
+		if(viTimerFd < 0 &&
+				(viTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0)
+		{
+			printf("TimerInit Failed ErrCd = %d\n",errno);
+			return UGW_TLIB_FAIL;
+		}
+	}
+
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		vullWheelArmedTick = 0;
+		if(UGW_TLIB_WheelInit(&vxTimerWheel, unNumOfTimers) != UGW_TLIB_SUCCESS)
+		{
+			return UGW_TLIB_FAIL;
+		}
+		vxTimerWheel.uiDefaultSlack = vuiTimerSlack;
+		return UGW_TLIB_SUCCESS;
+	}
 
 	vx_UGW_TLIB_TimMgtInfo.unMaxNumOfTimer = unNumOfTimers;
 
 	/* Allocate memory for the Timer node data structure,
 	   here the number of timer nodes = Num of timers  */
-	if((vx_UGW_TLIB_TimMgtInfo.pxTimerList =
+	vpxTimerTime = calloc(unNumOfTimers, sizeof(x_UGW_TLIB_TimerTime));
+	if(vpxTimerTime != NULL && (vx_UGW_TLIB_TimMgtInfo.pxTimerList =
 				(x_UGW_TLIB_TimerInfo *)calloc(1,unNumOfTimers * 
 					(sizeof(x_UGW_TLIB_TimerInfo)))) != NULL)
 	{
@@ -120,6 +321,8 @@ int8 UGW_TLIB_TimersInit(uint16 unNumOfTimers, uchar8 ucTimerNotifyType)
 	}
 	else
 	{
+		free(vpxTimerTime);
+		vpxTimerTime = NULL;
 		return UGW_TLIB_FAIL;
 	}
 }
@@ -171,14 +374,34 @@ void UGW_TLIB_InitializeTimerList(uint16 unNumOfTimers)
 int8 UGW_TLIB_StartTimer(uint16 *punTimerId,uint32 uiTimerValue,
 		uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
 		void *pCallBackFnParm)
+{
+	return UGW_TLIB_StartTimer64(punTimerId, uiTimerValue, ucTimerType,
+			pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+}
+
+/******************************************************************************
+ *  Name: UGW_TLIB_StartTimer64
+ *  Function: This routine starts the timer, for up to UGW_TLIB_MAX_TIMER_VALUE us
+ *  Input: ullTimerValue,ucTimerType, pfn_UGW_TLIB_CallBackfn, pCallBackFnParm
+ *  Output: punTimerId
+ *  Return Value: success or fail.
+ ******************************************************************************/
+int8 UGW_TLIB_StartTimer64(uint16 *punTimerId,uint64 ullTimerValue,
+		uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
+		void *pCallBackFnParm)
 {
 	x_UGW_TLIB_TimerInfo *pxTempNode = NULL;
 	int nCnt=0;
 
-	if(uiTimerValue == 0)
+	if(ullTimerValue == 0 || ullTimerValue > UGW_TLIB_MAX_TIMER_VALUE)
 	{
 		return UGW_TLIB_FAIL;
 	}
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		return UGW_TLIB_WheelStartTimer(punTimerId, ullTimerValue, UGW_TLIB_SLACK_DEFAULT,
+				ucTimerType, pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+	}
 	if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){	
 retry_lck:
 		if (pthread_mutex_lock(&global_timer_mutex) != 0 ) { 
@@ -199,8 +422,11 @@ retry_lck:
 		*punTimerId = pxTempNode->unTimerIndex;
 
 		/* Insert new node in an appropriate position in active list */
-		UGW_TLIB_InsertTimerIntoActList(pxTempNode,uiTimerValue,ucTimerType,
-				pfn_UGW_TLIB_CallBackfn,pCallBackFnParm);
+		UGW_TLIB_InitializeTimerNode(pxTempNode,
+				(ullTimerValue > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32)ullTimerValue,
+				ucTimerType,pfn_UGW_TLIB_CallBackfn,pCallBackFnParm);
+		UGW_TLIB_NODE_TIME(pxTempNode)->ullTimerValue = ullTimerValue;
+		UGW_TLIB_ListInsert(pxTempNode);
 
 		nCnt=0;
 		if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){	
@@ -236,155 +462,156 @@ retry_unlk_1:
 	}
 }
 
-/*****************************************************************************
- *  Name: UGW_TLIB_InsertTimerIntoActList
- *  Function: This routine inserts the timer into active list of timers
- *  Input: pxTempNode,uiTimerValue,ucTimerType, pfn_UGW_TLIB_CallBackfn,
- pCallBackFnParm
- *  Output:None
+/******************************************************************************
+ *  Name: UGW_TLIB_StartTimerSlack
+ *  Function: This routine starts a timer which may expire up to uiSlack us
+ late, so that it shares a wakeup with other timers. Only the wheel backend
+ keeps a per timer slack, the list backend uses the global one
+ *  Input: uiTimerValue, uiSlack, ucTimerType, pfn_UGW_TLIB_CallBackfn, pCallBackFnParm
+ *  Output: punTimerId
  *  Return Value: success or fail.
  ******************************************************************************/
-
-void UGW_TLIB_InsertTimerIntoActList(x_UGW_TLIB_TimerInfo *pxTempNode,
-		uint32 uiTimerValue,uint8 ucTimerType,
-		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm)
-
+int8 UGW_TLIB_StartTimerSlack(uint16 *punTimerId, uint32 uiTimerValue, uint32 uiSlack,
+		uint8 ucTimerType, pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn,
+		void *pCallBackFnParm)
 {
+	if(uiTimerValue == 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		return UGW_TLIB_WheelStartTimer(punTimerId, uiTimerValue, uiSlack,
+				ucTimerType, pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+	}
+	return UGW_TLIB_StartTimer(punTimerId, uiTimerValue, ucTimerType,
+			pfn_UGW_TLIB_CallBackfn, pCallBackFnParm);
+}
 
-	x_UGW_TLIB_TimerInfo *pxTempNextNode,*pxTempActLstNode;
-	uint32 uiTimeElapse,uiTempTimeElapse,uiTimeLeft,uiNextTimeLeft,uiCurrTick;
+/******************************************************************************
+ *  Name: UGW_TLIB_SetTimerSlack
+ *  Function: This routine sets the slack of the timers started afterwards.
+ Both backends delay an expiry by up to uiSlack us to line it up with
+ others, a timer never runs before its deadline: the wheel files it later
+ within its slack, the list arms uiSlack us after the head deadline and then
+ runs every timer that is due. 0, the default, runs each at its deadline
+ *  Input: uiSlack
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+void UGW_TLIB_SetTimerSlack(uint32 uiSlack)
+{
+	sigset_t xOldMask;
 
-	/* Initialize the new timer node */	
-	UGW_TLIB_InitializeTimerNode(pxTempNode,uiTimerValue,ucTimerType,
-			pfn_UGW_TLIB_CallBackfn,pCallBackFnParm);
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		UGW_TLIB_WheelLock(&xOldMask);
+		vuiTimerSlack = uiSlack;
+		vxTimerWheel.uiDefaultSlack = uiSlack;
+		UGW_TLIB_WheelUnlock(&xOldMask);
+		return;
+	}
+	vuiTimerSlack = uiSlack;
+}
 
-	/* CLOCKT_CurrTick is number of milliseconds expired since
-	   system is started */
-	uiCurrTick = UGW_TLIB_GetCurrTime();
+/*****************************************************************************
+ *  Name: UGW_TLIB_ListArm
+ *  Function: This routine arms the timer for the head of the active list, up
+ to the slack late so that the timers due meanwhile share the wakeup, or
+ stops it when the list is empty
+ *  Input: ullNow, current UGW_TLIB_GetMonoTimeNs()
+ *  Output:None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_ListArm(uint64 ullNow)
+{
+	x_UGW_TLIB_TimerInfo *pxHead;
+	uint64 ullUsec = 1, ullDue;
 
-	/* The active list is empty */
 	if(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex == 0)
 	{
-		printf("Active List Empty\n");
-		vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = pxTempNode->unTimerIndex;
-		pxTempActLstNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-			(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);		
-
-		pxTempActLstNode->uiTimerTick = uiCurrTick;
-		pxTempActLstNode->unPrevIndex = 0;
-		pxTempActLstNode->unNextIndex = 0;
-		printf("Timer started for %d ms\n",uiTimerValue/1000);
-		/*Start the Timer */
-		UGW_TLIB_SetTimer(uiTimerValue);
-
+		UGW_TLIB_SetTimer(0);
+		return;
 	}
-	else
+	pxHead = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
+		(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);
+	ullDue = UGW_TLIB_NODE_TIME(pxHead)->ullDeadline + (uint64)vuiTimerSlack * 1000;
+	/* already due: the shortest value, 0 would stop the timer */
+	if(ullDue > ullNow)
 	{
-		printf("Active list not empty\n");
-		pxTempActLstNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-			(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);		
+		ullUsec = (ullDue - ullNow + 999) / 1000;
+	}
+	UGW_TLIB_SetTimer((ullUsec > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32)ullUsec);
+}
 
-		uiTimeElapse = UGW_TLIB_ConvertTicksToTime((uiCurrTick - pxTempActLstNode->uiTimerTick));
+/*****************************************************************************
+ *  Name: UGW_TLIB_ListInsert
+ *  Function: This routine sets the absolute deadline of an initialized node
+ from its 64 bit timer value and links it before the first active timer due later,
+ comparing deadlines only. The timer is re-armed when the node becomes head
+ *  Input: pxTempNode
+ *  Output:None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_ListInsert(x_UGW_TLIB_TimerInfo *pxTempNode)
+{
+	x_UGW_TLIB_TimerInfo *pxPrevNode = NULL, *pxNextNode;
+	x_UGW_TLIB_TimerTime *pxTime = UGW_TLIB_NODE_TIME(pxTempNode);
+	uint64 ullNow = UGW_TLIB_GetMonoTimeNs();
+	uint16 unNextIndex = vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex;
 
-		/* Check whether timer in an active list is already elapsed or not */
-		if(pxTempActLstNode->uiTimerValue > uiTimeElapse)
-		{
-			uiTimeLeft = pxTempActLstNode->uiTimerValue - uiTimeElapse;
-		}
-		else
-		{
-			uiTimeLeft = 0;
-		}
-		printf("Time Left with old timer is %d us\n",uiTimeLeft);
-		/*Insert timer at the beginning of active list */
-		if(uiTimerValue < uiTimeLeft)
+	pxTime->ullDeadline = ullNow + pxTime->ullTimerValue * 1000;
+	pxTempNode->uiTimerTick = UGW_TLIB_GetCurrTime();
+
+	/* Timers with the same deadline expire in start order */
+	while(unNextIndex != 0)
+	{
+		pxNextNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList + (unNextIndex - 1);
+		if(UGW_TLIB_NODE_TIME(pxNextNode)->ullDeadline > pxTime->ullDeadline)
 		{
-			printf("New timer value is less than time left\n");		
-			/* Store the Timer tick at creation of timer node */
-			pxTempNode->uiTimerTick = uiCurrTick;
-			/*adjust the prev index * next index for 1st and 2nd nodes */
-			pxTempNode->unPrevIndex = 0;
-			pxTempNode->unNextIndex = pxTempActLstNode->unTimerIndex;
-			pxTempActLstNode->unPrevIndex = pxTempNode->unTimerIndex;
-			/* Time elapse for the 2nd node = Time Elapse for 2nd node +
-			   Timervalue of 1st node */
-			pxTempActLstNode = pxTempNode;
-			/* The active timer list header points to first node */
-
-			vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex =
-				pxTempActLstNode->unTimerIndex;
-
-			printf("Timer started for %d ms\n",uiTimerValue/1000);
-			UGW_TLIB_SetTimer(uiTimerValue);
+			break;
 		}
-		else
-		{
-			printf("Inserted the new timer in b/w\n");
-			/*Traverse the Active list of timers to insert the list in
-			  an appropriate position */
-			while(pxTempActLstNode != NULL)
-			{
-
-				/* Add at the end of list */
-				if(pxTempActLstNode->unNextIndex == 0)
-				{
+		pxPrevNode = pxNextNode;
+		unNextIndex = pxNextNode->unNextIndex;
+	}
 
-					/* Store the Timer tick at creation of timer node */
-					pxTempNode->uiTimerTick = uiCurrTick;
+	pxTempNode->unNextIndex = unNextIndex;
+	if(unNextIndex != 0)
+	{
+		vx_UGW_TLIB_TimMgtInfo.pxTimerList[unNextIndex - 1].unPrevIndex = pxTempNode->unTimerIndex;
+	}
+	if(pxPrevNode != NULL)
+	{
+		pxTempNode->unPrevIndex = pxPrevNode->unTimerIndex;
+		pxPrevNode->unNextIndex = pxTempNode->unTimerIndex;
+	}
+	else
+	{
+		pxTempNode->unPrevIndex = 0;
+		vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = pxTempNode->unTimerIndex;
+		UGW_TLIB_ListArm(ullNow);
+	}
+}
 
-					pxTempActLstNode->unNextIndex = pxTempNode->unTimerIndex;
-					pxTempNode->unPrevIndex = pxTempActLstNode->unTimerIndex;
-					pxTempNode->unNextIndex = 0;
+/*****************************************************************************
+ *  Name: UGW_TLIB_InsertTimerIntoActList
+ *  Function: This routine inserts the timer into active list of timers
+ *  Input: pxTempNode,uiTimerValue,ucTimerType, pfn_UGW_TLIB_CallBackfn,
+ pCallBackFnParm
+ *  Output:None
+ *  Return Value: success or fail.
+ ******************************************************************************/
 
-					break;
-				}
-				else
-				{
-
-					pxTempNextNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-						(pxTempActLstNode->unNextIndex - 1);
-					uiTempTimeElapse = UGW_TLIB_ConvertTicksToTime(
-							(uiCurrTick - pxTempNextNode->uiTimerTick));
-
-					/* Check whether next timer in an active list
-					   is already elapsed or not*/
-					if(pxTempNextNode->uiTimerValue > uiTempTimeElapse)
-					{
-						uiNextTimeLeft = pxTempNextNode->uiTimerValue - uiTempTimeElapse;
-					}
-					else
-					{
-						uiNextTimeLeft = 0;
-					}
-
-					/*Insert timer at the Middle of active list */
-					if((uiTimerValue >= uiTimeLeft) && (uiTimerValue < uiNextTimeLeft))
-					{
-
-						/* Store the Timer tick at creation of timer node */
-						pxTempNode->uiTimerTick = uiCurrTick;
-
-						pxTempActLstNode->unNextIndex = pxTempNode->unTimerIndex;
-						pxTempNode->unPrevIndex = pxTempActLstNode->unTimerIndex;
-						pxTempNode->unNextIndex = pxTempNextNode->unTimerIndex;
-						pxTempNextNode->unPrevIndex = pxTempNode->unTimerIndex;
-						break;
-
-					}
-					/*Traverse to next node in an active list */
-					else
-					{
-						/* Go to next node */
-						pxTempActLstNode=pxTempNextNode;
-						/* Time elapse and time left of next node becomes current node */
-						uiTimeElapse = uiTempTimeElapse;
-						uiTimeLeft = uiNextTimeLeft;
-					}
-				}
-			}
-		}
+void UGW_TLIB_InsertTimerIntoActList(x_UGW_TLIB_TimerInfo *pxTempNode,
+		uint32 uiTimerValue,uint8 ucTimerType,
+		pfnVoidFunctPtr pfn_UGW_TLIB_CallBackfn, void *pCallBackFnParm)
 
-	}
+{
+	/* Initialize the new timer node */	
+	UGW_TLIB_InitializeTimerNode(pxTempNode,uiTimerValue,ucTimerType,
+			pfn_UGW_TLIB_CallBackfn,pCallBackFnParm);
+	UGW_TLIB_NODE_TIME(pxTempNode)->ullTimerValue = uiTimerValue;
+	UGW_TLIB_ListInsert(pxTempNode);
 }
 
 /****************************************************************************
@@ -466,10 +693,14 @@ void UGW_TLIB_InitializeTimerNode(x_UGW_TLIB_TimerInfo *pxTimerNode,
 int32 UGW_TLIB_StopTimer(uint16 unTimerId)
 {
 	x_UGW_TLIB_TimerInfo *pxTempNode,*pxPrevTempNode,*pxNextTempNode;
-	clock_t CLOCKT_CurrTick;
-	uint32 uiTimeLeft;
+	uint64 ullNow, ullTimeLeft;
 	int nCnt=0;
 
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		return UGW_TLIB_WheelStopTimer(unTimerId);
+	}
+
 	/* Check for valid timer id */ 	
 	if((unTimerId <= 0) || (unTimerId > vx_UGW_TLIB_TimMgtInfo.unMaxNumOfTimer))
 	{
@@ -498,68 +729,36 @@ retry_lck:
 	if(pxTempNode->ucFree == FALSE)
 	{
 
-		CLOCKT_CurrTick = UGW_TLIB_GetCurrTime();
+		ullNow = UGW_TLIB_GetMonoTimeNs();
 		/*Return Time left */
-		uiTimeLeft = UGW_TLIB_ConvertTicksToTime((CLOCKT_CurrTick - pxTempNode->uiTimerTick));
-		if(uiTimeLeft > pxTempNode->uiTimerValue)
+		ullTimeLeft = (UGW_TLIB_NODE_TIME(pxTempNode)->ullDeadline > ullNow) ?
+			(UGW_TLIB_NODE_TIME(pxTempNode)->ullDeadline - ullNow) / 1000 : 0;
+		if(ullTimeLeft > 0x7FFFFFFF)
 		{
-			uiTimeLeft = 0;
-		}
-		else
-		{
-			uiTimeLeft = pxTempNode->uiTimerValue - uiTimeLeft;
+			ullTimeLeft = 0x7FFFFFFF;
 		}
 
-		/*Delete the node from beginning of active list */
+		/* Unlink the node from the active list */
 		if(pxTempNode->unPrevIndex == 0)
 		{
-			/*Only one node in the active timer list */
-			if(pxTempNode->unNextIndex == 0)
-			{
-				vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = 0;
-				printf("In Stop timer, timer called with 0 value\n");
-				/*Stop the timer */
-				UGW_TLIB_SetTimer(0);
-			}
-			/* Delete from the beginning of a list */
-			else
-			{
-
-				vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = pxTempNode->unNextIndex;
-				pxNextTempNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-					(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);
-
-				pxNextTempNode->unPrevIndex = 0;
-				CLOCKT_CurrTick = UGW_TLIB_ConvertTicksToTime((CLOCKT_CurrTick-pxNextTempNode->uiTimerTick));
-				if((int)pxNextTempNode->uiTimerValue > CLOCKT_CurrTick)
-				{
-					printf("In Stop timer, next timer is %d ms\n",(pxNextTempNode->uiTimerValue -CLOCKT_CurrTick)/1000);
-					UGW_TLIB_SetTimer(pxNextTempNode->uiTimerValue -CLOCKT_CurrTick);
-				}
-			}
-
+			vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = pxTempNode->unNextIndex;
 		}
 		else
 		{
 			pxPrevTempNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
 				(pxTempNode->unPrevIndex - 1);
-
-			/* Delete the node from end of list */
-			if(pxTempNode->unNextIndex == 0)
-			{
-				pxPrevTempNode->unNextIndex = 0;
-			}
-			/* Delete from the middle of a list */
-			else
-
-			{
-				pxNextTempNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-					(pxTempNode->unNextIndex - 1);
-				pxPrevTempNode->unNextIndex = pxNextTempNode->unTimerIndex;
-				pxNextTempNode->unPrevIndex = pxPrevTempNode->unTimerIndex;
-
-			}
-
+			pxPrevTempNode->unNextIndex = pxTempNode->unNextIndex;
+		}
+		if(pxTempNode->unNextIndex != 0)
+		{
+			pxNextTempNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
+				(pxTempNode->unNextIndex - 1);
+			pxNextTempNode->unPrevIndex = pxTempNode->unPrevIndex;
+		}
+		/* The head changed, arm for the new one */
+		if(pxTempNode->unPrevIndex == 0)
+		{
+			UGW_TLIB_ListArm(ullNow);
 		}
 
 
@@ -578,10 +777,10 @@ retry_unlck:
 				}
 			}
 		}
-		if(uiTimeLeft == 0){
+		if(ullTimeLeft == 0){
 			return UGW_TLIB_SUCCESS;
 		}else{
-			return uiTimeLeft;
+			return (int32)ullTimeLeft;
 		}
 	}      
 	else
@@ -652,13 +851,13 @@ uint32 UGW_TLIB_ConvertTicksToTime(uint32 uiTicks){
 
 void UGW_TLIB_CurrTimerExpiry( __attribute__((unused)) int signo)
 {
-	x_UGW_TLIB_TimerInfo *pxTempNode,*pxTempActTimLstHead;
-	uint32 uiGetCurrTime;
 	int nCnt=0;
-	//clock_t CLOCKT_TimeDiff;
 
-	/* Get the current timer tick */
-	uiGetCurrTime = UGW_TLIB_GetCurrTime();
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		UGW_TLIB_WheelExpiry();
+		return;
+	}
 
 	if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){	
 retry_lck:
@@ -673,49 +872,8 @@ retry_lck:
 		}
 	}
 
-	if(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex != 0)
-	{
-
-		pxTempActTimLstHead = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-			(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);
-		if(vucTimerNotifyType != UGW_TLIB_NOTIFY_VIA_SIGNAL){
-			printf("Timer ID that got fired is %d\n",pxTempActTimLstHead->unTimerIndex);
-			printf(" The Current Time is %u	 and in the list is %u\n",
-					uiGetCurrTime,pxTempActTimLstHead->uiTimerTick);
-		}
-
-		pxTempNode = pxTempActTimLstHead;
-
-		if(pxTempNode->unNextIndex == 0)
-		{
-			vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = 0;
-
-			/* Noitfy timer expiry to the corresponding process */
-			pxTempNode->pfn_UGW_TLIB_CallBackfn(pxTempNode->pCallBackFnParm);
-
-			/* if the timer is periodic then restart it */	
-			if(pxTempNode->ucTimerType == UGW_TLIB_PERIODIC_TIMER)
-			{
-				uiGetCurrTime = UGW_TLIB_GetCurrTime();
-				pxTempNode->uiTimerTick = uiGetCurrTime;
-				UGW_TLIB_InsertTimerIntoActList(pxTempNode,pxTempNode->uiTimerValue,
-						pxTempNode->ucTimerType, pxTempNode->pfn_UGW_TLIB_CallBackfn,
-						pxTempNode->pCallBackFnParm);
-			}
-			else
-			{
-
-				/* Free the timer from active list and add it to
-				   free list of timers */
-				UGW_TLIB_FreeListHandler(pxTempNode);
-			}
-		}
-		else
-		{
-			UGW_TLIB_CheckForEqualTimer(uiGetCurrTime);
-
-		}
-	}
+	/* Run every timer that is due and arm for the next one */
+	UGW_TLIB_CheckForEqualTimer(UGW_TLIB_GetCurrTime());
 	nCnt=0;
 	if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_SIGNAL){	
 retry_unlck:
@@ -746,6 +904,8 @@ void UGW_TLIB_FreeListHandler(x_UGW_TLIB_TimerInfo *pxTempNode)
 	pxTempNode->ucFree = TRUE;
 	pxTempNode->uiTimerValue = 0;
 	pxTempNode->uiTimerTick = 0;
+	UGW_TLIB_NODE_TIME(pxTempNode)->ullTimerValue = 0;
+	UGW_TLIB_NODE_TIME(pxTempNode)->ullDeadline = 0;
 	pxTempNode->ucTimerType = 0;
 	pxTempNode->pfn_UGW_TLIB_CallBackfn = NULL;
 	pxTempNode->pCallBackFnParm = NULL;
@@ -801,6 +961,13 @@ void UGW_TLIB_SetTimer(uint32 uiUsec)
 		setitimer(ITIMER_REAL, &nval, &oval);
 
 		sigprocmask(SIG_SETMASK,&oldmask,NULL);
+	}else if(vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_TIMERFD){
+		struct itimerspec xVal = {{0, 0}, {0, 0}};
+
+		/* a zero value disarms */
+		xVal.it_value.tv_sec = uiUsec / 1000000;
+		xVal.it_value.tv_nsec = (uiUsec % 1000000) * 1000;
+		timerfd_settime(viTimerFd, 0, &xVal, NULL);
 	}else{
 		ioctl(vuiTimerLibFd,TIMER_DRV_MODE_CHANGE,(uiUsec/1000));//converting into msec
 	}
@@ -814,7 +981,62 @@ void UGW_TLIB_SetTimer(uint32 uiUsec)
  *****************************************************************************/
 int8 UGW_TLIB_TimersDelete(void)
 {
-	free(vx_UGW_TLIB_TimMgtInfo.pxTimerList);
+	if(vucTimerBackend == UGW_TLIB_BACKEND_WHEEL)
+	{
+		UGW_TLIB_SetTimer(0);
+		UGW_TLIB_WheelFree(&vxTimerWheel);
+	}
+	else
+	{
+		free(vx_UGW_TLIB_TimMgtInfo.pxTimerList);
+		vx_UGW_TLIB_TimMgtInfo.pxTimerList = NULL;
+		free(vpxTimerTime);
+		vpxTimerTime = NULL;
+	}
+	if(viTimerFd >= 0)
+	{
+		close(viTimerFd);
+		viTimerFd = -1;
+	}
+	return UGW_TLIB_SUCCESS;
+}
+
+/****************************************************************************
+ *  Name: UGW_TLIB_GetTimerFd
+ *  Function: This function returns the timerfd of UGW_TLIB_NOTIFY_VIA_TIMERFD
+ mode, to be polled for POLLIN by the application
+ *  Input : None
+ *  Output:None
+ *  Return Value: descriptor, -1 in the other modes
+ ******************************************************************************/
+int32 UGW_TLIB_GetTimerFd(void)
+{
+	return (vucTimerNotifyType == UGW_TLIB_NOTIFY_VIA_TIMERFD) ? viTimerFd : -1;
+}
+
+/****************************************************************************
+ *  Name: UGW_TLIB_Dispatch
+ *  Function: This function consumes the timerfd expiration count and runs
+ the callbacks of every timer that is due, in one batch, from the caller's
+ thread. The timerfd is re-armed for the next timer
+ *  Input : None
+ *  Output:None
+ *  Return Value: success or fail.
+ ******************************************************************************/
+int8 UGW_TLIB_Dispatch(void)
+{
+	uint64 ullExpirations;
+
+	if(vucTimerNotifyType != UGW_TLIB_NOTIFY_VIA_TIMERFD || viTimerFd < 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	/* EAGAIN: not expired, only the timers already due are run */
+	if(read(viTimerFd, &ullExpirations, sizeof(ullExpirations)) < 0 && errno != EAGAIN)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	UGW_TLIB_CurrTimerExpiry(0);
 	return UGW_TLIB_SUCCESS;
 }
 
@@ -832,119 +1054,76 @@ uint32 UGW_TLIB_GetCurrTime(void)
 	return ((uint32)CLOCKT_Time);
 }
 
+/****************************************************************************
+ *  Name: UGW_TLIB_GetMonoTimeNs
+ *  Function: This function is the time base of the timers: CLOCK_MONOTONIC
+ in nanoseconds, not affected by clock changes, 64 bit so it does not wrap
+ *  Input : None
+ *  Output:None
+ *  Return Value: Current time in ns
+ ******************************************************************************/
+uint64 UGW_TLIB_GetMonoTimeNs(void)
+{
+	struct timespec xNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	return (uint64)xNow.tv_sec * 1000000000ULL + (uint64)xNow.tv_nsec;
+}
+
 /*****************************************************************************
  *  Name: UGW_TLIB_CheckForEqualTimer
- *  Function: This function gets the current tick since system has been started
- *  Input : uiCurrTime
+ *  Function: This function runs the head timers of the active list while
+ they are due, then arms for the next one. Nothing runs before its deadline,
+ the slack only delays the wakeup (see UGW_TLIB_ListArm)
+ *  Input : uiCurrTime, unused: the deadlines are absolute
  *  Output:None
  *  Return Value: success or fail.
  ******************************************************************************/
-int8 UGW_TLIB_CheckForEqualTimer(uint32 uiCurrTime)
+int8 UGW_TLIB_CheckForEqualTimer(__attribute__((unused)) uint32 uiCurrTime)
 {
-	x_UGW_TLIB_TimerInfo *pxTempNode,*pxTempActTimLstHead;
-	uint32 uiCurrTimerValue,uiTimeDelay;	
+	x_UGW_TLIB_TimerInfo *pxTempNode;
+	pfnVoidFunctPtr pfnCallBack;
+	void *pCallBackFnParm;
+	uint64 ullNow = UGW_TLIB_GetMonoTimeNs();
 
-	pxTempNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
-		(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);
-	printf("In Check for equal timers\n");
-	while(pxTempNode->unNextIndex != 0)
+	while(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex != 0)
 	{
-
-		/* Noitfy timer expiry to the corresponding process */
-		pxTempNode->pfn_UGW_TLIB_CallBackfn(pxTempNode->pCallBackFnParm);
-		/* Get the current timer tick - Without this you will face issue, if callback 
-		   function takes some time in execution */	
-		uiCurrTime = UGW_TLIB_GetCurrTime();
-
-		vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = pxTempNode->unNextIndex;
-		pxTempActTimLstHead = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
+		pxTempNode = vx_UGW_TLIB_TimMgtInfo.pxTimerList +
 			(vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex - 1);
-		pxTempActTimLstHead->unPrevIndex = 0;
-
-
-		/*Calculate Time elapsed for the next node */
-		uiTimeDelay = UGW_TLIB_ConvertTicksToTime((uiCurrTime - pxTempActTimLstHead->uiTimerTick));
-
-		/*Check next timer also been elapsed */
-		if(pxTempActTimLstHead->uiTimerValue > uiTimeDelay)
+		if(UGW_TLIB_NODE_TIME(pxTempNode)->ullDeadline > ullNow)
 		{
-			uiCurrTimerValue = pxTempActTimLstHead->uiTimerValue - uiTimeDelay ;
-		}
-		else
-		{
-			uiCurrTimerValue = 0;
+			break;
 		}
 
-		/* Checking for threshold of 1ms */
-		if (uiCurrTimerValue > 1000) 
+		/* Take the head off the active list */
+		vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = pxTempNode->unNextIndex;
+		if(pxTempNode->unNextIndex != 0)
 		{
-
-			UGW_TLIB_SetTimer(uiCurrTimerValue);
-			printf("CET - new timer started with %d ms\n",uiCurrTimerValue/1000);
-			/* if the timer is periodic then restart it */			
-			if(pxTempNode->ucTimerType == UGW_TLIB_PERIODIC_TIMER)
-			{
-				uiCurrTime = UGW_TLIB_GetCurrTime();
-				pxTempNode->uiTimerTick = uiCurrTime;
-				UGW_TLIB_InsertTimerIntoActList(pxTempNode,pxTempNode->uiTimerValue,
-						pxTempNode->ucTimerType, pxTempNode->pfn_UGW_TLIB_CallBackfn,
-						pxTempNode->pCallBackFnParm);
-			}
-			/* Free the timer from active list and add it to free list of timers */
-			else
-			{
-
-				UGW_TLIB_FreeListHandler(pxTempNode);
-			}
-
-
-			break;
+			vx_UGW_TLIB_TimMgtInfo.pxTimerList[pxTempNode->unNextIndex - 1].unPrevIndex = 0;
 		}
-		/* The next timer also been elapsed , so release that timer */
+		pfnCallBack = pxTempNode->pfn_UGW_TLIB_CallBackfn;
+		pCallBackFnParm = pxTempNode->pCallBackFnParm;
+
 		/* if the timer is periodic then restart it */
 		if(pxTempNode->ucTimerType == UGW_TLIB_PERIODIC_TIMER)
 		{
-			pxTempNode->uiTimerTick = uiCurrTime;
-			UGW_TLIB_InsertTimerIntoActList(pxTempNode,pxTempNode->uiTimerValue,
-					pxTempNode->ucTimerType, pxTempNode->pfn_UGW_TLIB_CallBackfn,
-					pxTempNode->pCallBackFnParm);
+			UGW_TLIB_ListInsert(pxTempNode);
 		}
 		/* Free the timer from active list and add it to free list of timers */
 		else
 		{
-
 			UGW_TLIB_FreeListHandler(pxTempNode);
 		}
 
-		pxTempNode = pxTempActTimLstHead;
-
-		/* The last node in the active list of timer */
-		if(pxTempActTimLstHead->unNextIndex == 0)
+		/* Noitfy timer expiry to the corresponding process */
+		if(pfnCallBack != NULL)
 		{
-			vx_UGW_TLIB_TimMgtInfo.unActTimLstHeadIndex = 0;
-
-			/* Noitfy timer expiry to the corresponding process */
-
-			pxTempNode->pfn_UGW_TLIB_CallBackfn(pxTempNode->pCallBackFnParm);
-			/* if the timer is periodic then restart it */
-			if(pxTempNode->ucTimerType == UGW_TLIB_PERIODIC_TIMER)
-			{
-				pxTempNode->uiTimerTick = uiCurrTime;
-				UGW_TLIB_InsertTimerIntoActList(pxTempNode,pxTempNode->uiTimerValue,
-						pxTempNode->ucTimerType, pxTempNode->pfn_UGW_TLIB_CallBackfn,
-						pxTempNode->pCallBackFnParm);
-			}
-			/* Free the timer from active list and add it to free list of timers */
-			else
-			{
-
-				UGW_TLIB_FreeListHandler(pxTempNode);
-			}
-			break;
+			pfnCallBack(pCallBackFnParm);
 		}
-
+		/* The callback may take some time in execution */
+		ullNow = UGW_TLIB_GetMonoTimeNs();
 	}
-
+	UGW_TLIB_ListArm(ullNow);
 
 	return UGW_TLIB_SUCCESS;
 }
@@ -0,0 +1,426 @@
+/******************************************************************************
+ **  SRC_FILE			: scapi_tlib_wheel.c
+ **   DESCRIPTION		: Hierarchical timing wheel for the UGW_TLIB timers.
+ **				  Level l holds 64 slots of 64^l ticks, a timer is
+ **				  filed by how far away it is and moves down a level
+ **				  each time its slot comes round, so start, stop and
+ **				  expiry do not depend on the number of running timers
+ **   COPYRIGHT			:
+ Copyright (C) 2026 MaxLinear, Inc.
+ *****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "scapi_basic_types.h"
+#include "scapi_tlib_timlib.h"
+#include "scapi_tlib_wheel.h"
+
+#define UGW_TLIB_WHEEL_MASK (UGW_TLIB_WHEEL_SLOTS - 1)
+#define UGW_TLIB_WHEEL_SHIFT(level) ((level) * UGW_TLIB_WHEEL_BITS)
+#define UGW_TLIB_WHEEL_INDEX(tick, level) (((tick) >> UGW_TLIB_WHEEL_SHIFT(level)) & UGW_TLIB_WHEEL_MASK)
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelInit
+ *  Function: This routine allocates the timer nodes and chains them on the
+ free list, in id order
+ *  Input: pxWheel, unMaxNodes
+ *  Output: None
+ *  Return Value: success or fail.
+ ******************************************************************************/
+int8 UGW_TLIB_WheelInit(x_UGW_TLIB_Wheel *pxWheel, uint32 unMaxNodes)
+{
+	uint32 unIi;
+
+	memset(pxWheel, 0, sizeof(*pxWheel));
+	if(unMaxNodes == 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	if((pxWheel->pxNodes = calloc(unMaxNodes, sizeof(x_UGW_TLIB_WheelNode))) == NULL)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	for(unIi = 1; unIi <= unMaxNodes; unIi++)
+	{
+		pxWheel->pxNodes[unIi - 1].ucFree = TRUE;
+		pxWheel->pxNodes[unIi - 1].unSlot = UGW_TLIB_WHEEL_NO_SLOT;
+		pxWheel->pxNodes[unIi - 1].unNext = (unIi == unMaxNodes) ? 0 : unIi + 1;
+	}
+	pxWheel->unMaxNodes = unMaxNodes;
+	pxWheel->unFreeHead = 1;
+	pxWheel->unFreeTail = unMaxNodes;
+	pxWheel->ullNow = UGW_TLIB_WheelTime();
+	return UGW_TLIB_SUCCESS;
+}
+
+void UGW_TLIB_WheelFree(x_UGW_TLIB_Wheel *pxWheel)
+{
+	free(pxWheel->pxNodes);
+	memset(pxWheel, 0, sizeof(*pxWheel));
+}
+
+uint64 UGW_TLIB_WheelTime(void)
+{
+	return UGW_TLIB_GetMonoTimeNs() / 1000000;
+}
+
+static void UGW_TLIB_WheelLink(x_UGW_TLIB_Wheel *pxWheel, uint32 unId, uint16 unSlot)
+{
+	x_UGW_TLIB_WheelNode *pxNode = pxWheel->pxNodes + (unId - 1);
+
+	pxNode->unSlot = unSlot;
+	pxNode->unPrev = 0;
+	pxNode->unNext = pxWheel->aunSlotHead[unSlot];
+	if(pxNode->unNext != 0)
+	{
+		pxWheel->pxNodes[pxNode->unNext - 1].unPrev = unId;
+	}
+	pxWheel->aunSlotHead[unSlot] = unId;
+	if(unSlot < UGW_TLIB_WHEEL_EXPIRED)
+	{
+		pxWheel->aullBitmap[unSlot / UGW_TLIB_WHEEL_SLOTS] |= 1ULL << (unSlot % UGW_TLIB_WHEEL_SLOTS);
+	}
+}
+
+static void UGW_TLIB_WheelUnlink(x_UGW_TLIB_Wheel *pxWheel, uint32 unId)
+{
+	x_UGW_TLIB_WheelNode *pxNode = pxWheel->pxNodes + (unId - 1);
+	uint16 unSlot = pxNode->unSlot;
+
+	if(pxNode->unPrev != 0)
+	{
+		pxWheel->pxNodes[pxNode->unPrev - 1].unNext = pxNode->unNext;
+	}
+	else
+	{
+		pxWheel->aunSlotHead[unSlot] = pxNode->unNext;
+	}
+	if(pxNode->unNext != 0)
+	{
+		pxWheel->pxNodes[pxNode->unNext - 1].unPrev = pxNode->unPrev;
+	}
+	if(unSlot < UGW_TLIB_WHEEL_EXPIRED && pxWheel->aunSlotHead[unSlot] == 0)
+	{
+		pxWheel->aullBitmap[unSlot / UGW_TLIB_WHEEL_SLOTS] &= ~(1ULL << (unSlot % UGW_TLIB_WHEEL_SLOTS));
+	}
+	pxNode->unSlot = UGW_TLIB_WHEEL_NO_SLOT;
+	pxNode->unPrev = pxNode->unNext = 0;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelFile
+ *  Function: This routine puts a running timer in the slot of the lowest
+ level whose range reaches its expiry. A timer due now goes to the expired list
+ *  Input: pxWheel, unId
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_WheelFile(x_UGW_TLIB_Wheel *pxWheel, uint32 unId)
+{
+	uint64 ullExpiry = pxWheel->pxNodes[unId - 1].ullExpiry;
+	uint32 unLevel;
+
+	if(ullExpiry <= pxWheel->ullNow)
+	{
+		UGW_TLIB_WheelLink(pxWheel, unId, UGW_TLIB_WHEEL_EXPIRED);
+		return;
+	}
+	for(unLevel = 0; unLevel < UGW_TLIB_WHEEL_LEVELS; unLevel++)
+	{
+		/* the slot must come round before the current one does again */
+		if((ullExpiry >> UGW_TLIB_WHEEL_SHIFT(unLevel)) -
+				(pxWheel->ullNow >> UGW_TLIB_WHEEL_SHIFT(unLevel)) < UGW_TLIB_WHEEL_SLOTS)
+		{
+			UGW_TLIB_WheelLink(pxWheel, unId, unLevel * UGW_TLIB_WHEEL_SLOTS +
+					UGW_TLIB_WHEEL_INDEX(ullExpiry, unLevel));
+			return;
+		}
+	}
+	/* Beyond the wheel: park in the farthest slot, it is re-filed from there */
+	unLevel = UGW_TLIB_WHEEL_LEVELS - 1;
+	UGW_TLIB_WheelLink(pxWheel, unId, unLevel * UGW_TLIB_WHEEL_SLOTS +
+			((UGW_TLIB_WHEEL_INDEX(pxWheel->ullNow, unLevel) + UGW_TLIB_WHEEL_MASK) & UGW_TLIB_WHEEL_MASK));
+}
+
+static uint64 UGW_TLIB_WheelTicks(uint64 ullTimerValue)
+{
+	uint64 ullTicks = (ullTimerValue + 999) / 1000;
+
+	return ullTicks ? ullTicks : 1;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelApplySlack
+ *  Function: This routine picks the filed expiry of a timer: the tick in
+ [deadline, deadline + slack] with the most low order zero bits. Timers with
+ close deadlines and enough slack land on the same tick, and are run by the
+ same wakeup
+ *  Input: pxNode
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+static void UGW_TLIB_WheelApplySlack(x_UGW_TLIB_WheelNode *pxNode)
+{
+	uint64 ullLimit = pxNode->ullDeadline + pxNode->uiSlack / 1000;
+	uint64 ullMask;
+
+	if(ullLimit == pxNode->ullDeadline)
+	{
+		pxNode->ullExpiry = pxNode->ullDeadline;
+		return;
+	}
+	/* clear the limit below the highest bit it differs from the deadline in */
+	ullMask = (1ULL << (63 - __builtin_clzll(pxNode->ullDeadline ^ ullLimit))) - 1;
+	pxNode->ullExpiry = ullLimit & ~ullMask;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelStart
+ *  Function: This routine takes a node from the free list and files it
+ *  Input: pxWheel, ullTimerValue, uiSlack, ucTimerType, pfnCallBack, pvCallBackParm
+ *  Output: None
+ *  Return Value: timer id, 0 on failure.
+ ******************************************************************************/
+uint32 UGW_TLIB_WheelStart(x_UGW_TLIB_Wheel *pxWheel, uint64 ullTimerValue, uint32 uiSlack,
+		uint8 ucTimerType, void (*pfnCallBack)(void *), void *pvCallBackParm)
+{
+	x_UGW_TLIB_WheelNode *pxNode;
+	uint32 unId = pxWheel->unFreeHead;
+
+	if(unId == 0)
+	{
+		return 0;
+	}
+	/* An idle wheel is not advanced, bring it to now before filing */
+	if(pxWheel->unActive == 0)
+	{
+		pxWheel->ullNow = UGW_TLIB_WheelTime();
+	}
+	pxNode = pxWheel->pxNodes + (unId - 1);
+	pxWheel->unFreeHead = pxNode->unNext;
+	if(pxWheel->unFreeHead == 0)
+	{
+		pxWheel->unFreeTail = 0;
+	}
+
+	pxNode->ucFree = FALSE;
+	pxNode->ullTimerValue = ullTimerValue;
+	pxNode->uiSlack = (uiSlack == UGW_TLIB_SLACK_DEFAULT) ? pxWheel->uiDefaultSlack : uiSlack;
+	pxNode->ucTimerType = ucTimerType;
+	pxNode->pfnCallBack = pfnCallBack;
+	pxNode->pvCallBackParm = pvCallBackParm;
+	/* first tick at or after now + ullTimerValue, a timer never fires early */
+	pxNode->ullDeadline = (UGW_TLIB_GetMonoTimeNs() + ullTimerValue * 1000 + 999999) / 1000000;
+	UGW_TLIB_WheelApplySlack(pxNode);
+	UGW_TLIB_WheelFile(pxWheel, unId);
+	pxWheel->unActive++;
+	return unId;
+}
+
+/* Freed ids go to the tail, so a stale id is not reused straight away */
+static void UGW_TLIB_WheelRelease(x_UGW_TLIB_Wheel *pxWheel, uint32 unId)
+{
+	x_UGW_TLIB_WheelNode *pxNode = pxWheel->pxNodes + (unId - 1);
+
+	pxNode->ucFree = TRUE;
+	pxNode->pfnCallBack = NULL;
+	pxNode->pvCallBackParm = NULL;
+	pxNode->unNext = 0;
+	if(pxWheel->unFreeTail != 0)
+	{
+		pxWheel->pxNodes[pxWheel->unFreeTail - 1].unNext = unId;
+	}
+	else
+	{
+		pxWheel->unFreeHead = unId;
+	}
+	pxWheel->unFreeTail = unId;
+	pxWheel->unActive--;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelStop
+ *  Function: This routine unlinks a running timer and frees it
+ *  Input: pxWheel, unTimerId
+ *  Output: None
+ *  Return Value: time left in us, -1 if the timer is not running.
+ ******************************************************************************/
+int64 UGW_TLIB_WheelStop(x_UGW_TLIB_Wheel *pxWheel, uint32 unTimerId)
+{
+	x_UGW_TLIB_WheelNode *pxNode;
+	uint64 ullNow;
+
+	if(unTimerId == 0 || unTimerId > pxWheel->unMaxNodes)
+	{
+		return -1;
+	}
+	pxNode = pxWheel->pxNodes + (unTimerId - 1);
+	if(pxNode->ucFree == TRUE)
+	{
+		return -1;
+	}
+	ullNow = UGW_TLIB_WheelTime();
+	UGW_TLIB_WheelUnlink(pxWheel, unTimerId);
+	UGW_TLIB_WheelRelease(pxWheel, unTimerId);
+	return (pxNode->ullDeadline > ullNow) ? (int64)(pxNode->ullDeadline - ullNow) * 1000 : 0;
+}
+
+/* Empties a slot, re-filing its timers one level down (or onto the expired list) */
+static void UGW_TLIB_WheelCascade(x_UGW_TLIB_Wheel *pxWheel, uint16 unSlot)
+{
+	uint32 unId;
+
+	while((unId = pxWheel->aunSlotHead[unSlot]) != 0)
+	{
+		UGW_TLIB_WheelUnlink(pxWheel, unId);
+		UGW_TLIB_WheelFile(pxWheel, unId);
+	}
+}
+
+/* Ticks from the current slot of a level to its next non-empty one, 1 to 64 */
+static uint64 UGW_TLIB_WheelSlotDistance(uint64 ullBitmap, uint32 unCurr)
+{
+	uint32 unFrom = (unCurr + 1) & UGW_TLIB_WHEEL_MASK;
+	uint64 ullRotated = unFrom ? (ullBitmap >> unFrom) | (ullBitmap << (UGW_TLIB_WHEEL_SLOTS - unFrom)) : ullBitmap;
+
+	return (uint64)__builtin_ctzll(ullRotated) + 1;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelNextSlotTick
+ *  Function: This routine finds the earliest tick at which a level 0 slot
+ fires or a higher level slot cascades, from the per level bitmaps
+ *  Input: pxWheel
+ *  Output: None
+ *  Return Value: tick, 0 if all the slots are empty.
+ ******************************************************************************/
+static uint64 UGW_TLIB_WheelNextSlotTick(const x_UGW_TLIB_Wheel *pxWheel)
+{
+	uint64 ullBest = 0, ullTick;
+	uint32 unLevel, unShift;
+
+	for(unLevel = 0; unLevel < UGW_TLIB_WHEEL_LEVELS; unLevel++)
+	{
+		if(pxWheel->aullBitmap[unLevel] == 0)
+		{
+			continue;
+		}
+		unShift = UGW_TLIB_WHEEL_SHIFT(unLevel);
+		ullTick = ((pxWheel->ullNow >> unShift) + UGW_TLIB_WheelSlotDistance(pxWheel->aullBitmap[unLevel],
+					UGW_TLIB_WHEEL_INDEX(pxWheel->ullNow, unLevel))) << unShift;
+		if(ullBest == 0 || ullTick < ullBest)
+		{
+			ullBest = ullTick;
+		}
+	}
+	return ullBest;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelAdvance
+ *  Function: This routine moves the wheel up to ullNow. Each tick empties the
+ level 0 slot onto the expired list, and every 64^l ticks a level l slot is
+ re-filed into the levels below. Ticks with nothing to do are skipped, the
+ bitmaps give the next one that has
+ *  Input: pxWheel, ullNow
+ *  Output: None
+ *  Return Value: None
+ ******************************************************************************/
+void UGW_TLIB_WheelAdvance(x_UGW_TLIB_Wheel *pxWheel, uint64 ullNow)
+{
+	uint64 ullNext;
+	uint32 unLevel;
+	uint16 unSlot;
+
+	while(pxWheel->ullNow < ullNow)
+	{
+		/* Nothing happens before the next non-empty slot comes round */
+		ullNext = UGW_TLIB_WheelNextSlotTick(pxWheel);
+		if(ullNext == 0 || ullNext > ullNow)
+		{
+			pxWheel->ullNow = ullNow;
+			break;
+		}
+		pxWheel->ullNow = ullNext;
+
+		/* Find the highest level whose slot boundary this tick is on */
+		for(unLevel = 1; unLevel < UGW_TLIB_WHEEL_LEVELS; unLevel++)
+		{
+			if(UGW_TLIB_WHEEL_INDEX(pxWheel->ullNow, unLevel - 1) != 0)
+			{
+				break;
+			}
+		}
+		while(--unLevel > 0)
+		{
+			UGW_TLIB_WheelCascade(pxWheel, unLevel * UGW_TLIB_WHEEL_SLOTS +
+					UGW_TLIB_WHEEL_INDEX(pxWheel->ullNow, unLevel));
+		}
+
+		unSlot = UGW_TLIB_WHEEL_INDEX(pxWheel->ullNow, 0);
+		while(pxWheel->aunSlotHead[unSlot] != 0)
+		{
+			uint32 unId = pxWheel->aunSlotHead[unSlot];
+
+			UGW_TLIB_WheelUnlink(pxWheel, unId);
+			UGW_TLIB_WheelLink(pxWheel, unId, UGW_TLIB_WHEEL_EXPIRED);
+		}
+	}
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelPopExpired
+ *  Function: This routine takes one timer off the expired list. A periodic
+ timer is re-filed one period after its previous deadline (from now if it
+ fell behind), a one time timer is freed
+ *  Input: pxWheel
+ *  Output: ppfnCallBack, ppvCallBackParm
+ *  Return Value: success or fail.
+ ******************************************************************************/
+int8 UGW_TLIB_WheelPopExpired(x_UGW_TLIB_Wheel *pxWheel, void (**ppfnCallBack)(void *),
+		void **ppvCallBackParm)
+{
+	x_UGW_TLIB_WheelNode *pxNode;
+	uint32 unId = pxWheel->aunSlotHead[UGW_TLIB_WHEEL_EXPIRED];
+
+	if(unId == 0)
+	{
+		return UGW_TLIB_FAIL;
+	}
+	pxNode = pxWheel->pxNodes + (unId - 1);
+	UGW_TLIB_WheelUnlink(pxWheel, unId);
+	*ppfnCallBack = pxNode->pfnCallBack;
+	*ppvCallBackParm = pxNode->pvCallBackParm;
+
+	if(pxNode->ucTimerType == UGW_TLIB_PERIODIC_TIMER)
+	{
+		/* from the deadline, the slack does not accumulate */
+		pxNode->ullDeadline += UGW_TLIB_WheelTicks(pxNode->ullTimerValue);
+		if(pxNode->ullDeadline <= pxWheel->ullNow)
+		{
+			pxNode->ullDeadline = pxWheel->ullNow + UGW_TLIB_WheelTicks(pxNode->ullTimerValue);
+		}
+		UGW_TLIB_WheelApplySlack(pxNode);
+		UGW_TLIB_WheelFile(pxWheel, unId);
+	}
+	else
+	{
+		UGW_TLIB_WheelRelease(pxWheel, unId);
+	}
+	return UGW_TLIB_SUCCESS;
+}
+
+/*****************************************************************************
+ *  Name: UGW_TLIB_WheelNextTick
+ *  Function: This routine tells when the wheel next has work
+ *  Input: pxWheel
+ *  Output: None
+ *  Return Value: tick, ullNow if timers are already expired, 0 if idle.
+ ******************************************************************************/
+uint64 UGW_TLIB_WheelNextTick(const x_UGW_TLIB_Wheel *pxWheel)
+{
+	if(pxWheel->aunSlotHead[UGW_TLIB_WHEEL_EXPIRED] != 0)
+	{
+		return pxWheel->ullNow;
+	}
+	return UGW_TLIB_WheelNextSlotTick(pxWheel);
+}
@@ -28,6 +28,7 @@
 
 #include <ulogging.h>
 #include <ltq_api_include.h>
+#include <scapi_netlink.h>
 
 
 
@@ -53,18 +54,8 @@ int scapi_vlanAdd(char* pcIfName, int nVlan)
 {
 	struct vlan_ioctl_args xIfr = {0};
 
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	xIfr.cmd = ADD_VLAN_CMD;
 	if (sprintf_s(xIfr.device1, IFNAMSIZ, "%s", pcIfName) <= 0) {
 		nRet = -errno;
@@ -74,15 +65,14 @@ int scapi_vlanAdd(char* pcIfName, int nVlan)
 
 	xIfr.u.VID = nVlan;
 
-	if(ioctl(nSkfd, SIOCSIFVLAN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFVLAN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -104,18 +94,8 @@ returnHandler:
 int scapi_vlanDel(char* pcIfName)
 {
 	struct vlan_ioctl_args xIfr = {0};
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	xIfr.cmd = DEL_VLAN_CMD;
 	if (sprintf_s(xIfr.device1, IFNAMSIZ, "%s", pcIfName) <= 0) {
 		nRet = -errno;
@@ -123,15 +103,14 @@ int scapi_vlanDel(char* pcIfName)
 		goto returnHandler;
 	}
 
-	if(ioctl(nSkfd, SIOCSIFVLAN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFVLAN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
+	scapi_ifcCacheInvalidate();
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }       
 
@@ -155,30 +134,18 @@ int scapi_setVlanNameType(char* pcIfName, int nNameType)
 	(void)pcIfName;
 	struct vlan_ioctl_args xIfr = {0};
 
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	xIfr.cmd = SET_VLAN_NAME_TYPE_CMD;
 	xIfr.u.name_type = nNameType;
 
-	if(ioctl(nSkfd, SIOCSIFVLAN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFVLAN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -200,18 +167,8 @@ int scapi_setVlanFlag(char* pcIfName, int nFlag)
 {
 	struct vlan_ioctl_args xIfr = {0};
 
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	if (sprintf_s(xIfr.device1, IFNAMSIZ, "%s", pcIfName) <=0 ) {
 		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = sprintf_s failed\n");
@@ -220,15 +177,13 @@ int scapi_setVlanFlag(char* pcIfName, int nFlag)
 	xIfr.cmd = SET_VLAN_FLAG_CMD;
 	xIfr.u.flag = nFlag; //can be only 0 or 1. or else ioctl fails
 
-	if(ioctl(nSkfd, SIOCSIFVLAN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFVLAN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 
@@ -253,18 +208,8 @@ int scapi_setVlanEgressIngressMap(char* pcIfName, int nPriority, int nVlanQos)
 {
 	struct vlan_ioctl_args xIfr = {0};
 
-	int nSkfd = -1;
 	int nRet = -EXIT_FAILURE;
 
-	nSkfd = socket(AF_INET, SOCK_DGRAM, 0);
-	if(nSkfd < 0)
-	{
-		nRet = -errno;
-		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
-		goto returnHandler;
-	}
-	fcntl(nSkfd, F_SETFD, fcntl(nSkfd, F_GETFD) | FD_CLOEXEC);
-
 	if (sprintf_s(xIfr.device1, IFNAMSIZ, "%s", pcIfName) <= 0) {
 		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = sprintf_s failed\n");
@@ -273,15 +218,13 @@ int scapi_setVlanEgressIngressMap(char* pcIfName, int nPriority, int nVlanQos)
 	xIfr.u.skb_priority = nPriority;
 	xIfr.vlan_qos = nVlanQos; //range [0,7]
 
-	if(ioctl(nSkfd, SIOCSIFVLAN, &xIfr) < 0)
+	if((nRet = scapi_ctrlSockIoctl(SIOCSIFVLAN, &xIfr)) < 0)
 	{
-		nRet = -errno;
 		LOGF_LOG_ERROR("ERROR = %d --> %s\n", nRet, strerror(-nRet));
 		goto returnHandler;
 	}
 	nRet = EXIT_SUCCESS;
 returnHandler:
-	close(nSkfd);
 	return nRet;
 }
 